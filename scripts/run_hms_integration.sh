@@ -184,7 +184,7 @@ if [[ "${HMS_RUN_CPP_HARNESS:-false}" == "true" ]]; then
 		-v "${ROOT_DIR}":/work \
 		-w /work \
 		gcc:13 \
-		bash -lc "g++ -std=c++17 -Isrc/include -Isrc -Isrc/providers -Iduckdb/src/include test/integration/hms/hms_integration_harness.cpp src/providers/hms/hms_connector.cpp src/providers/hms/hms_mapper.cpp -o /tmp/hms_integration_harness && /tmp/hms_integration_harness"
+		bash -lc "g++ -std=c++17 -pthread -Isrc/include -Isrc -Isrc/providers -Iduckdb/src/include test/integration/hms/hms_integration_harness.cpp src/providers/hms/hms_async_client.cpp src/providers/hms/hms_connection_pool.cpp src/providers/hms/hms_connector.cpp src/providers/hms/hms_decode.cpp src/providers/hms/hms_endpoint_set.cpp src/providers/hms/hms_mapper.cpp src/providers/hms/hms_partition_name.cpp src/providers/hms/hms_resolver.cpp src/providers/hms/hms_thrift.cpp src/metastore_caching_connector.cpp src/metastore_compact_table.cpp src/metastore_shared_cache.cpp src/metastore_shared_cache_connector.cpp -o /tmp/hms_integration_harness && /tmp/hms_integration_harness"
 fi
 
 echo "HMS integration checks passed (container reachability + startup logs)"
@@ -1,6 +1,8 @@
 #include "auth/metastore_secret_bridge.hpp"
 #include "duckdb/common/string_util.hpp"
 
+#include <limits>
+
 namespace duckdb {
 
 static std::string GetOptionString(const case_insensitive_map_t<Value> &options, const std::string &key) {
@@ -11,6 +13,109 @@ static std::string GetOptionString(const case_insensitive_map_t<Value> &options,
 	return StringValue::Get(it->second);
 }
 
+static constexpr uint32_t UINT_OPTION_MAX = std::numeric_limits<uint32_t>::max();
+
+//! Reads option `name` as an integer between `min` and `max` into `value`; false if the option is not given.
+//! `expected` describes the valid values in the error thrown for anything else.
+static bool ResolveUIntOption(const case_insensitive_map_t<Value> &options, const char *name, uint32_t min,
+                              uint32_t max, const char *expected, uint32_t &value) {
+	auto it = options.find(name);
+	if (it == options.end()) {
+		return false;
+	}
+	Value converted;
+	string error;
+	if (!it->second.DefaultTryCastAs(LogicalType::UINTEGER, converted, &error) || converted.IsNull() ||
+	    converted.GetValue<uint32_t>() < min || converted.GetValue<uint32_t>() > max) {
+		throw_metastore_error(MetastoreErrorCode::InvalidConfig,
+		                      MetastoreErrorTag {"unknown", "ResolveConnectorConfig", false},
+		                      std::string(name) + " must be " + expected + ", got '" + it->second.ToString() + "'");
+	}
+	value = converted.GetValue<uint32_t>();
+	return true;
+}
+
+static void ResolveMaxConcurrency(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	ResolveUIntOption(options, "MAX_CONCURRENCY", 1, UINT_OPTION_MAX, "a positive integer", config.max_concurrency);
+}
+
+static void ResolveCacheTtl(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	uint32_t seconds = 0;
+	if (ResolveUIntOption(options, "CACHE_TTL", 0, UINT_OPTION_MAX, "a non-negative number of seconds", seconds)) {
+		config.cache_ttl_ms = static_cast<uint64_t>(seconds) * 1000;
+	}
+}
+
+static void ResolveRetry(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	ResolveUIntOption(options, "MAX_RETRIES", 0, UINT_OPTION_MAX, "a non-negative integer", config.max_retries);
+	ResolveUIntOption(options, "RETRY_BACKOFF_MS", 0, UINT_OPTION_MAX, "a non-negative integer",
+	                  config.retry_backoff_ms);
+}
+
+static void ResolveTimeouts(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	ResolveUIntOption(options, "CONNECT_TIMEOUT_MS", 1, UINT_OPTION_MAX, "a positive number of milliseconds",
+	                  config.connect_timeout_ms);
+	ResolveUIntOption(options, "READ_TIMEOUT_MS", 1, UINT_OPTION_MAX, "a positive number of milliseconds",
+	                  config.read_timeout_ms);
+}
+
+static void ResolveHedgePercentile(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	ResolveUIntOption(options, "HEDGE_PERCENTILE", 0, 99, "an integer between 0 and 99", config.hedge_percentile);
+}
+
+static void ResolveMaxReply(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	ResolveUIntOption(options, "MAX_REPLY_MB", 1, UINT_OPTION_MAX, "a positive number of megabytes",
+	                  config.max_reply_mb);
+}
+
+static void ResolvePrefetch(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	auto it = options.find("PREFETCH");
+	if (it == options.end() || it->second.IsNull()) {
+		return;
+	}
+	if (it->second.type().id() == LogicalTypeId::BOOLEAN) {
+		config.prefetch_all = BooleanValue::Get(it->second);
+	} else {
+		auto spec = it->second.ToString();
+		StringUtil::Trim(spec);
+		if (StringUtil::CIEquals(spec, "ALL") || spec == "*") {
+			config.prefetch_all = true;
+		} else {
+			for (auto &name : StringUtil::Split(spec, ',')) {
+				StringUtil::Trim(name);
+				if (!name.empty()) {
+					config.prefetch_namespaces.push_back(name);
+				}
+			}
+		}
+	}
+	if (!config.HasPrefetch()) {
+		return;
+	}
+	if (options.find("CACHE_TTL") == options.end()) {
+		config.cache_ttl_ms = METASTORE_PREFETCH_DEFAULT_CACHE_TTL_MS;
+	} else if (config.cache_ttl_ms == 0) {
+		throw_metastore_error(MetastoreErrorCode::InvalidConfig,
+		                      MetastoreErrorTag {"unknown", "ResolveConnectorConfig", false},
+		                      "PREFETCH fills the metadata cache and cannot be combined with CACHE_TTL 0");
+	}
+}
+
+static void ResolveSharedCache(const case_insensitive_map_t<Value> &options, MetastoreConnectorConfig &config) {
+	ResolveUIntOption(options, "SHARED_CACHE_MB", 1, UINT_OPTION_MAX, "a positive number of megabytes",
+	                  config.shared_cache_mb);
+	config.shared_cache_path = GetOptionString(options, "SHARED_CACHE");
+	if (config.shared_cache_path.empty()) {
+		return;
+	}
+	// Shared entries are aged against the cache TTL, and land in the per-process cache on the way up
+	if (config.cache_ttl_ms == 0) {
+		throw_metastore_error(MetastoreErrorCode::InvalidConfig,
+		                      MetastoreErrorTag {"unknown", "ResolveConnectorConfig", false},
+		                      "SHARED_CACHE needs the metadata cache and cannot be used without CACHE_TTL");
+	}
+}
+
 MetastoreProviderType InferProviderType(const std::string &provider_str) {
 	auto lower = StringUtil::Lower(provider_str);
 	if (lower == "hms") {
@@ -101,6 +206,14 @@ MetastoreConnectorConfig ResolveConnectorConfig(const case_insensitive_map_t<Val
 	}
 
 	ResolveSecret(options, config);
+	ResolveMaxConcurrency(options, config);
+	ResolveCacheTtl(options, config);
+	ResolveRetry(options, config);
+	ResolveTimeouts(options, config);
+	ResolveHedgePercentile(options, config);
+	ResolveMaxReply(options, config);
+	ResolvePrefetch(options, config);
+	ResolveSharedCache(options, config);
 
 	auto provider_name = MetastoreProviderTypeToString(config.provider);
 	switch (config.provider) {
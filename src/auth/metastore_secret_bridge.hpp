@@ -6,6 +6,7 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace duckdb {
 
@@ -43,7 +44,7 @@ inline const char *MetastoreProviderTypeToString(MetastoreProviderType type) {
 struct MetastoreConnectorConfig {
 	//! Which provider backend to use
 	MetastoreProviderType provider = MetastoreProviderType::Unknown;
-	//! Metastore endpoint URI (e.g. "thrift://hms-host:9083" for HMS)
+	//! Metastore endpoint URI (e.g. "thrift://hms-host:9083" for HMS; a comma list for replicated HMS)
 	std::string endpoint;
 	//! Cloud region (required for Glue/Dataproc, optional for HMS)
 	std::optional<std::string> region;
@@ -51,8 +52,39 @@ struct MetastoreConnectorConfig {
 	std::string auth_strategy_class;
 	//! Extensible key-value map for provider-specific parameters
 	std::unordered_map<std::string, std::string> extra_params;
+	//! Upper bound on concurrent metastore calls issued on behalf of this catalog
+	uint32_t max_concurrency = 8;
+	//! Retries of a call that failed with a retryable error (0 disables retrying)
+	uint32_t max_retries = 2;
+	//! Backoff before the first retry; doubles per retry and is jittered
+	uint32_t retry_backoff_ms = 100;
+	//! How long connecting to the metastore may take
+	uint32_t connect_timeout_ms = 5000;
+	//! How long an open metastore call may go without any network progress
+	uint32_t read_timeout_ms = 10000;
+	//! Latency percentile after which a slow table lookup is also sent to another instance; 0 disables
+	uint32_t hedge_percentile = 0;
+	//! Most megabytes of one metastore reply held in memory at once
+	uint32_t max_reply_mb = 256;
+	//! How long table and partition metadata is served from cache; 0 disables the cache
+	uint64_t cache_ttl_ms = 0;
+	//! Namespaces whose tables are loaded into the cache in the background after ATTACH
+	std::vector<std::string> prefetch_namespaces;
+	//! Prefetch every namespace the metastore lists
+	bool prefetch_all = false;
+	//! File of the metadata cache shared with other processes on the host; empty disables it
+	std::string shared_cache_path;
+	//! Ring size in megabytes of a shared cache file this catalog creates
+	uint32_t shared_cache_mb = 256;
+
+	bool HasPrefetch() const {
+		return prefetch_all || !prefetch_namespaces.empty();
+	}
 };
 
+//! Cache TTL used when PREFETCH is given without CACHE_TTL: prefetched metadata needs a cache to land in
+static constexpr uint64_t METASTORE_PREFETCH_DEFAULT_CACHE_TTL_MS = 300000;
+
 //===--------------------------------------------------------------------===//
 // InferProviderType - case-insensitive string to enum mapping
 //===--------------------------------------------------------------------===//
@@ -65,8 +97,11 @@ MetastoreProviderType InferProviderType(const std::string &provider_str);
 //===--------------------------------------------------------------------===//
 //! Resolve a MetastoreConnectorConfig from DuckDB ATTACH options.
 //!
-//! Reads PROVIDER, ENDPOINT, REGION, SECRET, and AUTH_STRATEGY from the
-//! options map. Validates required fields per provider:
+//! Reads PROVIDER, ENDPOINT, REGION, SECRET, AUTH_STRATEGY, MAX_CONCURRENCY,
+//! CACHE_TTL (seconds), PREFETCH ('db1,db2' or 'ALL'), MAX_RETRIES,
+//! RETRY_BACKOFF_MS, CONNECT_TIMEOUT_MS, READ_TIMEOUT_MS, HEDGE_PERCENTILE
+//! (0-99), MAX_REPLY_MB, SHARED_CACHE (file path) and SHARED_CACHE_MB from
+//! the options map. Validates required fields per provider:
 //!   - HMS: ENDPOINT required
 //!   - Glue: REGION required
 //!   - Dataproc: ENDPOINT required
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace duckdb {
+
+//! A cache whose entries a MetastoreCacheBudget can evict
+class MetastoreEvictableCache {
+public:
+	virtual ~MetastoreEvictableCache() = default;
+
+	//! Last use (a MetastoreCacheBudget tick) of the least recently used entry; false if the cache is empty
+	virtual bool OldestUse(uint64_t &tick) = 0;
+	//! Evict the least recently used entry; false if the cache is empty
+	virtual bool EvictOldest() = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreCacheBudget — memory shared by the metadata caches of a database
+//
+// Caches and string pools charge the bytes they hold here. Once the total
+// goes over the limit, the least recently used entries across all caches
+// are evicted until it fits again. Uses are ordered by a budget-wide tick,
+// so a catalog that is read constantly keeps its entries while one that
+// has not been queried for a while gives up its own.
+//
+// The reporter, if set, is told the new total after every change; it is
+// how the budget shows up in DuckDB's memory accounting.
+//===--------------------------------------------------------------------===//
+class MetastoreCacheBudget {
+public:
+	using Reporter = std::function<void(size_t used_bytes)>;
+
+	explicit MetastoreCacheBudget(size_t limit_p = SIZE_MAX) : limit(limit_p) {
+	}
+
+	//! Make the entries of `cache` candidates for eviction
+	void Register(std::weak_ptr<MetastoreEvictableCache> cache) {
+		std::lock_guard<std::mutex> guard(evict_lock);
+		caches.push_back(std::move(cache));
+	}
+
+	//! Change the limit, evicting right away if the caches are over the new one
+	void SetLimit(size_t limit_p) {
+		limit = limit_p;
+		Enforce();
+	}
+
+	//! Replace the reporter (nullptr to stop reporting); a new reporter is told the current total at once
+	void SetReporter(Reporter reporter_p) {
+		Reporter previous;
+		{
+			std::lock_guard<std::mutex> guard(report_lock);
+			previous = std::move(reporter);
+			reporter = std::move(reporter_p);
+			if (reporter) {
+				reporter(Used());
+			}
+		}
+	}
+
+	//! Account for `delta` bytes more (or, if negative, fewer); does not evict
+	void Charge(int64_t delta) {
+		if (delta == 0) {
+			return;
+		}
+		used += delta;
+		std::lock_guard<std::mutex> guard(report_lock);
+		if (reporter) {
+			reporter(Used());
+		}
+	}
+
+	//! Evict least recently used entries until the total is within the limit
+	void Enforce() {
+		if (Used() <= limit) {
+			return;
+		}
+		std::lock_guard<std::mutex> guard(evict_lock);
+		while (Used() > limit) {
+			std::shared_ptr<MetastoreEvictableCache> victim;
+			uint64_t oldest = UINT64_MAX;
+			for (auto it = caches.begin(); it != caches.end();) {
+				auto cache = it->lock();
+				if (!cache) {
+					it = caches.erase(it);
+					continue;
+				}
+				uint64_t tick;
+				if (cache->OldestUse(tick) && tick < oldest) {
+					oldest = tick;
+					victim = std::move(cache);
+				}
+				++it;
+			}
+			if (!victim || !victim->EvictOldest()) {
+				// Whatever is left over is not evictable (e.g. strings of tables a reader still holds)
+				break;
+			}
+			evictions++;
+		}
+	}
+
+	//! Next point in the order of uses
+	uint64_t Tick() {
+		return ++clock;
+	}
+
+	size_t Limit() const {
+		return limit;
+	}
+	size_t Used() const {
+		auto bytes = used.load();
+		return bytes < 0 ? 0 : static_cast<size_t>(bytes);
+	}
+	uint64_t Evictions() const {
+		return evictions;
+	}
+
+private:
+	std::atomic<size_t> limit;
+	std::atomic<int64_t> used {0};
+	std::atomic<uint64_t> clock {0};
+	std::atomic<uint64_t> evictions {0};
+
+	std::mutex evict_lock;
+	std::vector<std::weak_ptr<MetastoreEvictableCache>> caches;
+
+	std::mutex report_lock;
+	Reporter reporter;
+};
+
+} // namespace duckdb
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+#include "metastore_metadata_cache.hpp"
+
+#include <functional>
+#include <memory>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// CachingMetastoreConnector — serves GetTable / ListPartitions /
+// ListPartitionNames / GetPartitionsByNames from the catalog's
+// MetastoreCatalogCache
+//
+// A projected lookup (GetTableProjected) is served from the cached full
+// table when there is one and is otherwise cached under its own key, so
+// narrow lookups never fill the cache with partial tables posing as full
+// ones.
+//
+// Misses are loaded through the wrapped connector (and thus still
+// coalesced); hot entries are refreshed through the refresh scheduler,
+// whose jobs keep the wrapped connector alive until they finish. When the
+// metastore is unreachable, expired entries keep being served within the
+// cache's stale_if_error_ms. Other operations are forwarded to the wrapped
+// connector unchanged.
+//===--------------------------------------------------------------------===//
+class CachingMetastoreConnector : public IMetastoreConnector {
+public:
+	CachingMetastoreConnector(std::shared_ptr<IMetastoreConnector> inner, std::shared_ptr<MetastoreCatalogCache> cache,
+	                          MetastoreRefreshScheduler schedule_refresh);
+
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespaces() override;
+	MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) override;
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespacesMatching(const std::string &pattern) override;
+	MetastoreResult<std::vector<std::string>> ListTablesMatching(const std::string &namespace_name,
+	                                                             const std::string &pattern,
+	                                                             const std::string &table_type = "") override;
+	MetastoreResult<std::vector<MetastoreTableSummary>>
+	ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+	                   const std::vector<std::string> &table_types) override;
+	MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
+	                                         const std::string &table_name) override;
+	MetastoreResult<MetastoreTable> GetTableProjected(const std::string &namespace_name, const std::string &table_name,
+	                                                  MetastoreTableFields fields) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTables(const std::string &namespace_name,
+	                                                       const std::vector<std::string> &table_names) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTablesProjected(const std::string &namespace_name,
+	                                                                const std::vector<std::string> &table_names,
+	                                                                MetastoreTableFields fields) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	ListPartitions(const std::string &namespace_name, const std::string &table_name,
+	               const std::string &predicate = "") override;
+	MetastoreResult<std::vector<std::string>> ListPartitionNames(const std::string &namespace_name,
+	                                                             const std::string &table_name) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                     const std::vector<std::string> &partition_names) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+	                              const std::vector<std::string> &partition_names,
+	                              MetastorePartitionFields fields) override;
+	MetastoreResult<MetastoreTableProperties> GetTableStats(const std::string &namespace_name,
+	                                                        const std::string &table_name) override;
+
+private:
+	std::shared_ptr<IMetastoreConnector> inner;
+	std::shared_ptr<MetastoreCatalogCache> cache;
+	MetastoreRefreshScheduler schedule_refresh;
+};
+
+} // namespace duckdb
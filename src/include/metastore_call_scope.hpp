@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// MetastoreCallControl — when metastore calls made for a query must stop
+//===--------------------------------------------------------------------===//
+struct MetastoreCallControl {
+	//! Returns true once the query was interrupted; unset for calls nobody can cancel
+	std::function<bool()> is_cancelled;
+	//! Calls still open at this point fail; max() for no deadline
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+	bool IsCancelled() const {
+		return is_cancelled && is_cancelled();
+	}
+	bool HasDeadline() const {
+		return deadline != std::chrono::steady_clock::time_point::max();
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreCallScope — installs a MetastoreCallControl for the current thread
+//
+// Connector methods take no per-call context, so the query's control is
+// passed down thread-locally: the DuckDB layer opens a scope around its
+// connector calls and provider I/O loops poll Current(). Scopes nest and
+// restore the previous control when they end. Work handed to other threads
+// (the task runner's helpers) must re-install the control there; work
+// that outlives the query (background refreshes) runs without one.
+//===--------------------------------------------------------------------===//
+class MetastoreCallScope {
+public:
+	explicit MetastoreCallScope(std::shared_ptr<const MetastoreCallControl> control) : previous(Slot()) {
+		Slot() = std::move(control);
+	}
+	~MetastoreCallScope() {
+		Slot() = std::move(previous);
+	}
+
+	MetastoreCallScope(const MetastoreCallScope &) = delete;
+	MetastoreCallScope &operator=(const MetastoreCallScope &) = delete;
+
+	//! Control of the innermost scope on this thread; null outside any scope
+	static const std::shared_ptr<const MetastoreCallControl> &Current() {
+		return Slot();
+	}
+
+	//! Whether the calls of the current scope must stop now (interrupted or past the deadline)
+	static bool ShouldStop() {
+		auto &control = Slot();
+		return control && (control->IsCancelled() || std::chrono::steady_clock::now() >= control->deadline);
+	}
+
+private:
+	static std::shared_ptr<const MetastoreCallControl> &Slot() {
+		static thread_local std::shared_ptr<const MetastoreCallControl> slot;
+		return slot;
+	}
+
+	std::shared_ptr<const MetastoreCallControl> previous;
+};
+
+} // namespace duckdb
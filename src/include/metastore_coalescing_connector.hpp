@@ -0,0 +1,63 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+#include "metastore_single_flight.hpp"
+
+#include <memory>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// CoalescingMetastoreConnector — single-flight wrapper around a connector
+//
+// GetTable, ListTables and ListPartitions calls that are identical to one
+// already in flight on the same group (one group per attached catalog)
+// wait for that call and share its result, so a burst of queries binding
+// the same table sends one request to the metastore. A caller whose shared
+// call was cut short by the leader's query being interrupted repeats it on
+// its own. Other operations are forwarded unchanged.
+//===--------------------------------------------------------------------===//
+class CoalescingMetastoreConnector : public IMetastoreConnector {
+public:
+	CoalescingMetastoreConnector(std::unique_ptr<IMetastoreConnector> inner,
+	                             std::shared_ptr<MetastoreSingleFlight> group);
+
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespaces() override;
+	MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) override;
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespacesMatching(const std::string &pattern) override;
+	MetastoreResult<std::vector<std::string>> ListTablesMatching(const std::string &namespace_name,
+	                                                             const std::string &pattern,
+	                                                             const std::string &table_type = "") override;
+	MetastoreResult<std::vector<MetastoreTableSummary>>
+	ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+	                   const std::vector<std::string> &table_types) override;
+	MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
+	                                         const std::string &table_name) override;
+	MetastoreResult<MetastoreTable> GetTableProjected(const std::string &namespace_name, const std::string &table_name,
+	                                                  MetastoreTableFields fields) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTables(const std::string &namespace_name,
+	                                                       const std::vector<std::string> &table_names) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTablesProjected(const std::string &namespace_name,
+	                                                                const std::vector<std::string> &table_names,
+	                                                                MetastoreTableFields fields) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	ListPartitions(const std::string &namespace_name, const std::string &table_name,
+	               const std::string &predicate = "") override;
+	MetastoreResult<std::vector<std::string>> ListPartitionNames(const std::string &namespace_name,
+	                                                             const std::string &table_name) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                     const std::vector<std::string> &partition_names) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+	                              const std::vector<std::string> &partition_names,
+	                              MetastorePartitionFields fields) override;
+	MetastoreResult<MetastoreTableProperties> GetTableStats(const std::string &namespace_name,
+	                                                        const std::string &table_name) override;
+
+private:
+	std::unique_ptr<IMetastoreConnector> inner;
+	std::shared_ptr<MetastoreSingleFlight> group;
+};
+
+} // namespace duckdb
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "metastore_cache_budget.hpp"
+#include "metastore_types.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//! Heap bytes behind `value` beyond the std::string itself; zero while it fits the small-string buffer
+inline size_t MetastoreStringHeapBytes(const std::string &value) {
+	static const size_t inline_capacity = std::string().capacity();
+	return value.capacity() > inline_capacity ? value.capacity() + 1 : 0;
+}
+
+//===--------------------------------------------------------------------===//
+// MetastoreStringPool — strings shared by the cached tables of a catalog
+//
+// Serde classes, input and output formats, column names, column types and
+// property keys repeat across thousands of tables. The pool keeps a single
+// copy of each; cached tables hold counted references to it, and a string
+// is dropped with the last table that uses it. A handle can be read
+// without locking for as long as its reference is held. Pooled strings
+// are charged to the budget, if the pool has one.
+//===--------------------------------------------------------------------===//
+class MetastoreStringPool {
+public:
+	struct Entry {
+		std::string value;
+		//! References held on the string; guarded by the pool lock
+		uint32_t references = 0;
+	};
+	using Handle = const Entry *;
+
+	explicit MetastoreStringPool(std::shared_ptr<MetastoreCacheBudget> budget = nullptr);
+	~MetastoreStringPool();
+
+	MetastoreStringPool(const MetastoreStringPool &) = delete;
+	MetastoreStringPool &operator=(const MetastoreStringPool &) = delete;
+
+	//! Handle to the pooled copy of `value`, taking a reference on it
+	Handle Intern(std::string_view value);
+	//! Drop a reference taken by Intern
+	void Release(Handle handle);
+
+	//! Number of distinct strings held
+	size_t Size();
+	//! Bytes held by the pool, including its index
+	size_t MemoryUsage();
+
+private:
+	//! Bytes a pooled string takes: its entry, heap buffer and index node
+	static size_t EntryBytes(const Entry &entry);
+
+	std::shared_ptr<MetastoreCacheBudget> budget;
+	std::mutex lock;
+	//! A deque never moves its elements, so handles and the index's keys stay valid as it grows
+	std::deque<Entry> entries;
+	std::vector<Entry *> free_entries;
+	std::unordered_map<std::string_view, Entry *> index;
+	//! Sum of EntryBytes of the pooled strings
+	size_t string_bytes = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreCompactTable — a MetastoreTable as the metadata cache keeps it
+//
+// Strings that repeat across tables are handles into the catalog's string
+// pool, and the strings particular to the table (name, location, property
+// values) are stored back to back in one buffer. Columns, partition keys
+// and both property maps are flat arrays in a single allocation, property
+// maps sorted by key so one property can be read without expanding the
+// table. A cached table thus costs a few hundred bytes plus its property
+// values, instead of a heap allocation per string and map node.
+//===--------------------------------------------------------------------===//
+class MetastoreCompactTable {
+public:
+	MetastoreCompactTable(const MetastoreTable &table, std::shared_ptr<MetastoreStringPool> pool);
+	~MetastoreCompactTable();
+
+	MetastoreCompactTable(const MetastoreCompactTable &) = delete;
+	MetastoreCompactTable &operator=(const MetastoreCompactTable &) = delete;
+
+	//! The table as it was cached
+	MetastoreTable Expand() const;
+	//! Value of the table property `key`; nullopt if the table has no such property
+	std::optional<std::string_view> FindProperty(std::string_view key) const;
+	//! Bytes held by this table, not counting the pooled strings it references
+	size_t MemoryUsage() const;
+
+private:
+	using Handle = MetastoreStringPool::Handle;
+
+	//! Position of a string in the table's own text
+	struct TextRef {
+		uint32_t offset = 0;
+		uint32_t size = 0;
+	};
+	struct ColumnRef {
+		Handle name;
+		Handle type;
+	};
+	struct SerdeParameterRef {
+		Handle key;
+		Handle value;
+	};
+	struct PropertyRef {
+		Handle key;
+		TextRef value;
+	};
+
+	const ColumnRef *Columns() const;
+	const ColumnRef *PartitionKeys() const;
+	const SerdeParameterRef *SerdeParameters() const;
+	const PropertyRef *Properties() const;
+	std::string_view Text(TextRef ref) const;
+	Handle InternOptional(const std::optional<std::string> &value);
+
+	std::shared_ptr<MetastoreStringPool> pool;
+	//! Column, partition key, serde parameter and property arrays, followed by the text
+	std::unique_ptr<char[]> data;
+	uint32_t data_size = 0;
+	uint32_t column_count = 0;
+	uint32_t partition_key_count = 0;
+	uint32_t serde_parameter_count = 0;
+	uint32_t property_count = 0;
+	uint32_t text_offset = 0;
+
+	Handle catalog = nullptr;
+	Handle namespace_name = nullptr;
+	TextRef name;
+	TextRef location;
+	//! Null where the table has no value
+	Handle serde_class = nullptr;
+	Handle input_format = nullptr;
+	Handle output_format = nullptr;
+	Handle owner = nullptr;
+	MetastoreFormat format = MetastoreFormat::Unknown;
+	MetastoreTableFields fields = MetastoreTableFields::All;
+};
+
+//! MetastoreTtlCache storage that keeps tables compacted against the catalog's string pool
+struct MetastoreCompactTableStorage {
+	using Stored = MetastoreCompactTable;
+
+	std::shared_ptr<MetastoreStringPool> strings;
+
+	std::shared_ptr<const MetastoreCompactTable> Pack(const MetastoreTable &table) const {
+		return std::make_shared<const MetastoreCompactTable>(table, strings);
+	}
+	MetastoreTable Unpack(const MetastoreCompactTable &stored) const {
+		return stored.Expand();
+	}
+	size_t MemoryUsage(const MetastoreCompactTable &stored) const {
+		return stored.MemoryUsage();
+	}
+};
+
+} // namespace duckdb
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "metastore_task_runner.hpp"
 #include "metastore_types.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,7 +20,9 @@ enum class MetastoreErrorCode : int32_t {
 	PermissionDenied = 2,
 	Transient = 3,
 	InvalidConfig = 4,
-	Unsupported = 5
+	Unsupported = 5,
+	//! The query the call was made for was interrupted
+	Cancelled = 6
 };
 
 //===--------------------------------------------------------------------===//
@@ -84,10 +89,107 @@ public:
 	//! List all tables within a given namespace.
 	virtual MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) = 0;
 
+	//! List the namespaces whose names match `pattern` (see MetastoreNameMatchesPattern). Connectors that
+	//! can filter on the server override this; the default lists every namespace and filters.
+	virtual MetastoreResult<std::vector<MetastoreNamespace>> ListNamespacesMatching(const std::string &pattern) {
+		auto result = ListNamespaces();
+		if (result.IsOk() && !pattern.empty()) {
+			auto &namespaces = result.value;
+			namespaces.erase(std::remove_if(namespaces.begin(), namespaces.end(),
+			                                [&](const MetastoreNamespace &ns) {
+				                                return !MetastoreNameMatchesPattern(ns.name, pattern);
+			                                }),
+			                 namespaces.end());
+		}
+		return result;
+	}
+
+	//! List the tables of a namespace whose names match `pattern` and, unless `table_type` is empty, whose
+	//! metastore table type is `table_type`. The default lists every table and filters the names; it
+	//! cannot filter by type.
+	virtual MetastoreResult<std::vector<std::string>> ListTablesMatching(const std::string &namespace_name,
+	                                                                     const std::string &pattern,
+	                                                                     const std::string &table_type = "") {
+		if (!table_type.empty()) {
+			return MetastoreResult<std::vector<std::string>>::Error(
+			    MetastoreErrorCode::Unsupported, "Filtering tables by type not supported by this connector");
+		}
+		auto result = ListTables(namespace_name);
+		if (result.IsOk() && !pattern.empty()) {
+			auto &tables = result.value;
+			tables.erase(std::remove_if(tables.begin(), tables.end(),
+			                            [&](const std::string &table) {
+				                            return !MetastoreNameMatchesPattern(table, pattern);
+			                            }),
+			             tables.end());
+		}
+		return result;
+	}
+
+	//! Name, type and comment of the tables matching `table_pattern` in every namespace matching
+	//! `namespace_pattern`, restricted to `table_types` unless that is empty. The default walks the
+	//! namespaces with ListTablesMatching, once per requested type; comments are left empty.
+	virtual MetastoreResult<std::vector<MetastoreTableSummary>>
+	ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+	                   const std::vector<std::string> &table_types) {
+		auto namespaces = ListNamespacesMatching(namespace_pattern);
+		if (!namespaces.IsOk()) {
+			return MetastoreResult<std::vector<MetastoreTableSummary>>::Error(
+			    namespaces.error.code, std::move(namespaces.error.message), std::move(namespaces.error.detail),
+			    namespaces.error.retryable);
+		}
+		std::vector<std::string> types = table_types.empty() ? std::vector<std::string> {""} : table_types;
+		std::vector<MetastoreTableSummary> summaries;
+		for (auto &ns : namespaces.value) {
+			for (auto &type : types) {
+				auto tables = ListTablesMatching(ns.name, table_pattern, type);
+				if (!tables.IsOk()) {
+					return MetastoreResult<std::vector<MetastoreTableSummary>>::Error(
+					    tables.error.code, std::move(tables.error.message), std::move(tables.error.detail),
+					    tables.error.retryable);
+				}
+				for (auto &table : tables.value) {
+					MetastoreTableSummary summary;
+					summary.namespace_name = ns.name;
+					summary.name = std::move(table);
+					summary.table_type = type;
+					summaries.push_back(std::move(summary));
+				}
+			}
+		}
+		return MetastoreResult<std::vector<MetastoreTableSummary>>::Success(std::move(summaries));
+	}
+
 	//! Get full table metadata for a specific table.
 	virtual MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
 	                                                 const std::string &table_name) = 0;
 
+	//! Get the parts of a table's metadata named by `fields` (see MetastoreTableFields). Connectors that
+	//! can skip the rest override this; the default fetches everything.
+	virtual MetastoreResult<MetastoreTable> GetTableProjected(const std::string &namespace_name,
+	                                                          const std::string &table_name,
+	                                                          MetastoreTableFields fields) {
+		return GetTable(namespace_name, table_name);
+	}
+
+	//! Get metadata for several tables of one namespace. Results are in input order and
+	//! each carries its own error. Default implementation fans GetTable out over the task runner.
+	virtual std::vector<MetastoreResult<MetastoreTable>> GetTables(const std::string &namespace_name,
+	                                                               const std::vector<std::string> &table_names) {
+		std::vector<MetastoreResult<MetastoreTable>> results(table_names.size());
+		GetTaskRunner().RunAll(table_names.size(),
+		                       [&](size_t i) { results[i] = GetTable(namespace_name, table_names[i]); });
+		return results;
+	}
+
+	//! Like GetTables, but only the parts named by `fields` need to be filled in, as with
+	//! GetTableProjected. The default fetches everything.
+	virtual std::vector<MetastoreResult<MetastoreTable>>
+	GetTablesProjected(const std::string &namespace_name, const std::vector<std::string> &table_names,
+	                   MetastoreTableFields fields) {
+		return GetTables(namespace_name, table_names);
+	}
+
 	//! List partition values for a partitioned table.
 	//! @param predicate  Optional filter expression to push down to the metastore.
 	//!                   Empty string means "all partitions".
@@ -95,6 +197,34 @@ public:
 	ListPartitions(const std::string &namespace_name, const std::string &table_name,
 	               const std::string &predicate = "") = 0;
 
+	//! (Optional) List the names (`k1=v1/k2=v2`) of all partitions of a table.
+	//! Together with GetPartitionsByNames this lets callers page through
+	//! partition descriptors instead of materializing them all at once.
+	//! Default implementation returns Unsupported.
+	virtual MetastoreResult<std::vector<std::string>> ListPartitionNames(const std::string &namespace_name,
+	                                                                     const std::string &table_name) {
+		return MetastoreResult<std::vector<std::string>>::Error(MetastoreErrorCode::Unsupported,
+		                                                       "ListPartitionNames not supported by this connector");
+	}
+
+	//! (Optional) Fetch full partition descriptors (values, location, parameters)
+	//! for the given partition names. Default implementation returns Unsupported.
+	virtual MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                     const std::vector<std::string> &partition_names) {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Error(
+		    MetastoreErrorCode::Unsupported, "GetPartitionsByNames not supported by this connector");
+	}
+
+	//! Like GetPartitionsByNames, but only the parts named by `fields` (see MetastorePartitionFields) need
+	//! to be filled in. Connectors that can leave out the rest override this; the default fetches
+	//! everything.
+	virtual MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+	                              const std::vector<std::string> &partition_names, MetastorePartitionFields fields) {
+		return GetPartitionsByNames(namespace_name, table_name, partition_names);
+	}
+
 	//! (Optional) Retrieve table-level statistics if the metastore supports them.
 	//! Default implementation returns Unsupported.
 	virtual MetastoreResult<MetastoreTableProperties> GetTableStats(const std::string &namespace_name,
@@ -102,6 +232,53 @@ public:
 		return MetastoreResult<MetastoreTableProperties>::Error(MetastoreErrorCode::Unsupported,
 		                                                       "GetTableStats not supported by this connector");
 	}
+
+	//! Install the runner used to fan out independent calls. Without one, work runs serially.
+	void SetTaskRunner(std::shared_ptr<IMetastoreTaskRunner> runner) {
+		task_runner = std::move(runner);
+	}
+
+	//! Runner of this connector's fan-outs; callers fanning out calls against the connector use it too
+	IMetastoreTaskRunner &GetTaskRunner() {
+		if (!task_runner) {
+			task_runner = std::make_shared<SerialMetastoreTaskRunner>();
+		}
+		return *task_runner;
+	}
+
+private:
+	std::shared_ptr<IMetastoreTaskRunner> task_runner;
 };
 
+//===--------------------------------------------------------------------===//
+// FetchPartitionBatch — pages partition descriptors by name
+//
+// The metastore leaves out names it no longer knows (partitions dropped
+// since the listing, which cached listings make more likely), so a batch
+// can come back empty. Callers that treat an empty batch as the end of
+// their output use this to skip to the next one instead.
+//===--------------------------------------------------------------------===//
+//! Claims batches of `batch_size` names from `next_batch` until one yields descriptors, and returns them with
+//! its index in `batch_index`. An empty result means every batch has been claimed.
+inline MetastoreResult<std::vector<MetastorePartitionValue>>
+FetchPartitionBatch(IMetastoreConnector &connector, const std::string &namespace_name, const std::string &table_name,
+                    const std::vector<std::string> &partition_names, uint64_t batch_size,
+                    std::atomic<uint64_t> &next_batch, uint64_t &batch_index) {
+	auto batch_count = (partition_names.size() + batch_size - 1) / batch_size;
+	for (batch_index = next_batch++; batch_index < batch_count; batch_index = next_batch++) {
+		auto offset = batch_index * batch_size;
+		auto count = std::min<uint64_t>(partition_names.size() - offset, batch_size);
+		auto batch_begin = partition_names.begin() + static_cast<std::ptrdiff_t>(offset);
+		std::vector<std::string> batch(batch_begin, batch_begin + static_cast<std::ptrdiff_t>(count));
+		auto result = connector.GetPartitionsByNames(namespace_name, table_name, batch);
+		if (!result.IsOk() || !result.value.empty()) {
+			if (result.value.size() > count) {
+				result.value.resize(count);
+			}
+			return result;
+		}
+	}
+	return MetastoreResult<std::vector<MetastorePartitionValue>>::Success({});
+}
+
 } // namespace duckdb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+#include "duckdb.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Warehouse crawl
+//
+// Lists the namespaces matching a pattern with one call, then the matching
+// tables of every namespace concurrently, then fetches table metadata in
+// batches of METASTORE_CRAWL_BATCH_SIZE, again concurrently. All fan-out
+// goes through the connector's task runner, so it stays within the
+// catalog's MAX_CONCURRENCY budget and uses its pooled connections.
+//===--------------------------------------------------------------------===//
+static constexpr size_t METASTORE_CRAWL_BATCH_SIZE = 256;
+
+struct MetastoreCrawlCallbacks {
+	//! Called once per namespace, before any of its tables, with the number of tables listed or the listing error
+	std::function<void(const std::string &namespace_name, size_t table_count, const MetastoreError &error)>
+	    on_namespace;
+	//! Called once per fetched batch of a namespace's tables
+	std::function<void(const std::string &namespace_name, std::vector<MetastoreResult<MetastoreTable>> &tables)>
+	    on_tables;
+};
+
+//! Crawl the tables matching `table_pattern` in the namespaces matching `namespace_pattern` (see
+//! MetastoreNameMatchesPattern). Callbacks may run on several threads, but never two at once, and
+//! must not throw. Fails only if the namespaces cannot be listed.
+MetastoreError CrawlMetastore(IMetastoreConnector &connector, const std::string &namespace_pattern,
+                              const std::string &table_pattern, const MetastoreCrawlCallbacks &callbacks);
+
+//! What metastore_crawl() did for one namespace
+struct MetastoreCrawlNamespaceResult {
+	std::string namespace_name;
+	idx_t views_created = 0;
+	idx_t tables_failed = 0;
+	//! First error of the namespace; empty if there was none
+	std::string error;
+	//! When the namespace was crawled, i.e. the time its views' column lists are from
+	timestamp_t columns_as_of = timestamp_t(0);
+};
+
+//===--------------------------------------------------------------------===//
+// Crawling into the attached catalog
+//
+// Catalog browsers (information_schema.tables and .columns, duckdb_tables(),
+// BI tools) only see entries of the attached catalog, while queries reach
+// metastore tables through the replacement scan. This creates a schema per
+// crawled namespace and a view per crawled table, typed with the
+// metastore's column types, in its own transaction per batch so entries
+// show up while the crawl is still running. Views read through
+// metastore_read(), so partitions and locations are resolved when a view
+// is queried; re-crawling replaces them with current metadata.
+//
+// The column list is the exception: a view selects the table's columns as
+// of the crawl, cast to their types then, and catalog.schema.table binds
+// to the view rather than the replacement scan. Columns added to the table
+// later are missing from the view, and dropped or renamed columns make it
+// fail to bind, until the namespace is crawled again. metastore_crawl()
+// reports when each namespace's column lists were taken.
+//===--------------------------------------------------------------------===//
+std::vector<MetastoreCrawlNamespaceResult> CrawlMetastoreIntoCatalog(ClientContext &context,
+                                                                     const std::string &catalog_name,
+                                                                     const std::string &namespace_pattern,
+                                                                     const std::string &table_pattern);
+
+} // namespace duckdb
@@ -21,6 +21,8 @@ inline const char *MetastoreErrorCodeToString(MetastoreErrorCode code) {
 		return "InvalidConfig";
 	case MetastoreErrorCode::Unsupported:
 		return "Unsupported";
+	case MetastoreErrorCode::Cancelled:
+		return "Cancelled";
 	default:
 		return "Unknown";
 	}
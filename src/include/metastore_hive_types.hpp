@@ -0,0 +1,14 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+//! Map a Hive column type string (e.g. "int", "varchar(10)") to a DuckDB type name.
+//! Unknown and complex types fall back to VARCHAR.
+string MapHiveTypeToDuckDB(const string &hive_type);
+
+//! Map a Hive column type string to a DuckDB LogicalType.
+LogicalType MapHiveTypeToLogicalType(const string &hive_type);
+
+} // namespace duckdb
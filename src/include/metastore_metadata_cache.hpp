@@ -0,0 +1,423 @@
+#pragma once
+
+#include "metastore_cache_budget.hpp"
+#include "metastore_compact_table.hpp"
+#include "metastore_connector.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// MetastoreCacheOptions — freshness policy of the metadata cache
+//===--------------------------------------------------------------------===//
+struct MetastoreCacheOptions {
+	//! Time an entry is served without revalidation; 0 disables caching
+	uint64_t ttl_ms = 0;
+	//! Hot entries are refreshed in the background once they reach this fraction of their TTL
+	double refresh_ahead_fraction = 0.75;
+	//! How long past expiry a hot entry may still be served while its refresh runs
+	uint64_t max_stale_ms = 0;
+	//! Reads within one entry lifetime after which the entry counts as hot
+	uint64_t hot_access_threshold = 2;
+	//! How long past expiry any entry is still served when reloading it fails with a transient error
+	//! (metastore unreachable, circuit breaker open)
+	uint64_t stale_if_error_ms = 0;
+};
+
+//! Runs a refresh job off the caller's thread
+using MetastoreRefreshScheduler = std::function<void(std::function<void()>)>;
+
+//! How MetastoreTtlCache keeps its values: as they are, unless it is given a storage that packs them
+template <typename T>
+struct MetastoreCachedValue {
+	using Stored = T;
+
+	std::shared_ptr<const T> Pack(const T &value) const {
+		return std::make_shared<const T>(value);
+	}
+	T Unpack(const T &stored) const {
+		return stored;
+	}
+	size_t MemoryUsage(const T &stored) const {
+		return sizeof(T);
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreTtlCache — TTL cache with refresh-ahead and stale-while-revalidate
+//
+// Entries that are read often enough during their lifetime ("hot") are
+// reloaded in the background before they expire, and once expired they are
+// still served for up to max_stale_ms while that reload runs. Readers of a
+// hot entry therefore never wait on the metastore. Cold entries simply
+// expire and the next reader loads them synchronously. The access count
+// restarts with every load, so an entry stays hot only while it is used.
+// Expired entries are kept for stale_if_error_ms more, to be served only
+// if their synchronous reload fails with a transient error.
+//
+// Loaders must be self-contained (capture by value): a refresh may run
+// after the reader that scheduled it has returned.
+//
+// Values are kept in the form `Storage` packs them into (e.g. compacted
+// tables) and unpacked for every reader; the cache keeps count of the
+// bytes they take. With a budget, those bytes are charged to it, and the
+// budget evicts entries in least recently used order when it runs over.
+//===--------------------------------------------------------------------===//
+template <typename T, typename Storage = MetastoreCachedValue<T>>
+class MetastoreTtlCache : public MetastoreEvictableCache,
+                          public std::enable_shared_from_this<MetastoreTtlCache<T, Storage>> {
+public:
+	using Loader = std::function<MetastoreResult<T>()>;
+	using Clock = std::chrono::steady_clock;
+
+	explicit MetastoreTtlCache(MetastoreCacheOptions options_p, Storage storage_p = Storage(),
+	                           std::shared_ptr<MetastoreCacheBudget> budget_p = nullptr)
+	    : options(options_p), storage(std::move(storage_p)), budget(std::move(budget_p)) {
+	}
+
+	~MetastoreTtlCache() override {
+		if (budget) {
+			budget->Charge(-static_cast<int64_t>(bytes_used));
+		}
+	}
+
+	//! Serve `key` from the cache if it is fresh (or hot and within its staleness budget), scheduling
+	//! a background reload with `loader` when due. Returns false on a miss.
+	bool Lookup(const std::string &key, const Loader &loader, const MetastoreRefreshScheduler &schedule, T &out) {
+		std::shared_ptr<const Stored> value;
+		bool refresh = false;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto it = entries.find(key);
+			if (it == entries.end()) {
+				return false;
+			}
+			auto &entry = it->second;
+			auto age = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - entry.loaded_at);
+			auto age_ms = static_cast<uint64_t>(age.count());
+			// Hotness counts earlier reads only, so a single read after a load never keeps an entry alive
+			bool hot = entry.hits >= options.hot_access_threshold;
+			entry.hits++;
+			if (age_ms < options.ttl_ms) {
+				refresh = hot && age_ms >= RefreshAheadMs();
+			} else if (hot && age_ms < options.ttl_ms + options.max_stale_ms) {
+				// Stale-while-revalidate: serve the old entry, reload in the background
+				refresh = true;
+			} else {
+				if (age_ms >= options.ttl_ms + options.stale_if_error_ms) {
+					Erase(it);
+				}
+				return false;
+			}
+			value = entry.value;
+			Touch(entry);
+			refresh = refresh && !entry.refreshing;
+			if (refresh) {
+				entry.refreshing = true;
+			}
+		}
+		if (refresh) {
+			ScheduleRefresh(key, loader, schedule);
+		}
+		out = storage.Unpack(*value);
+		return true;
+	}
+
+	//! Lookup, loading synchronously with `loader` on a miss. Only successful loads are cached.
+	MetastoreResult<T> Get(const std::string &key, const Loader &loader, const MetastoreRefreshScheduler &schedule) {
+		T value;
+		if (Lookup(key, loader, schedule, value)) {
+			return MetastoreResult<T>::Success(std::move(value));
+		}
+		auto result = loader();
+		if (result.IsOk()) {
+			Store(key, result.value, 1);
+		} else if (result.error.code == MetastoreErrorCode::Transient && GetStale(key, value)) {
+			return MetastoreResult<T>::Success(std::move(value));
+		}
+		return result;
+	}
+
+	//! The entry for `key` if it is within stale_if_error_ms of its expiry, for callers whose reload
+	//! failed with a transient error. Returns false otherwise.
+	bool GetStale(const std::string &key, T &out) {
+		std::shared_ptr<const Stored> value;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto it = entries.find(key);
+			if (it == entries.end()) {
+				return false;
+			}
+			auto age = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - it->second.loaded_at);
+			if (static_cast<uint64_t>(age.count()) >= options.ttl_ms + options.stale_if_error_ms) {
+				return false;
+			}
+			value = it->second.value;
+			Touch(it->second);
+		}
+		out = storage.Unpack(*value);
+		return true;
+	}
+
+	//! Insert a value loaded outside the cache (e.g. by a bulk call) as if it had just been read
+	void Put(const std::string &key, const T &value) {
+		Store(key, value, 1);
+	}
+
+	void Invalidate(const std::string &key) {
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = entries.find(key);
+		if (it != entries.end()) {
+			Erase(it);
+		}
+	}
+
+	void Clear() {
+		std::lock_guard<std::mutex> guard(lock);
+		entries.clear();
+		lru.clear();
+		Charge(-static_cast<int64_t>(bytes_used));
+		bytes_used = 0;
+	}
+
+	size_t Size() {
+		std::lock_guard<std::mutex> guard(lock);
+		return entries.size();
+	}
+
+	//! Bytes taken by the cached entries: their keys, bookkeeping and stored values
+	size_t MemoryUsage() {
+		std::lock_guard<std::mutex> guard(lock);
+		return bytes_used + entries.bucket_count() * sizeof(void *);
+	}
+
+	//! Entries evicted to keep the budget
+	uint64_t Evictions() const {
+		return evictions;
+	}
+
+	const MetastoreCacheOptions &Options() const {
+		return options;
+	}
+
+	bool OldestUse(uint64_t &tick) override {
+		std::lock_guard<std::mutex> guard(lock);
+		if (lru.empty()) {
+			return false;
+		}
+		tick = entries.find(*lru.back())->second.last_used;
+		return true;
+	}
+
+	bool EvictOldest() override {
+		std::lock_guard<std::mutex> guard(lock);
+		if (lru.empty()) {
+			return false;
+		}
+		Erase(entries.find(*lru.back()));
+		evictions++;
+		return true;
+	}
+
+private:
+	using Stored = typename Storage::Stored;
+	struct Entry {
+		std::shared_ptr<const Stored> value;
+		//! Bytes charged for the entry, key included
+		size_t bytes = 0;
+		Clock::time_point loaded_at;
+		//! Reads since the entry was (re)loaded
+		uint64_t hits = 0;
+		//! A background refresh is scheduled or running
+		bool refreshing = false;
+		//! Tick of the last read or load, and the entry's place in the LRU list
+		uint64_t last_used = 0;
+		typename std::list<const std::string *>::iterator lru_position;
+	};
+
+	uint64_t RefreshAheadMs() const {
+		return static_cast<uint64_t>(static_cast<double>(options.ttl_ms) * options.refresh_ahead_fraction);
+	}
+
+	//! Bytes an entry for `key` holding `value` takes, including its hash table node
+	size_t EntryBytes(const std::string &key, const Stored &value) const {
+		static constexpr size_t NODE_BYTES = sizeof(std::pair<const std::string, Entry>) + 2 * sizeof(void *);
+		return NODE_BYTES + MetastoreStringHeapBytes(key) + storage.MemoryUsage(value);
+	}
+
+	uint64_t NextTick() {
+		return budget ? budget->Tick() : ++local_clock;
+	}
+
+	void Charge(int64_t delta) {
+		if (budget) {
+			budget->Charge(delta);
+		}
+	}
+
+	//! Record a use of `entry`, moving it to the front of the LRU list
+	void Touch(Entry &entry) {
+		entry.last_used = NextTick();
+		lru.splice(lru.begin(), lru, entry.lru_position);
+	}
+
+	void Erase(typename std::unordered_map<std::string, Entry>::iterator it) {
+		bytes_used -= it->second.bytes;
+		Charge(-static_cast<int64_t>(it->second.bytes));
+		lru.erase(it->second.lru_position);
+		entries.erase(it);
+	}
+
+	void Store(const std::string &key, const T &value, uint64_t hits) {
+		// Packing can be costly (interning every string of a table), so it happens outside the lock
+		auto stored = storage.Pack(value);
+		auto bytes = EntryBytes(key, *stored);
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto inserted = entries.emplace(key, Entry());
+			auto &entry = inserted.first->second;
+			if (inserted.second) {
+				// Map nodes never move, so the list can point at their keys
+				lru.push_front(&inserted.first->first);
+				entry.lru_position = lru.begin();
+			} else {
+				lru.splice(lru.begin(), lru, entry.lru_position);
+			}
+			bytes_used = bytes_used - entry.bytes + bytes;
+			Charge(static_cast<int64_t>(bytes) - static_cast<int64_t>(entry.bytes));
+			entry.value = std::move(stored);
+			entry.bytes = bytes;
+			entry.loaded_at = Clock::now();
+			entry.last_used = NextTick();
+			entry.hits = hits;
+			entry.refreshing = false;
+		}
+		if (budget) {
+			budget->Enforce();
+		}
+	}
+
+	void ScheduleRefresh(const std::string &key, const Loader &loader, const MetastoreRefreshScheduler &schedule) {
+		std::weak_ptr<MetastoreTtlCache<T, Storage>> weak_self = this->shared_from_this();
+		schedule([weak_self, key, loader]() {
+			auto result = loader();
+			auto self = weak_self.lock();
+			if (!self) {
+				return;
+			}
+			if (result.IsOk()) {
+				self->Store(key, result.value, 0);
+				return;
+			}
+			// Keep serving the old entry until it runs out of staleness budget; a later read retries
+			std::lock_guard<std::mutex> guard(self->lock);
+			auto it = self->entries.find(key);
+			if (it != self->entries.end()) {
+				it->second.refreshing = false;
+			}
+		});
+	}
+
+	MetastoreCacheOptions options;
+	Storage storage;
+	//! Null for a cache without a memory limit
+	std::shared_ptr<MetastoreCacheBudget> budget;
+	std::mutex lock;
+	std::unordered_map<std::string, Entry> entries;
+	//! Keys of the entries, most recently used first
+	std::list<const std::string *> lru;
+	//! Sum of the entries' bytes
+	size_t bytes_used = 0;
+	uint64_t local_clock = 0;
+	std::atomic<uint64_t> evictions {0};
+};
+
+//! Heap bytes of a property map: its nodes, buckets and the strings in them
+inline size_t MetastorePropertiesMemoryUsage(const MetastoreTableProperties &properties) {
+	// A node holds the pair, a next pointer and the cached hash
+	static constexpr size_t NODE_BYTES = sizeof(MetastoreTableProperties::value_type) + 2 * sizeof(void *);
+	size_t bytes = properties.bucket_count() * sizeof(void *);
+	for (auto &entry : properties) {
+		bytes += NODE_BYTES + MetastoreStringHeapBytes(entry.first) + MetastoreStringHeapBytes(entry.second);
+	}
+	return bytes;
+}
+
+//! MetastoreTtlCache storage of partition lists, kept as they are but charged for every string and vector
+struct MetastorePartitionListStorage : public MetastoreCachedValue<std::vector<MetastorePartitionValue>> {
+	size_t MemoryUsage(const std::vector<MetastorePartitionValue> &partitions) const {
+		size_t bytes = sizeof(partitions) + partitions.capacity() * sizeof(MetastorePartitionValue);
+		for (auto &partition : partitions) {
+			bytes += partition.values.capacity() * sizeof(std::string) + partition.null_values.capacity() / 8;
+			for (auto &value : partition.values) {
+				bytes += MetastoreStringHeapBytes(value);
+			}
+			bytes += MetastoreStringHeapBytes(partition.location);
+			bytes += MetastorePropertiesMemoryUsage(partition.parameters);
+		}
+		return bytes;
+	}
+};
+
+//! MetastoreTtlCache storage of name lists (e.g. partition names), charged for every string
+struct MetastoreNameListStorage : public MetastoreCachedValue<std::vector<std::string>> {
+	size_t MemoryUsage(const std::vector<std::string> &names) const {
+		size_t bytes = sizeof(names) + names.capacity() * sizeof(std::string);
+		for (auto &name : names) {
+			bytes += MetastoreStringHeapBytes(name);
+		}
+		return bytes;
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreCatalogCache — cached metadata of one attached catalog
+//
+// Tables are kept as MetastoreCompactTables whose repeated strings live in
+// the catalog's string pool. Partition lists are kept both as filtered
+// listings and as the descriptors fetched for a list of partition names,
+// next to the tables' partition name lists. With a budget, all of them
+// are charged to it.
+//===--------------------------------------------------------------------===//
+struct MetastoreCatalogCache {
+	using TableCache = MetastoreTtlCache<MetastoreTable, MetastoreCompactTableStorage>;
+	using PartitionCache = MetastoreTtlCache<std::vector<MetastorePartitionValue>, MetastorePartitionListStorage>;
+	using NameListCache = MetastoreTtlCache<std::vector<std::string>, MetastoreNameListStorage>;
+
+	explicit MetastoreCatalogCache(const MetastoreCacheOptions &options,
+	                               std::shared_ptr<MetastoreCacheBudget> budget = nullptr)
+	    : strings(std::make_shared<MetastoreStringPool>(budget)),
+	      tables(std::make_shared<TableCache>(options, MetastoreCompactTableStorage {strings}, budget)),
+	      partitions(std::make_shared<PartitionCache>(options, MetastorePartitionListStorage(), budget)),
+	      partition_names(std::make_shared<NameListCache>(options, MetastoreNameListStorage(), budget)) {
+		if (budget) {
+			budget->Register(tables);
+			budget->Register(partitions);
+			budget->Register(partition_names);
+		}
+	}
+
+	//! Bytes held by the cache: tables, pooled strings, partition lists and partition names
+	size_t MemoryUsage() {
+		return tables->MemoryUsage() + strings->MemoryUsage() + partitions->MemoryUsage() +
+		       partition_names->MemoryUsage();
+	}
+
+	std::shared_ptr<MetastoreStringPool> strings;
+	std::shared_ptr<TableCache> tables;
+	std::shared_ptr<PartitionCache> partitions;
+	//! Partition names of each table
+	std::shared_ptr<NameListCache> partition_names;
+};
+
+} // namespace duckdb
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "metastore_runtime.hpp"
+#include "duckdb.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace duckdb {
+
+enum class MetastorePrefetchState : uint8_t { Running = 0, Finished = 1, Failed = 2, Cancelled = 3, Skipped = 4 };
+
+const char *MetastorePrefetchStateToString(MetastorePrefetchState state);
+
+//===--------------------------------------------------------------------===//
+// MetastorePrefetchStatus — progress of one catalog's ATTACH-time prefetch
+//
+// Counters are updated by the background job and read concurrently by
+// metastore_prefetch_status(); they are individually consistent but a
+// snapshot may mix values from slightly different points in time.
+//===--------------------------------------------------------------------===//
+struct MetastorePrefetchStatus {
+	std::string catalog_name;
+	std::atomic<MetastorePrefetchState> state {MetastorePrefetchState::Running};
+	std::atomic<uint64_t> namespaces_total {0};
+	std::atomic<uint64_t> namespaces_done {0};
+	std::atomic<uint64_t> tables_total {0};
+	std::atomic<uint64_t> tables_loaded {0};
+	std::atomic<uint64_t> tables_failed {0};
+	//! Set on DETACH or re-ATTACH; the job stops before its next metastore call
+	std::atomic<bool> cancelled {false};
+	std::chrono::steady_clock::time_point started_at = std::chrono::steady_clock::now();
+	std::atomic<int64_t> elapsed_ms {-1};
+
+	void SetError(std::string message);
+	std::string GetError();
+
+private:
+	std::mutex error_lock;
+	std::string error;
+};
+
+//! Start loading the namespaces named by the catalog's PREFETCH option (all of them for 'ALL') into
+//! its metadata cache on the database's TaskScheduler, reporting into `catalog.prefetch`. Each task
+//! makes one metastore call and schedules the next, so the prefetch never holds a worker thread for
+//! long. Without worker threads the prefetch is skipped, never run inside ATTACH. Does nothing when
+//! the catalog has no prefetch status.
+void StartMetastorePrefetch(DatabaseInstance &db, std::shared_ptr<const MetastoreAttachedCatalog> catalog);
+
+} // namespace duckdb
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+#include "duckdb.hpp"
+#include "duckdb/main/client_context_state.hpp"
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//! Parts of a table a metastore scan binds from. Table properties (e.g. Spark's schema JSON) and the owner
+//! never shape the scan. The query-wide lookup fetches the same parts, so both decode the same fields.
+static constexpr MetastoreTableFields METASTORE_SCAN_TABLE_FIELDS =
+    MetastoreTableFields::Columns | MetastoreTableFields::PartitionKeys | MetastoreTableFields::SerdeParameters;
+
+//===--------------------------------------------------------------------===//
+// MetastoreQueryMetadataState — tables of the running query, fetched at once
+//
+// Replacement scans are invoked one table at a time while the binder walks
+// the query, which would turn a query over N metastore tables into N
+// sequential round trips. On the first metastore replacement scan of a
+// query this state re-parses the query text, collects every
+// catalog.schema.table reference that points at an attached metastore, and
+// resolves them with one bulk lookup per (catalog, schema). Later
+// replacement scans of the same query are served from here, and so are the
+// partitions a scan enumerated for a table referenced more than once. The
+// state is cleared when the query ends, so nothing outlives the statement.
+//===--------------------------------------------------------------------===//
+class MetastoreQueryMetadataState : public ClientContextState {
+public:
+	static constexpr const char *STATE_KEY = "metastore_query_metadata";
+
+	//! Look up a prefetched table. Resolves the current query's references on first use.
+	//! Returns nullopt if the table was not prefetched (or its lookup failed transiently).
+	std::optional<MetastoreResult<MetastoreTable>> Find(ClientContext &context, const std::string &catalog_name,
+	                                                    const std::string &schema_name, const std::string &table_name);
+
+	//! Partitions of a table that a scan earlier in the query resolved; nullptr if none did
+	const std::vector<MetastorePartitionValue> *FindPartitions(const std::string &catalog_name,
+	                                                           const std::string &schema_name,
+	                                                           const std::string &table_name) const;
+	//! Keep the partitions a scan resolved for the rest of the query; returns the kept list
+	const std::vector<MetastorePartitionValue> *AddPartitions(const std::string &catalog_name,
+	                                                          const std::string &schema_name,
+	                                                          const std::string &table_name,
+	                                                          std::vector<MetastorePartitionValue> partitions);
+
+	void QueryEnd() override;
+
+private:
+	void Resolve(ClientContext &context);
+
+	bool resolved = false;
+	//! Query text the prefetched tables belong to
+	std::string query;
+	std::unordered_map<std::string, MetastoreResult<MetastoreTable>> tables;
+	std::unordered_map<std::string, std::vector<MetastorePartitionValue>> partitions;
+};
+
+} // namespace duckdb
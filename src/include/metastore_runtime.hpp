@@ -1,13 +1,123 @@
 #pragma once
 
 #include "auth/metastore_secret_bridge.hpp"
+#include "metastore_cache_budget.hpp"
+#include "metastore_call_scope.hpp"
+#include "metastore_connector.hpp"
+#include "duckdb/storage/storage_extension.hpp"
 
-#include <optional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace duckdb {
 
-void RegisterMetastoreAttachConfig(const std::string &catalog_name, MetastoreConnectorConfig config);
-std::optional<MetastoreConnectorConfig> LookupMetastoreAttachConfig(const std::string &catalog_name);
+struct MetastoreCatalogCache;
+class MetastoreSharedCache;
+struct MetastorePrefetchStatus;
+
+//===--------------------------------------------------------------------===//
+// MetastoreAttachedCatalog — what the extension keeps for one attached catalog
+//
+// Built once at ATTACH and immutable afterwards. The connector stack (HMS
+// connector, single-flight coalescing, optional shared and per-process
+// metadata caches) is thread-safe and shared by every query against the
+// catalog, so they all use the same pooled connections, coalescing group,
+// caches and MAX_CONCURRENCY budget.
+//===--------------------------------------------------------------------===//
+struct MetastoreAttachedCatalog {
+	std::string name;
+	MetastoreConnectorConfig config;
+	//! Null for providers this build cannot serve
+	std::shared_ptr<IMetastoreConnector> connector;
+	//! Metadata cache inside the connector stack; null without CACHE_TTL
+	std::shared_ptr<MetastoreCatalogCache> cache;
+	//! Cache segment shared with other processes, below `cache`; null without SHARED_CACHE
+	std::shared_ptr<MetastoreSharedCache> shared_cache;
+	//! Progress of the ATTACH-time prefetch; null without PREFETCH
+	std::shared_ptr<MetastorePrefetchStatus> prefetch;
+	//! Catalog object that registered the entry; only its teardown removes the entry
+	const void *owner = nullptr;
+};
+
+//! Default of the metastore_cache_memory_limit setting
+static constexpr const char *METASTORE_CACHE_DEFAULT_MEMORY_LIMIT = "512MB";
+
+//===--------------------------------------------------------------------===//
+// MetastoreCatalogRegistry — attached metastore catalogs of one database
+//
+// Lives in the metastore StorageExtension of each DatabaseInstance, so
+// separate databases in one process never share catalogs. Lookups load an
+// atomic snapshot of the catalog map and never wait on writers; ATTACH and
+// DETACH copy the map under a mutex and publish the new snapshot.
+//
+// The metadata caches of all catalogs share one budget, limited by the
+// metastore_cache_memory_limit setting. While any catalog has a cache, the
+// budget's usage is reserved in the buffer pool under the EXTENSION tag,
+// so it counts against memory_limit and shows in duckdb_memory().
+//===--------------------------------------------------------------------===//
+class MetastoreCatalogRegistry : public StorageExtensionInfo {
+public:
+	MetastoreCatalogRegistry();
+
+	static MetastoreCatalogRegistry &Get(DatabaseInstance &db);
+	static MetastoreCatalogRegistry &Get(ClientContext &context);
+
+	//! Build the connector stack for `config` and publish it under `name`, replacing an earlier entry
+	std::shared_ptr<const MetastoreAttachedCatalog> Register(DatabaseInstance &db, const std::string &name,
+	                                                         MetastoreConnectorConfig config, const void *owner);
+	//! Remove `name` if it is still owned by `owner` (DETACH); cancels its prefetch
+	void Unregister(const std::string &name, const void *owner);
+	//! Nullptr if `name` is not attached as a metastore catalog
+	std::shared_ptr<const MetastoreAttachedCatalog> Find(const std::string &name) const;
+	std::vector<std::shared_ptr<const MetastoreAttachedCatalog>> GetAll() const;
+
+	//! Memory budget of the metadata caches of every catalog
+	MetastoreCacheBudget &CacheBudget() {
+		return *cache_budget;
+	}
+
+private:
+	using CatalogMap = case_insensitive_map_t<std::shared_ptr<const MetastoreAttachedCatalog>>;
+
+	std::shared_ptr<const CatalogMap> Snapshot() const;
+	void Publish(std::shared_ptr<const CatalogMap> map);
+
+	std::mutex write_lock;
+	std::shared_ptr<const CatalogMap> catalogs = std::make_shared<const CatalogMap>();
+	//! Caches may outlive the registry (a refresh in flight at shutdown), so they share ownership
+	std::shared_ptr<MetastoreCacheBudget> cache_budget;
+	//! The budget reports to the buffer pool; guarded by write_lock
+	bool reporting_cache_memory = false;
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreQueryCallScope — ties this thread's metastore calls to a query
+//
+// While the scope is open, metastore I/O made on behalf of `context` stops
+// as soon as the query is interrupted, or once metastore_rpc_timeout has
+// passed since the query's first metastore call. All scopes of one query
+// share that deadline.
+//===--------------------------------------------------------------------===//
+class MetastoreQueryCallScope {
+public:
+	explicit MetastoreQueryCallScope(ClientContext &context);
+
+private:
+	MetastoreCallScope scope;
+};
+
+//! Throw DuckDB's InterruptException if `error` means the query was interrupted
+void ThrowIfMetastoreCallInterrupted(const MetastoreError &error);
+
+//! One named counter reported by metastore_stats()
+struct MetastoreStatistic {
+	std::string name;
+	int64_t value;
+};
+
+//! Process-wide metastore call statistics (calls, retries, retry budget, added latency)
+std::vector<MetastoreStatistic> CollectMetastoreStatistics();
 
 }
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// MetastoreSharedCache — metadata cache segment shared by the processes
+// of a host
+//
+// A memory-mapped file holding serialized tables, partition lists and
+// partition names,
+// which every process attaching it reads and fills, so one process's
+// fetch serves the others. The file has a direct-mapped index of slots and
+// a ring of records:
+//
+//  - A record (key and serialized value) is appended to the ring at a
+//    position reserved with one atomic add, so writers never wait on each
+//    other. Newer records overwrite the oldest ones as the ring wraps.
+//  - A slot points at the latest record for the keys hashing to it and is
+//    guarded by a sequence lock: a writer makes the sequence odd, updates
+//    the slot and makes it even again. A writer finding it odd skips the
+//    update, since another process is publishing, unless the slot has been
+//    locked for so long that its writer must have died; then it takes the
+//    slot over. A process that opens the file while no other process maps
+//    it also unlocks any slot left locked.
+//  - Readers never lock. They read a slot between two loads of its
+//    sequence, copy the record out, and then check that no reservation has
+//    lapped it, and that it holds their key. A reader retries or misses;
+//    it never gets a torn value.
+//
+// Every record carries the wall-clock time it was stored. Readers pass
+// the age they accept, so processes need no coordination to expire
+// entries.
+//===--------------------------------------------------------------------===//
+class MetastoreSharedCache {
+public:
+	//! Map the cache file at `path`, creating it with a ring of `capacity_bytes` if it does not exist. An
+	//! existing file keeps the size it was created with.
+	static MetastoreResult<std::shared_ptr<MetastoreSharedCache>> Open(const std::string &path,
+	                                                                   size_t capacity_bytes);
+	~MetastoreSharedCache();
+
+	MetastoreSharedCache(const MetastoreSharedCache &) = delete;
+	MetastoreSharedCache &operator=(const MetastoreSharedCache &) = delete;
+
+	//! The table stored under `key` no more than `max_age_ms` ago; false if there is none
+	bool GetTable(const std::string &key, uint64_t max_age_ms, MetastoreTable &out);
+	void PutTable(const std::string &key, const MetastoreTable &table);
+	//! The partition list stored under `key` no more than `max_age_ms` ago; false if there is none
+	bool GetPartitions(const std::string &key, uint64_t max_age_ms, std::vector<MetastorePartitionValue> &out);
+	void PutPartitions(const std::string &key, const std::vector<MetastorePartitionValue> &partitions);
+	//! The name list (e.g. of a table's partitions) stored under `key` no more than `max_age_ms` ago
+	bool GetNames(const std::string &key, uint64_t max_age_ms, std::vector<std::string> &out);
+	void PutNames(const std::string &key, const std::vector<std::string> &names);
+
+	//! Lookups of this process served from the segment, and those that missed
+	uint64_t Hits() const {
+		return hits;
+	}
+	uint64_t Misses() const {
+		return misses;
+	}
+	//! Values this process stored in the segment
+	uint64_t Stores() const {
+		return stores;
+	}
+	const std::string &Path() const {
+		return path;
+	}
+
+private:
+	struct Header;
+	struct Slot;
+
+	MetastoreSharedCache(std::string path, int fd, char *mapping, size_t mapping_size);
+
+	//! Size of a cache file with `slot_count` slots and a ring of `ring_capacity` bytes
+	static size_t FileSize(uint32_t slot_count, uint64_t ring_capacity);
+
+	//! Copy the latest record for `key` (if fresh enough) into `payload`
+	bool Read(const std::string &key, uint64_t max_age_ms, std::string &payload);
+	void Write(const std::string &key, const std::string &payload);
+	void CopyFromRing(uint64_t position, char *target, size_t size) const;
+	void CopyToRing(uint64_t position, const char *source, size_t size);
+	//! Unlock the slots that writers which died mid-update left locked; only while nothing else maps the file
+	void UnlockAbandonedSlots();
+
+	std::string path;
+	//! Open for as long as the file is mapped, holding the shared lock that tells Open() it is in use
+	int fd;
+	char *mapping;
+	size_t mapping_size;
+	Header *header;
+	Slot *slots;
+	char *ring;
+
+	std::atomic<uint64_t> hits {0};
+	std::atomic<uint64_t> misses {0};
+	std::atomic<uint64_t> stores {0};
+};
+
+} // namespace duckdb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+#include "metastore_shared_cache.hpp"
+
+#include <memory>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// SharedCacheMetastoreConnector — serves GetTable / ListPartitions /
+// ListPartitionNames / GetPartitionsByNames from the host's
+// MetastoreSharedCache
+//
+// Sits below the per-process cache: a process missing its own cache looks
+// in the shared segment before asking the metastore, and stores what the
+// metastore returns there for the other processes. Entries are keyed by
+// the metastore endpoint, so catalogs attached to the same metastore under
+// different names share them. Only entries stored within max_age_ms are
+// used. Errors are never shared. Other operations are forwarded unchanged.
+//===--------------------------------------------------------------------===//
+class SharedCacheMetastoreConnector : public IMetastoreConnector {
+public:
+	SharedCacheMetastoreConnector(std::shared_ptr<IMetastoreConnector> inner,
+	                              std::shared_ptr<MetastoreSharedCache> shared_cache, const std::string &endpoint,
+	                              uint64_t max_age_ms);
+
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespaces() override;
+	MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) override;
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespacesMatching(const std::string &pattern) override;
+	MetastoreResult<std::vector<std::string>> ListTablesMatching(const std::string &namespace_name,
+	                                                             const std::string &pattern,
+	                                                             const std::string &table_type = "") override;
+	MetastoreResult<std::vector<MetastoreTableSummary>>
+	ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+	                   const std::vector<std::string> &table_types) override;
+	MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
+	                                         const std::string &table_name) override;
+	MetastoreResult<MetastoreTable> GetTableProjected(const std::string &namespace_name, const std::string &table_name,
+	                                                  MetastoreTableFields fields) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTables(const std::string &namespace_name,
+	                                                       const std::vector<std::string> &table_names) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTablesProjected(const std::string &namespace_name,
+	                                                                const std::vector<std::string> &table_names,
+	                                                                MetastoreTableFields fields) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	ListPartitions(const std::string &namespace_name, const std::string &table_name,
+	               const std::string &predicate = "") override;
+	MetastoreResult<std::vector<std::string>> ListPartitionNames(const std::string &namespace_name,
+	                                                             const std::string &table_name) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                     const std::vector<std::string> &partition_names) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+	                              const std::vector<std::string> &partition_names,
+	                              MetastorePartitionFields fields) override;
+	MetastoreResult<MetastoreTableProperties> GetTableStats(const std::string &namespace_name,
+	                                                        const std::string &table_name) override;
+
+private:
+	//! Shared cache key of a table; `fields` is All for the full table
+	std::string TableKey(const std::string &namespace_name, const std::string &table_name,
+	                     MetastoreTableFields fields) const;
+
+	std::shared_ptr<IMetastoreConnector> inner;
+	std::shared_ptr<MetastoreSharedCache> shared_cache;
+	//! Endpoint part of every key
+	std::string key_prefix;
+	uint64_t max_age_ms;
+};
+
+} // namespace duckdb
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "metastore_call_scope.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// MetastoreSingleFlight — coalesces concurrent identical calls
+//
+// The first caller for a key runs the function; callers arriving with the
+// same key while it is still running wait for it and receive a copy of its
+// result instead of issuing their own call. Nothing is kept once the call
+// finishes, so this only collapses concurrent work and never serves stale
+// results. A key must always be used with the same result type.
+//
+// Followers may belong to other queries than the leader. A follower that
+// passes `stopped` waits in bounded slices and checks its own call scope
+// between them: once its query is interrupted or past its deadline it
+// returns stopped() and leaves. The leader keeps running for the others.
+//===--------------------------------------------------------------------===//
+class MetastoreSingleFlight {
+public:
+	//! Longest a follower waits before checking its own call scope again
+	static constexpr int64_t FOLLOWER_CHECK_MS = 50;
+
+	template <typename T>
+	T Do(const std::string &key, const std::function<T()> &fn, const std::function<T()> &stopped = nullptr) {
+		std::shared_ptr<Flight> flight;
+		bool leader = false;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto &entry = flights[key];
+			if (!entry) {
+				entry = std::make_shared<Flight>();
+				leader = true;
+			}
+			flight = entry;
+		}
+
+		if (!leader) {
+			std::unique_lock<std::mutex> flight_guard(flight->lock);
+			while (!flight->done) {
+				if (!stopped) {
+					flight->cv.wait(flight_guard);
+					continue;
+				}
+				if (MetastoreCallScope::ShouldStop()) {
+					return stopped();
+				}
+				auto wake = std::chrono::steady_clock::now() + std::chrono::milliseconds(FOLLOWER_CHECK_MS);
+				if (auto &control = MetastoreCallScope::Current()) {
+					wake = std::min(wake, control->deadline);
+				}
+				flight->cv.wait_until(flight_guard, wake);
+			}
+			if (flight->error) {
+				std::rethrow_exception(flight->error);
+			}
+			return *std::static_pointer_cast<T>(flight->result);
+		}
+
+		std::shared_ptr<T> result;
+		std::exception_ptr error;
+		try {
+			result = std::make_shared<T>(fn());
+		} catch (...) {
+			error = std::current_exception();
+		}
+		{
+			// Callers arriving from now on start a new flight rather than joining a finished one
+			std::lock_guard<std::mutex> guard(lock);
+			flights.erase(key);
+		}
+		{
+			std::lock_guard<std::mutex> flight_guard(flight->lock);
+			flight->result = result;
+			flight->error = error;
+			flight->done = true;
+		}
+		flight->cv.notify_all();
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return *result;
+	}
+
+	//! Number of keys with a call currently in flight
+	size_t InFlightCount() {
+		std::lock_guard<std::mutex> guard(lock);
+		return flights.size();
+	}
+
+	//! Append one length-prefixed component to a key, so ("a/b", "c") and ("a", "b/c") never collide
+	static void AppendKeyPart(std::string &key, const std::string &part) {
+		key += std::to_string(part.size());
+		key += ':';
+		key += part;
+	}
+
+	//! Append the count and a 64-bit FNV-1a digest of `parts`, for keys over lists too long to spell out
+	//! (e.g. every partition name of a table)
+	static void AppendKeyDigest(std::string &key, const std::vector<std::string> &parts) {
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (auto &part : parts) {
+			// The length goes in first, so ["ab", "c"] and ["a", "bc"] hash apart
+			auto size = part.size();
+			for (size_t i = 0; i < sizeof(size); i++) {
+				hash = (hash ^ ((size >> (8 * i)) & 0xFF)) * 0x100000001b3ULL;
+			}
+			for (auto c : part) {
+				hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+			}
+		}
+		AppendKeyPart(key, std::to_string(parts.size()) + "/" + std::to_string(hash));
+	}
+
+private:
+	struct Flight {
+		std::mutex lock;
+		std::condition_variable cv;
+		bool done = false;
+		std::shared_ptr<void> result;
+		std::exception_ptr error;
+	};
+
+	std::mutex lock;
+	std::unordered_map<std::string, std::shared_ptr<Flight>> flights;
+};
+
+} // namespace duckdb
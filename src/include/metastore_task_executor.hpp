@@ -0,0 +1,51 @@
+#pragma once
+
+#include "metastore_task_runner.hpp"
+#include "duckdb.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace duckdb {
+
+//! Catalog-wide budget of threads running metastore work, shared by every query against one catalog.
+struct MetastoreConcurrencyLimit {
+	explicit MetastoreConcurrencyLimit(idx_t max_concurrency_p) : max_concurrency(max_concurrency_p) {
+	}
+
+	const idx_t max_concurrency;
+	std::atomic<idx_t> active {0};
+};
+
+//===--------------------------------------------------------------------===//
+// MetastoreTaskExecutor — IMetastoreTaskRunner on DuckDB's TaskScheduler
+//
+// Work items are pulled from a shared counter by the calling thread plus a
+// number of helper tasks scheduled on the database's TaskScheduler. Helpers
+// are bounded by the scheduler's thread count (SET threads) and by the
+// catalog's MAX_CONCURRENCY budget; when neither leaves room, everything
+// runs on the caller. The caller never blocks idle: it drains work items
+// itself and then executes any helper task no worker has picked up yet.
+//===--------------------------------------------------------------------===//
+class MetastoreTaskExecutor : public IMetastoreTaskRunner {
+public:
+	MetastoreTaskExecutor(DatabaseInstance &db, std::shared_ptr<MetastoreConcurrencyLimit> limit);
+
+	void RunAll(size_t count, const std::function<void(size_t)> &fn) override;
+
+private:
+	//! Reserve up to `wanted` helper slots from the catalog budget; returns the number granted
+	idx_t ReserveHelpers(idx_t wanted);
+
+	DatabaseInstance &db;
+	std::shared_ptr<MetastoreConcurrencyLimit> limit;
+};
+
+//! Run `job` on the database's TaskScheduler without waiting for it. Returns false, without running the
+//! job, when the database has no worker threads to run it on. Exceptions thrown by the job are
+//! swallowed: it is expected to be best-effort work such as a cache refresh. A long job should do a
+//! bounded piece of work and schedule the rest, so it never holds a worker for long.
+bool ScheduleMetastoreBackgroundTask(DatabaseInstance &db, std::function<void()> job);
+
+} // namespace duckdb
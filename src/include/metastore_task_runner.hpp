@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// IMetastoreTaskRunner — executes independent connector calls concurrently
+//
+// Connectors never start threads of their own. Operations that fan out
+// (partition batches, bulk GetTable, namespace crawls) go through the
+// runner installed on the connector. The extension installs a runner that
+// executes work as DuckDB TaskScheduler tasks, so metadata work shares the
+// worker pool sized by SET threads instead of competing with it.
+//===--------------------------------------------------------------------===//
+class IMetastoreTaskRunner {
+public:
+	virtual ~IMetastoreTaskRunner() = default;
+
+	//! Run fn(0) .. fn(count - 1) and return once all calls have finished.
+	//! Calls may run concurrently and in any order; fn must not throw.
+	virtual void RunAll(size_t count, const std::function<void(size_t)> &fn) = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// SerialMetastoreTaskRunner — runs everything on the calling thread
+//===--------------------------------------------------------------------===//
+class SerialMetastoreTaskRunner : public IMetastoreTaskRunner {
+public:
+	void RunAll(size_t count, const std::function<void(size_t)> &fn) override {
+		for (size_t i = 0; i < count; i++) {
+			fn(i);
+		}
+	}
+};
+
+} // namespace duckdb
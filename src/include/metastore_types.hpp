@@ -2,6 +2,7 @@
 
 #include "duckdb.hpp"
 
+#include <cctype>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -38,6 +39,46 @@ inline const char *MetastoreFormatToString(MetastoreFormat fmt) {
 
 using MetastoreTableProperties = std::unordered_map<std::string, std::string>;
 
+//===--------------------------------------------------------------------===//
+// MetastoreTableFields — parts of MetastoreTable a caller needs
+//
+// Identity (catalog, namespace, name), location and storage format are
+// always filled in; the parts below only when requested. Connectors may
+// skip unrequested parts while decoding, which is what makes a
+// location-only lookup of a table with thousands of columns cheap.
+//===--------------------------------------------------------------------===//
+enum class MetastoreTableFields : uint32_t {
+	Base = 0,
+	Columns = 1u << 0,
+	PartitionKeys = 1u << 1,
+	SerdeParameters = 1u << 2,
+	Properties = 1u << 3,
+	Owner = 1u << 4,
+	All = (1u << 5) - 1
+};
+
+constexpr MetastoreTableFields operator|(MetastoreTableFields a, MetastoreTableFields b) {
+	return static_cast<MetastoreTableFields>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+//! Whether `available` includes every part of `wanted`
+inline bool MetastoreTableHasFields(MetastoreTableFields available, MetastoreTableFields wanted) {
+	return (static_cast<uint32_t>(available) & static_cast<uint32_t>(wanted)) == static_cast<uint32_t>(wanted);
+}
+
+//===--------------------------------------------------------------------===//
+// MetastorePartitionFields — parts of MetastorePartitionValue a caller needs
+//
+// Values and location are always filled in; parameters (the partition's
+// statistics) only when requested. Connectors whose metastore supports it
+// ask the server for just these parts.
+//===--------------------------------------------------------------------===//
+enum class MetastorePartitionFields : uint32_t {
+	Base = 0,
+	Parameters = 1u << 0,
+	All = (1u << 1) - 1
+};
+
 struct MetastoreColumn {
 	std::string name;
 	std::string type;
@@ -70,7 +111,15 @@ struct MetastorePartitionSpec {
 struct MetastorePartitionValue {
 	//! Values in the same order as MetastorePartitionSpec::columns
 	std::vector<std::string> values;
+	//! Parallel to values; true where the metastore reported a NULL (default) partition value
+	std::vector<bool> null_values;
 	std::string location;
+	//! Partition parameters as reported by the metastore (e.g. numRows, totalSize)
+	MetastoreTableProperties parameters;
+
+	bool IsNull(size_t idx) const {
+		return idx < null_values.size() && null_values[idx];
+	}
 };
 
 struct MetastoreCatalog {
@@ -98,10 +147,76 @@ struct MetastoreTable {
 	MetastoreTableProperties properties;
 
 	std::optional<std::string> owner;
+	//! Parts that were fetched; the others are left empty
+	MetastoreTableFields fields = MetastoreTableFields::All;
 
 	bool IsPartitioned() const {
 		return partition_spec.IsPartitioned();
 	}
 };
 
+//! A table's name and type without the rest of its metadata, as table listings return it
+struct MetastoreTableSummary {
+	std::string namespace_name;
+	std::string name;
+	//! Metastore table type (e.g. "MANAGED_TABLE", "EXTERNAL_TABLE", "VIRTUAL_VIEW"); empty if unknown
+	std::string table_type;
+	std::optional<std::string> comment;
+};
+
+//===--------------------------------------------------------------------===//
+// Name patterns
+//
+// Listings take name patterns in the metastore's own syntax: `*` matches
+// any run of characters and `|` separates alternatives, compared without
+// regard to case ("sales_*|tmp"). An empty pattern matches every name.
+// Connectors push patterns down to the metastore where they can and match
+// them with MetastoreNameMatchesPattern otherwise.
+//===--------------------------------------------------------------------===//
+inline bool MetastoreNameMatchesAlternative(const std::string &name, const char *pattern, size_t pattern_size) {
+	size_t name_pos = 0;
+	size_t pattern_pos = 0;
+	// Position after the last `*` and the name position it was tried at, for backtracking
+	size_t star_pattern = std::string::npos;
+	size_t star_name = 0;
+	while (name_pos < name.size()) {
+		if (pattern_pos < pattern_size && pattern[pattern_pos] == '*') {
+			star_pattern = ++pattern_pos;
+			star_name = name_pos;
+		} else if (pattern_pos < pattern_size &&
+		           std::tolower(static_cast<unsigned char>(pattern[pattern_pos])) ==
+		               std::tolower(static_cast<unsigned char>(name[name_pos]))) {
+			pattern_pos++;
+			name_pos++;
+		} else if (star_pattern != std::string::npos) {
+			pattern_pos = star_pattern;
+			name_pos = ++star_name;
+		} else {
+			return false;
+		}
+	}
+	while (pattern_pos < pattern_size && pattern[pattern_pos] == '*') {
+		pattern_pos++;
+	}
+	return pattern_pos == pattern_size;
+}
+
+inline bool MetastoreNameMatchesPattern(const std::string &name, const std::string &pattern) {
+	if (pattern.empty()) {
+		return true;
+	}
+	size_t begin = 0;
+	while (true) {
+		auto end = pattern.find('|', begin);
+		auto size = (end == std::string::npos ? pattern.size() : end) - begin;
+		if (MetastoreNameMatchesAlternative(name, pattern.data() + begin, size)) {
+			return true;
+		}
+		if (end == std::string::npos) {
+			return false;
+		}
+		begin = end + 1;
+	}
+}
+
 } // namespace duckdb
@@ -0,0 +1,207 @@
+#include "metastore_caching_connector.hpp"
+#include "metastore_single_flight.hpp"
+
+namespace duckdb {
+
+static std::string TableCacheKey(const std::string &namespace_name, const std::string &table_name) {
+	std::string key;
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	return key;
+}
+
+//! Key of the descriptors fetched for `partition_names`. The '#' never starts a length prefix, so these
+//! keys never collide with those of ListPartitions.
+static std::string PartitionsByNamesCacheKey(const std::string &namespace_name, const std::string &table_name,
+                                             const std::vector<std::string> &partition_names,
+                                             MetastorePartitionFields fields) {
+	auto key = TableCacheKey(namespace_name, table_name) + "#";
+	MetastoreSingleFlight::AppendKeyPart(key, std::to_string(static_cast<uint32_t>(fields)));
+	MetastoreSingleFlight::AppendKeyDigest(key, partition_names);
+	return key;
+}
+
+CachingMetastoreConnector::CachingMetastoreConnector(std::shared_ptr<IMetastoreConnector> inner_p,
+                                                     std::shared_ptr<MetastoreCatalogCache> cache_p,
+                                                     MetastoreRefreshScheduler schedule_refresh_p)
+    : inner(std::move(inner_p)), cache(std::move(cache_p)), schedule_refresh(std::move(schedule_refresh_p)) {
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>> CachingMetastoreConnector::ListNamespaces() {
+	return inner->ListNamespaces();
+}
+
+MetastoreResult<std::vector<std::string>> CachingMetastoreConnector::ListTables(const std::string &namespace_name) {
+	return inner->ListTables(namespace_name);
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>>
+CachingMetastoreConnector::ListNamespacesMatching(const std::string &pattern) {
+	return inner->ListNamespacesMatching(pattern);
+}
+
+MetastoreResult<std::vector<std::string>>
+CachingMetastoreConnector::ListTablesMatching(const std::string &namespace_name, const std::string &pattern,
+                                              const std::string &table_type) {
+	return inner->ListTablesMatching(namespace_name, pattern, table_type);
+}
+
+MetastoreResult<std::vector<MetastoreTableSummary>>
+CachingMetastoreConnector::ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+                                              const std::vector<std::string> &table_types) {
+	return inner->ListTableSummaries(namespace_pattern, table_pattern, table_types);
+}
+
+MetastoreResult<MetastoreTable> CachingMetastoreConnector::GetTable(const std::string &namespace_name,
+                                                                    const std::string &table_name) {
+	auto connector = inner;
+	return cache->tables->Get(
+	    TableCacheKey(namespace_name, table_name),
+	    [connector, namespace_name, table_name]() { return connector->GetTable(namespace_name, table_name); },
+	    schedule_refresh);
+}
+
+MetastoreResult<MetastoreTable> CachingMetastoreConnector::GetTableProjected(const std::string &namespace_name,
+                                                                             const std::string &table_name,
+                                                                             MetastoreTableFields fields) {
+	if (fields == MetastoreTableFields::All) {
+		return GetTable(namespace_name, table_name);
+	}
+	// A cached full table serves every projection; otherwise the projection is cached on its own
+	auto connector = inner;
+	auto key = TableCacheKey(namespace_name, table_name);
+	MetastoreTable table;
+	auto full_loader = [connector, namespace_name, table_name]() {
+		return connector->GetTable(namespace_name, table_name);
+	};
+	if (cache->tables->Lookup(key, full_loader, schedule_refresh, table)) {
+		return MetastoreResult<MetastoreTable>::Success(std::move(table));
+	}
+	MetastoreSingleFlight::AppendKeyPart(key, std::to_string(static_cast<uint32_t>(fields)));
+	return cache->tables->Get(
+	    key,
+	    [connector, namespace_name, table_name, fields]() {
+		    return connector->GetTableProjected(namespace_name, table_name, fields);
+	    },
+	    schedule_refresh);
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+CachingMetastoreConnector::GetTables(const std::string &namespace_name, const std::vector<std::string> &table_names) {
+	return GetTablesProjected(namespace_name, table_names, MetastoreTableFields::All);
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+CachingMetastoreConnector::GetTablesProjected(const std::string &namespace_name,
+                                              const std::vector<std::string> &table_names,
+                                              MetastoreTableFields fields) {
+	// Serve what the cache has and fetch the rest in one bulk call. As in GetTableProjected, a cached full
+	// table serves any projection, and a projection is cached under its own key.
+	std::vector<MetastoreResult<MetastoreTable>> results(table_names.size());
+	std::vector<std::string> missing_names;
+	std::vector<size_t> missing_positions;
+	auto connector = inner;
+	auto projection_key = [&](const std::string &table_name) {
+		auto key = TableCacheKey(namespace_name, table_name);
+		if (fields != MetastoreTableFields::All) {
+			MetastoreSingleFlight::AppendKeyPart(key, std::to_string(static_cast<uint32_t>(fields)));
+		}
+		return key;
+	};
+	for (size_t i = 0; i < table_names.size(); i++) {
+		auto &table_name = table_names[i];
+		MetastoreTable table;
+		auto full_loader = [connector, namespace_name, table_name]() {
+			return connector->GetTable(namespace_name, table_name);
+		};
+		auto projected_loader = [connector, namespace_name, table_name, fields]() {
+			return connector->GetTableProjected(namespace_name, table_name, fields);
+		};
+		if (cache->tables->Lookup(TableCacheKey(namespace_name, table_name), full_loader, schedule_refresh, table) ||
+		    (fields != MetastoreTableFields::All &&
+		     cache->tables->Lookup(projection_key(table_name), projected_loader, schedule_refresh, table))) {
+			results[i] = MetastoreResult<MetastoreTable>::Success(std::move(table));
+		} else {
+			missing_names.push_back(table_name);
+			missing_positions.push_back(i);
+		}
+	}
+	if (missing_names.empty()) {
+		return results;
+	}
+	auto fetched = inner->GetTablesProjected(namespace_name, missing_names, fields);
+	for (size_t i = 0; i < fetched.size(); i++) {
+		auto key = projection_key(missing_names[i]);
+		MetastoreTable stale;
+		if (fetched[i].IsOk()) {
+			cache->tables->Put(key, fetched[i].value);
+		} else if (fetched[i].error.code == MetastoreErrorCode::Transient && cache->tables->GetStale(key, stale)) {
+			fetched[i] = MetastoreResult<MetastoreTable>::Success(std::move(stale));
+		}
+		results[missing_positions[i]] = std::move(fetched[i]);
+	}
+	return results;
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+CachingMetastoreConnector::ListPartitions(const std::string &namespace_name, const std::string &table_name,
+                                          const std::string &predicate) {
+	auto key = TableCacheKey(namespace_name, table_name);
+	MetastoreSingleFlight::AppendKeyPart(key, predicate);
+	auto connector = inner;
+	return cache->partitions->Get(
+	    key,
+	    [connector, namespace_name, table_name, predicate]() {
+		    return connector->ListPartitions(namespace_name, table_name, predicate);
+	    },
+	    schedule_refresh);
+}
+
+MetastoreResult<std::vector<std::string>>
+CachingMetastoreConnector::ListPartitionNames(const std::string &namespace_name, const std::string &table_name) {
+	auto connector = inner;
+	return cache->partition_names->Get(
+	    TableCacheKey(namespace_name, table_name),
+	    [connector, namespace_name, table_name]() { return connector->ListPartitionNames(namespace_name, table_name); },
+	    schedule_refresh);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+CachingMetastoreConnector::GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+                                                const std::vector<std::string> &partition_names) {
+	return GetPartitionsByNamesProjected(namespace_name, table_name, partition_names, MetastorePartitionFields::All);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+CachingMetastoreConnector::GetPartitionsByNamesProjected(const std::string &namespace_name,
+                                                         const std::string &table_name,
+                                                         const std::vector<std::string> &partition_names,
+                                                         MetastorePartitionFields fields) {
+	// The descriptors are cached per name list: the metastore may leave out names it does not know, so
+	// they cannot be told apart per name. A table whose name list changes is fetched again in full.
+	auto connector = inner;
+	auto names = std::make_shared<const std::vector<std::string>>(partition_names);
+	return cache->partitions->Get(
+	    PartitionsByNamesCacheKey(namespace_name, table_name, partition_names, fields),
+	    [connector, namespace_name, table_name, names, fields]() {
+		    if (fields == MetastorePartitionFields::All) {
+			    return connector->GetPartitionsByNames(namespace_name, table_name, *names);
+		    }
+		    return connector->GetPartitionsByNamesProjected(namespace_name, table_name, *names, fields);
+	    },
+	    schedule_refresh);
+}
+
+MetastoreResult<MetastoreTableProperties> CachingMetastoreConnector::GetTableStats(const std::string &namespace_name,
+                                                                                   const std::string &table_name) {
+	auto table_result = GetTableProjected(namespace_name, table_name, MetastoreTableFields::Properties);
+	if (!table_result.IsOk()) {
+		return MetastoreResult<MetastoreTableProperties>::Error(table_result.error.code,
+		                                                       std::move(table_result.error.message),
+		                                                       std::move(table_result.error.detail),
+		                                                       table_result.error.retryable);
+	}
+	return MetastoreResult<MetastoreTableProperties>::Success(std::move(table_result.value.properties));
+}
+
+} // namespace duckdb
@@ -0,0 +1,127 @@
+#include "metastore_coalescing_connector.hpp"
+#include "metastore_call_scope.hpp"
+
+namespace duckdb {
+
+//! Join the flight for `key`. The leader runs under its own query's call scope; if that query was
+//! interrupted, the shared result says so, which is not this caller's outcome, so it calls again itself.
+//! A follower whose own query stops first leaves with the error the I/O loop would have reported.
+template <typename T>
+static T DoCoalesced(MetastoreSingleFlight &group, const std::string &key, const std::function<T()> &fn) {
+	auto stopped = []() {
+		auto &control = MetastoreCallScope::Current();
+		if (control->IsCancelled()) {
+			return T::Error(MetastoreErrorCode::Cancelled, "Metastore call interrupted");
+		}
+		return T::Error(MetastoreErrorCode::Transient, "Metastore call deadline exceeded",
+		                "metastore_rpc_timeout elapsed", false);
+	};
+	auto result = group.Do<T>(key, fn, stopped);
+	if (result.error.code == MetastoreErrorCode::Cancelled && !MetastoreCallScope::ShouldStop()) {
+		return fn();
+	}
+	return result;
+}
+
+CoalescingMetastoreConnector::CoalescingMetastoreConnector(std::unique_ptr<IMetastoreConnector> inner_p,
+                                                           std::shared_ptr<MetastoreSingleFlight> group_p)
+    : inner(std::move(inner_p)), group(std::move(group_p)) {
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>> CoalescingMetastoreConnector::ListNamespaces() {
+	return inner->ListNamespaces();
+}
+
+MetastoreResult<std::vector<std::string>> CoalescingMetastoreConnector::ListTables(const std::string &namespace_name) {
+	std::string key = "list_tables/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	return DoCoalesced<MetastoreResult<std::vector<std::string>>>(
+	    *group, key, [&]() { return inner->ListTables(namespace_name); });
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>>
+CoalescingMetastoreConnector::ListNamespacesMatching(const std::string &pattern) {
+	return inner->ListNamespacesMatching(pattern);
+}
+
+MetastoreResult<std::vector<std::string>>
+CoalescingMetastoreConnector::ListTablesMatching(const std::string &namespace_name, const std::string &pattern,
+                                                 const std::string &table_type) {
+	return inner->ListTablesMatching(namespace_name, pattern, table_type);
+}
+
+MetastoreResult<std::vector<MetastoreTableSummary>>
+CoalescingMetastoreConnector::ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+                                                 const std::vector<std::string> &table_types) {
+	return inner->ListTableSummaries(namespace_pattern, table_pattern, table_types);
+}
+
+MetastoreResult<MetastoreTable> CoalescingMetastoreConnector::GetTable(const std::string &namespace_name,
+                                                                       const std::string &table_name) {
+	std::string key = "get_table/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	return DoCoalesced<MetastoreResult<MetastoreTable>>(*group, key,
+	                                                    [&]() { return inner->GetTable(namespace_name, table_name); });
+}
+
+MetastoreResult<MetastoreTable> CoalescingMetastoreConnector::GetTableProjected(const std::string &namespace_name,
+                                                                                const std::string &table_name,
+                                                                                MetastoreTableFields fields) {
+	std::string key = "get_table/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	MetastoreSingleFlight::AppendKeyPart(key, std::to_string(static_cast<uint32_t>(fields)));
+	return DoCoalesced<MetastoreResult<MetastoreTable>>(
+	    *group, key, [&]() { return inner->GetTableProjected(namespace_name, table_name, fields); });
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+CoalescingMetastoreConnector::GetTables(const std::string &namespace_name, const std::vector<std::string> &table_names) {
+	// Bulk lookups are already one batched request; they are not split up to join single flights
+	return inner->GetTables(namespace_name, table_names);
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+CoalescingMetastoreConnector::GetTablesProjected(const std::string &namespace_name,
+                                                 const std::vector<std::string> &table_names,
+                                                 MetastoreTableFields fields) {
+	return inner->GetTablesProjected(namespace_name, table_names, fields);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+CoalescingMetastoreConnector::ListPartitions(const std::string &namespace_name, const std::string &table_name,
+                                             const std::string &predicate) {
+	std::string key = "list_partitions/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	MetastoreSingleFlight::AppendKeyPart(key, predicate);
+	return DoCoalesced<MetastoreResult<std::vector<MetastorePartitionValue>>>(
+	    *group, key, [&]() { return inner->ListPartitions(namespace_name, table_name, predicate); });
+}
+
+MetastoreResult<std::vector<std::string>>
+CoalescingMetastoreConnector::ListPartitionNames(const std::string &namespace_name, const std::string &table_name) {
+	return inner->ListPartitionNames(namespace_name, table_name);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+CoalescingMetastoreConnector::GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+                                                   const std::vector<std::string> &partition_names) {
+	return inner->GetPartitionsByNames(namespace_name, table_name, partition_names);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+CoalescingMetastoreConnector::GetPartitionsByNamesProjected(const std::string &namespace_name,
+                                                            const std::string &table_name,
+                                                            const std::vector<std::string> &partition_names,
+                                                            MetastorePartitionFields fields) {
+	return inner->GetPartitionsByNamesProjected(namespace_name, table_name, partition_names, fields);
+}
+
+MetastoreResult<MetastoreTableProperties> CoalescingMetastoreConnector::GetTableStats(const std::string &namespace_name,
+                                                                                      const std::string &table_name) {
+	return inner->GetTableStats(namespace_name, table_name);
+}
+
+} // namespace duckdb
@@ -0,0 +1,265 @@
+#include "metastore_compact_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// MetastoreStringPool
+//===--------------------------------------------------------------------===//
+MetastoreStringPool::MetastoreStringPool(std::shared_ptr<MetastoreCacheBudget> budget_p) : budget(std::move(budget_p)) {
+}
+
+MetastoreStringPool::~MetastoreStringPool() {
+	if (budget) {
+		budget->Charge(-static_cast<int64_t>(string_bytes));
+	}
+}
+
+size_t MetastoreStringPool::EntryBytes(const Entry &entry) {
+	// An index node holds the key, the value pointer, a next pointer and the cached hash
+	static constexpr size_t INDEX_NODE_BYTES = sizeof(std::string_view) + 3 * sizeof(void *);
+	return sizeof(Entry) + MetastoreStringHeapBytes(entry.value) + INDEX_NODE_BYTES;
+}
+
+MetastoreStringPool::Handle MetastoreStringPool::Intern(std::string_view value) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto it = index.find(value);
+	if (it != index.end()) {
+		it->second->references++;
+		return it->second;
+	}
+	Entry *entry;
+	if (free_entries.empty()) {
+		entries.emplace_back();
+		entry = &entries.back();
+	} else {
+		entry = free_entries.back();
+		free_entries.pop_back();
+	}
+	entry->value.assign(value.data(), value.size());
+	entry->references = 1;
+	index.emplace(std::string_view(entry->value), entry);
+	auto bytes = EntryBytes(*entry);
+	string_bytes += bytes;
+	if (budget) {
+		budget->Charge(static_cast<int64_t>(bytes));
+	}
+	return entry;
+}
+
+void MetastoreStringPool::Release(Handle handle) {
+	std::lock_guard<std::mutex> guard(lock);
+	auto entry = const_cast<Entry *>(handle);
+	if (--entry->references > 0) {
+		return;
+	}
+	index.erase(std::string_view(entry->value));
+	auto bytes = EntryBytes(*entry);
+	string_bytes -= bytes;
+	if (budget) {
+		budget->Charge(-static_cast<int64_t>(bytes));
+	}
+	// Released entries are reused by later strings
+	std::string().swap(entry->value);
+	free_entries.push_back(entry);
+}
+
+size_t MetastoreStringPool::Size() {
+	std::lock_guard<std::mutex> guard(lock);
+	return index.size();
+}
+
+size_t MetastoreStringPool::MemoryUsage() {
+	std::lock_guard<std::mutex> guard(lock);
+	return sizeof(*this) + string_bytes + free_entries.size() * sizeof(Entry) +
+	       free_entries.capacity() * sizeof(Entry *) + index.bucket_count() * sizeof(void *);
+}
+
+//===--------------------------------------------------------------------===//
+// MetastoreCompactTable
+//===--------------------------------------------------------------------===//
+MetastoreCompactTable::MetastoreCompactTable(const MetastoreTable &table, std::shared_ptr<MetastoreStringPool> pool_p)
+    : pool(std::move(pool_p)) {
+	auto &descriptor = table.storage_descriptor;
+	column_count = static_cast<uint32_t>(descriptor.columns.size());
+	partition_key_count = static_cast<uint32_t>(table.partition_spec.columns.size());
+	serde_parameter_count = static_cast<uint32_t>(descriptor.serde_parameters.size());
+	property_count = static_cast<uint32_t>(table.properties.size());
+
+	size_t text_size = table.name.size() + descriptor.location.size();
+	for (auto &property : table.properties) {
+		text_size += property.second.size();
+	}
+	text_offset = static_cast<uint32_t>((column_count + partition_key_count) * sizeof(ColumnRef) +
+	                                    serde_parameter_count * sizeof(SerdeParameterRef) +
+	                                    property_count * sizeof(PropertyRef));
+	data_size = static_cast<uint32_t>(text_offset + text_size);
+	if (data_size > 0) {
+		data = std::unique_ptr<char[]>(new char[data_size]);
+	}
+	auto text_end = text_offset;
+	auto append_text = [&](const std::string &value) {
+		TextRef ref;
+		ref.offset = text_end;
+		ref.size = static_cast<uint32_t>(value.size());
+		if (!value.empty()) {
+			memcpy(data.get() + text_end, value.data(), value.size());
+		}
+		text_end += ref.size;
+		return ref;
+	};
+
+	catalog = pool->Intern(table.catalog);
+	namespace_name = pool->Intern(table.namespace_name);
+	name = append_text(table.name);
+	location = append_text(descriptor.location);
+	serde_class = InternOptional(descriptor.serde_class);
+	input_format = InternOptional(descriptor.input_format);
+	output_format = InternOptional(descriptor.output_format);
+	owner = InternOptional(table.owner);
+	format = descriptor.format;
+	fields = table.fields;
+
+	auto *columns = reinterpret_cast<ColumnRef *>(data.get());
+	for (auto &column : descriptor.columns) {
+		new (columns++) ColumnRef {pool->Intern(column.name), pool->Intern(column.type)};
+	}
+	for (auto &column : table.partition_spec.columns) {
+		new (columns++) ColumnRef {pool->Intern(column.name), pool->Intern(column.type)};
+	}
+
+	// Both maps are stored sorted by key, so lookups can binary-search them
+	std::vector<const std::pair<const std::string, std::string> *> sorted;
+	auto sort_by_key = [&](const MetastoreTableProperties &map) {
+		sorted.clear();
+		for (auto &entry : map) {
+			sorted.push_back(&entry);
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const std::pair<const std::string, std::string> *a,
+		                                           const std::pair<const std::string, std::string> *b) {
+			return a->first < b->first;
+		});
+	};
+	auto *serde_parameters = reinterpret_cast<SerdeParameterRef *>(columns);
+	sort_by_key(descriptor.serde_parameters);
+	for (auto *parameter : sorted) {
+		new (serde_parameters++) SerdeParameterRef {pool->Intern(parameter->first), pool->Intern(parameter->second)};
+	}
+	auto *properties = reinterpret_cast<PropertyRef *>(serde_parameters);
+	sort_by_key(table.properties);
+	for (auto *property : sorted) {
+		new (properties++) PropertyRef {pool->Intern(property->first), append_text(property->second)};
+	}
+}
+
+MetastoreCompactTable::~MetastoreCompactTable() {
+	for (auto handle : {catalog, namespace_name, serde_class, input_format, output_format, owner}) {
+		if (handle) {
+			pool->Release(handle);
+		}
+	}
+	auto *columns = Columns();
+	for (uint32_t i = 0; i < column_count + partition_key_count; i++) {
+		pool->Release(columns[i].name);
+		pool->Release(columns[i].type);
+	}
+	auto *serde_parameters = SerdeParameters();
+	for (uint32_t i = 0; i < serde_parameter_count; i++) {
+		pool->Release(serde_parameters[i].key);
+		pool->Release(serde_parameters[i].value);
+	}
+	auto *properties = Properties();
+	for (uint32_t i = 0; i < property_count; i++) {
+		pool->Release(properties[i].key);
+	}
+}
+
+MetastoreCompactTable::Handle MetastoreCompactTable::InternOptional(const std::optional<std::string> &value) {
+	return value ? pool->Intern(*value) : nullptr;
+}
+
+const MetastoreCompactTable::ColumnRef *MetastoreCompactTable::Columns() const {
+	return reinterpret_cast<const ColumnRef *>(data.get());
+}
+
+const MetastoreCompactTable::ColumnRef *MetastoreCompactTable::PartitionKeys() const {
+	return Columns() + column_count;
+}
+
+const MetastoreCompactTable::SerdeParameterRef *MetastoreCompactTable::SerdeParameters() const {
+	return reinterpret_cast<const SerdeParameterRef *>(PartitionKeys() + partition_key_count);
+}
+
+const MetastoreCompactTable::PropertyRef *MetastoreCompactTable::Properties() const {
+	return reinterpret_cast<const PropertyRef *>(SerdeParameters() + serde_parameter_count);
+}
+
+std::string_view MetastoreCompactTable::Text(TextRef ref) const {
+	return ref.size == 0 ? std::string_view() : std::string_view(data.get() + ref.offset, ref.size);
+}
+
+MetastoreTable MetastoreCompactTable::Expand() const {
+	auto optional_value = [](Handle handle) -> std::optional<std::string> {
+		if (!handle) {
+			return std::nullopt;
+		}
+		return handle->value;
+	};
+	MetastoreTable table;
+	table.catalog = catalog->value;
+	table.namespace_name = namespace_name->value;
+	table.name = std::string(Text(name));
+	table.owner = optional_value(owner);
+	table.fields = fields;
+
+	auto &descriptor = table.storage_descriptor;
+	descriptor.location = std::string(Text(location));
+	descriptor.format = format;
+	descriptor.serde_class = optional_value(serde_class);
+	descriptor.input_format = optional_value(input_format);
+	descriptor.output_format = optional_value(output_format);
+	descriptor.columns.reserve(column_count);
+	auto *columns = Columns();
+	for (uint32_t i = 0; i < column_count; i++) {
+		descriptor.columns.push_back(MetastoreColumn {columns[i].name->value, columns[i].type->value});
+	}
+	table.partition_spec.columns.reserve(partition_key_count);
+	auto *partition_keys = PartitionKeys();
+	for (uint32_t i = 0; i < partition_key_count; i++) {
+		table.partition_spec.columns.push_back(
+		    MetastorePartitionColumn {partition_keys[i].name->value, partition_keys[i].type->value});
+	}
+	descriptor.serde_parameters.reserve(serde_parameter_count);
+	auto *serde_parameters = SerdeParameters();
+	for (uint32_t i = 0; i < serde_parameter_count; i++) {
+		descriptor.serde_parameters.emplace(serde_parameters[i].key->value, serde_parameters[i].value->value);
+	}
+	table.properties.reserve(property_count);
+	auto *properties = Properties();
+	for (uint32_t i = 0; i < property_count; i++) {
+		table.properties.emplace(properties[i].key->value, std::string(Text(properties[i].value)));
+	}
+	return table;
+}
+
+std::optional<std::string_view> MetastoreCompactTable::FindProperty(std::string_view key) const {
+	auto *begin = Properties();
+	auto *end = begin + property_count;
+	auto it = std::lower_bound(begin, end, key, [](const PropertyRef &property, std::string_view wanted) {
+		return property.key->value < wanted;
+	});
+	if (it == end || it->key->value != key) {
+		return std::nullopt;
+	}
+	return Text(it->value);
+}
+
+size_t MetastoreCompactTable::MemoryUsage() const {
+	return sizeof(*this) + data_size;
+}
+
+} // namespace duckdb
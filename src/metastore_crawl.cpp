@@ -0,0 +1,205 @@
+#include "metastore_crawl.hpp"
+#include "metastore_hive_types.hpp"
+#include "metastore_runtime.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/parser/expression/cast_expression.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/parsed_data/create_schema_info.hpp"
+#include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+MetastoreError CrawlMetastore(IMetastoreConnector &connector, const std::string &namespace_pattern,
+                              const std::string &table_pattern, const MetastoreCrawlCallbacks &callbacks) {
+	auto namespaces = connector.ListNamespacesMatching(namespace_pattern);
+	if (!namespaces.IsOk()) {
+		return std::move(namespaces.error);
+	}
+	auto &runner = connector.GetTaskRunner();
+	std::mutex callback_lock;
+
+	// Table names of every namespace at once; a namespace that cannot be listed is reported and skipped
+	std::vector<std::vector<std::string>> table_names(namespaces.value.size());
+	runner.RunAll(namespaces.value.size(), [&](size_t ns_idx) {
+		auto &namespace_name = namespaces.value[ns_idx].name;
+		auto tables = connector.ListTablesMatching(namespace_name, table_pattern);
+		std::lock_guard<std::mutex> guard(callback_lock);
+		if (!tables.IsOk()) {
+			callbacks.on_namespace(namespace_name, 0, tables.error);
+			return;
+		}
+		table_names[ns_idx] = std::move(tables.value);
+		callbacks.on_namespace(namespace_name, table_names[ns_idx].size(), MetastoreError());
+	});
+
+	// Then metadata in batches across all namespaces, so one huge namespace is spread over the runner too
+	struct CrawlBatch {
+		size_t ns_idx;
+		size_t begin;
+		size_t end;
+	};
+	std::vector<CrawlBatch> batches;
+	for (size_t ns_idx = 0; ns_idx < table_names.size(); ns_idx++) {
+		auto count = table_names[ns_idx].size();
+		for (size_t begin = 0; begin < count; begin += METASTORE_CRAWL_BATCH_SIZE) {
+			batches.push_back(CrawlBatch {ns_idx, begin, MinValue(begin + METASTORE_CRAWL_BATCH_SIZE, count)});
+		}
+	}
+	runner.RunAll(batches.size(), [&](size_t batch_idx) {
+		auto &batch = batches[batch_idx];
+		auto &names = table_names[batch.ns_idx];
+		std::vector<std::string> batch_names(names.begin() + static_cast<std::ptrdiff_t>(batch.begin),
+		                                     names.begin() + static_cast<std::ptrdiff_t>(batch.end));
+		auto &namespace_name = namespaces.value[batch.ns_idx].name;
+		auto tables = connector.GetTables(namespace_name, batch_names);
+		std::lock_guard<std::mutex> guard(callback_lock);
+		callbacks.on_tables(namespace_name, tables);
+	});
+	return MetastoreError();
+}
+
+//! View over metastore_read() whose columns are the table's columns followed by its partition keys, cast
+//! to the DuckDB types of their metastore types so the view's declared types hold whatever the files say.
+//! The columns are those of the crawl; the view does not follow later changes to the table.
+static unique_ptr<CreateViewInfo> CreateMetastoreViewInfo(const std::string &catalog_name,
+                                                          const MetastoreTable &table) {
+	auto info = make_uniq<CreateViewInfo>(catalog_name, table.namespace_name, table.name);
+	auto node = make_uniq<SelectNode>();
+	auto add_column = [&](const std::string &name, const std::string &hive_type) {
+		auto type = MapHiveTypeToLogicalType(hive_type);
+		auto cast = make_uniq<CastExpression>(type, make_uniq<ColumnRefExpression>(name));
+		cast->alias = name;
+		node->select_list.push_back(std::move(cast));
+		info->names.push_back(name);
+		info->types.push_back(std::move(type));
+	};
+	for (auto &column : table.storage_descriptor.columns) {
+		add_column(column.name, column.type);
+	}
+	for (auto &column : table.partition_spec.columns) {
+		add_column(column.name, column.type);
+	}
+	if (node->select_list.empty()) {
+		// Without declared columns (e.g. some Delta or Iceberg tables) the view takes whatever the scan has
+		node->select_list.push_back(make_uniq<StarExpression>());
+	}
+	vector<unique_ptr<ParsedExpression>> arguments;
+	arguments.push_back(make_uniq<ConstantExpression>(Value(catalog_name)));
+	arguments.push_back(make_uniq<ConstantExpression>(Value(table.namespace_name)));
+	arguments.push_back(make_uniq<ConstantExpression>(Value(table.name)));
+	auto scan = make_uniq<TableFunctionRef>();
+	scan->function = make_uniq<FunctionExpression>("metastore_read", std::move(arguments));
+	node->from_table = std::move(scan);
+	info->query = make_uniq<SelectStatement>();
+	info->query->node = std::move(node);
+	info->on_conflict = OnCreateConflict::REPLACE_ON_CONFLICT;
+	auto comment = table.properties.find("comment");
+	if (comment != table.properties.end()) {
+		info->comment = Value(comment->second);
+	}
+	return info;
+}
+
+std::vector<MetastoreCrawlNamespaceResult> CrawlMetastoreIntoCatalog(ClientContext &context,
+                                                                     const std::string &catalog_name,
+                                                                     const std::string &namespace_pattern,
+                                                                     const std::string &table_pattern) {
+	auto attached = MetastoreCatalogRegistry::Get(context).Find(catalog_name);
+	if (!attached) {
+		throw InvalidInputException("Catalog is not attached as metastore: " + catalog_name);
+	}
+	if (!attached->connector) {
+		throw InvalidInputException("Only HMS provider is supported in this build");
+	}
+	// Entries are written by a connection of their own, one committed transaction per batch, so they
+	// do not wait for (or roll back with) the calling query
+	Connection connection(DatabaseInstance::GetDatabase(context));
+	auto &writer = *connection.context;
+	std::vector<MetastoreCrawlNamespaceResult> results;
+	std::unordered_map<std::string, size_t> result_index;
+	// Calls cut short by an interrupted query fail with Cancelled; the crawl reports that after it returns
+	MetastoreError cancelled;
+	auto record_error = [&](MetastoreCrawlNamespaceResult &result, const MetastoreError &error) {
+		if (error.code == MetastoreErrorCode::Cancelled) {
+			cancelled = error;
+		}
+		if (result.error.empty()) {
+			result.error = error.message;
+		}
+	};
+
+	MetastoreCrawlCallbacks callbacks;
+	callbacks.on_namespace = [&](const std::string &namespace_name, size_t table_count, const MetastoreError &error) {
+		result_index[namespace_name] = results.size();
+		results.emplace_back();
+		auto &result = results.back();
+		result.namespace_name = namespace_name;
+		result.columns_as_of = Timestamp::GetCurrentTimestamp();
+		if (!error.IsOk()) {
+			record_error(result, error);
+			return;
+		}
+		try {
+			writer.RunFunctionInTransaction([&]() {
+				CreateSchemaInfo info;
+				info.catalog = catalog_name;
+				info.schema = namespace_name;
+				info.on_conflict = OnCreateConflict::IGNORE_ON_CONFLICT;
+				Catalog::GetCatalog(writer, catalog_name).CreateSchema(writer, info);
+			});
+		} catch (std::exception &ex) {
+			ErrorData error_data(ex);
+			record_error(result, MetastoreError(MetastoreErrorCode::InvalidConfig, error_data.RawMessage()));
+		}
+	};
+	callbacks.on_tables = [&](const std::string &namespace_name, std::vector<MetastoreResult<MetastoreTable>> &tables) {
+		auto &result = results[result_index[namespace_name]];
+		std::vector<unique_ptr<CreateViewInfo>> views;
+		for (auto &table : tables) {
+			if (!table.IsOk()) {
+				result.tables_failed++;
+				record_error(result, table.error);
+				continue;
+			}
+			views.push_back(CreateMetastoreViewInfo(catalog_name, table.value));
+		}
+		if (views.empty()) {
+			return;
+		}
+		try {
+			writer.RunFunctionInTransaction([&]() {
+				auto &catalog = Catalog::GetCatalog(writer, catalog_name);
+				for (auto &view : views) {
+					catalog.CreateView(writer, *view);
+				}
+			});
+			result.views_created += views.size();
+		} catch (std::exception &ex) {
+			ErrorData error_data(ex);
+			result.tables_failed += views.size();
+			record_error(result, MetastoreError(MetastoreErrorCode::InvalidConfig, error_data.RawMessage()));
+		}
+	};
+
+	MetastoreQueryCallScope call_scope(context);
+	auto error = CrawlMetastore(*attached->connector, namespace_pattern, table_pattern, callbacks);
+	if (!error.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(error);
+		throw InvalidInputException("Failed to list namespaces of %s: %s", catalog_name, error.message);
+	}
+	ThrowIfMetastoreCallInterrupted(cancelled);
+	return results;
+}
+
+} // namespace duckdb
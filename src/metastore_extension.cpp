@@ -3,11 +3,12 @@
 #include "metastore_extension.hpp"
 #include "metastore_errors.hpp"
 #include "metastore_functions.hpp"
+#include "metastore_hive_types.hpp"
+#include "metastore_prefetch.hpp"
+#include "metastore_query_metadata.hpp"
 #include "metastore_runtime.hpp"
 #include "metastore_connector.hpp"
 #include "auth/metastore_secret_bridge.hpp"
-#include "hms/hms_config.hpp"
-#include "hms/hms_connector.hpp"
 #include "duckdb.hpp"
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/common/exception.hpp"
@@ -15,10 +16,14 @@
 #include "duckdb/catalog/duck_catalog.hpp"
 #include "duckdb/function/replacement_scan.hpp"
 #include "duckdb/main/config.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/parser.hpp"
 #include "duckdb/parser/expression/columnref_expression.hpp"
 #include "duckdb/parser/expression/comparison_expression.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
 #include "duckdb/transaction/duck_transaction_manager.hpp"
 #include <duckdb/storage/storage_extension.hpp>
@@ -28,52 +33,6 @@
 
 namespace duckdb {
 
-static string TrimTypeSuffix(string hive_type) {
-	auto pos = hive_type.find('(');
-	if (pos != string::npos) {
-		hive_type = hive_type.substr(0, pos);
-	}
-	return StringUtil::Lower(hive_type);
-}
-
-static string MapHiveTypeToDuckDB(const string &hive_type) {
-	auto normalized = TrimTypeSuffix(hive_type);
-	if (normalized == "tinyint") {
-		return "TINYINT";
-	}
-	if (normalized == "smallint") {
-		return "SMALLINT";
-	}
-	if (normalized == "int" || normalized == "integer") {
-		return "INTEGER";
-	}
-	if (normalized == "bigint") {
-		return "BIGINT";
-	}
-	if (normalized == "float") {
-		return "FLOAT";
-	}
-	if (normalized == "double") {
-		return "DOUBLE";
-	}
-	if (normalized == "boolean") {
-		return "BOOLEAN";
-	}
-	if (normalized == "date") {
-		return "DATE";
-	}
-	if (normalized == "timestamp") {
-		return "TIMESTAMP";
-	}
-	if (normalized == "string" || normalized == "varchar" || normalized == "char") {
-		return "VARCHAR";
-	}
-	if (normalized == "binary") {
-		return "BLOB";
-	}
-	return "VARCHAR";
-}
-
 static void AddNamedConstant(vector<unique_ptr<ParsedExpression>> &arguments, const string &name, Value value) {
 	auto named_arg = make_uniq<ComparisonExpression>(ExpressionType::COMPARE_EQUAL,
 	                                                 make_uniq<ColumnRefExpression>(name),
@@ -108,25 +67,177 @@ static string BuildScanPath(const string &raw_location, MetastoreFormat format)
 	return location;
 }
 
-static unique_ptr<TableRef> MetastoreReplacementScan(ClientContext &context, ReplacementScanInput &input,
-                                                     optional_ptr<ReplacementScanData> data) {
-	(void)data;
-	if (input.catalog_name.empty()) {
+//! Values and locations of every partition of a partitioned table. Partitions can live outside the
+//! table root, so their locations are fetched from the metastore rather than globbed. Returns an empty
+//! list if the table has no partitions or the connector cannot enumerate them.
+static vector<MetastorePartitionValue> ResolvePartitions(IMetastoreConnector &connector,
+                                                         const MetastoreTable &table) {
+	auto names_result = connector.ListPartitionNames(table.namespace_name, table.name);
+	ThrowIfMetastoreCallInterrupted(names_result.error);
+	if (!names_result.IsOk() || names_result.value.empty()) {
+		return {};
+	}
+	// Descriptors are fetched in batches over concurrent pooled connections; values and locations suffice
+	auto partitions_result = connector.GetPartitionsByNamesProjected(table.namespace_name, table.name,
+	                                                                 names_result.value, MetastorePartitionFields::Base);
+	if (!partitions_result.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(partitions_result.error);
+		throw BinderException("Failed to resolve partitions of HMS table %s.%s: %s", table.namespace_name, table.name,
+		                      partitions_result.error.message);
+	}
+	return std::move(partitions_result.value);
+}
+
+//! Whether a partition value reads back unchanged from a key=value directory name: Hive escapes
+//! anything else (e.g. ':' or '/') in the name
+static bool IsPlainPartitionValue(const string &value) {
+	if (value.empty()) {
+		return false;
+	}
+	for (auto c : value) {
+		if (!StringUtil::CharacterIsAlphaNumeric(c) && c != '-' && c != '_' && c != '.' && c != '+' && c != '@') {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Whether the partition's location ends in the key=value directories of its metastore values, so
+//! hive partitioning reads exactly those values back. NULL values and partitions registered at a
+//! custom location (e.g. .../2024/) do not.
+static bool HasHivePartitionLayout(const MetastoreTable &table, const MetastorePartitionValue &partition) {
+	auto &columns = table.partition_spec.columns;
+	if (partition.values.size() != columns.size()) {
+		return false;
+	}
+	string suffix;
+	for (idx_t i = 0; i < columns.size(); i++) {
+		if (partition.IsNull(i) || !IsPlainPartitionValue(partition.values[i])) {
+			return false;
+		}
+		suffix += "/" + columns[i].name + "=" + partition.values[i];
+	}
+	auto location = NormalizeHmsLocation(partition.location);
+	while (StringUtil::EndsWith(location, "/")) {
+		location.pop_back();
+	}
+	return StringUtil::EndsWith(location, suffix);
+}
+
+//! SQL call of the table's reader on `paths` with `options`
+static string ReaderCallSQL(const string &scan_function, const Value &paths,
+                            const vector<pair<string, Value>> &options) {
+	auto sql = scan_function + "(" + paths.ToSQLString();
+	for (auto &option : options) {
+		sql += ", " + option.first + " = " + option.second.ToSQLString();
+	}
+	return sql + ")";
+}
+
+//! `branches[begin, end)` combined by name, nested as a balanced tree so that thousands of them stay
+//! within the parser's depth limit
+static string UnionByNameSQL(const vector<string> &branches, idx_t begin, idx_t end) {
+	if (end - begin == 1) {
+		return branches[begin];
+	}
+	auto middle = begin + (end - begin) / 2;
+	return "(" + UnionByNameSQL(branches, begin, middle) + ") UNION ALL BY NAME (" +
+	       UnionByNameSQL(branches, middle, end) + ")";
+}
+
+//! Scan of the partitions of `table`, each with its partition key values as the metastore reports them.
+//! Partitions laid out as key=value directories are read in one call with hive partitioning; every other
+//! partition gets a call of its own with its values as constants, the calls combined by name.
+static unique_ptr<TableRef> BindPartitionedScan(ClientContext &context, const MetastoreTable &table,
+                                                const string &scan_function,
+                                                const vector<MetastorePartitionValue> &partitions,
+                                                const vector<pair<string, Value>> &reader_options) {
+	auto format = table.storage_descriptor.format;
+	auto &columns = table.partition_spec.columns;
+	vector<Value> hive_paths;
+	vector<pair<reference<const MetastorePartitionValue>, string>> custom_partitions;
+	for (auto &partition : partitions) {
+		auto path = BuildScanPath(partition.location, format);
+		if (path.empty()) {
+			continue;
+		}
+		if (HasHivePartitionLayout(table, partition)) {
+			hive_paths.emplace_back(std::move(path));
+		} else {
+			custom_partitions.emplace_back(partition, std::move(path));
+		}
+	}
+	if (hive_paths.empty() && custom_partitions.empty()) {
 		return nullptr;
 	}
-	auto config_opt = LookupMetastoreAttachConfig(input.catalog_name);
-	if (!config_opt.has_value() || config_opt->provider != MetastoreProviderType::HMS || input.schema_name.empty()) {
+	child_list_t<Value> hive_types;
+	for (auto &column : columns) {
+		hive_types.emplace_back(column.name, Value(MapHiveTypeToDuckDB(column.type)));
+	}
+	auto hive_options = reader_options;
+	hive_options.emplace_back("hive_partitioning", Value::BOOLEAN(true));
+	hive_options.emplace_back("hive_types", Value::STRUCT(std::move(hive_types)));
+	if (custom_partitions.empty()) {
+		// The common case stays a single reader call
+		vector<unique_ptr<ParsedExpression>> arguments;
+		arguments.push_back(make_uniq<ConstantExpression>(Value::LIST(LogicalType::VARCHAR, std::move(hive_paths))));
+		for (auto &option : hive_options) {
+			AddNamedConstant(arguments, option.first, option.second);
+		}
+		auto table_function = make_uniq<TableFunctionRef>();
+		table_function->function = make_uniq<FunctionExpression>(scan_function, std::move(arguments));
+		table_function->alias = table.name;
+		return std::move(table_function);
+	}
+
+	vector<string> branches;
+	if (!hive_paths.empty()) {
+		auto paths = Value::LIST(LogicalType::VARCHAR, std::move(hive_paths));
+		branches.push_back("SELECT * FROM " + ReaderCallSQL(scan_function, paths, hive_options));
+	}
+	auto custom_options = reader_options;
+	custom_options.emplace_back("hive_partitioning", Value::BOOLEAN(false));
+	for (auto &custom : custom_partitions) {
+		auto &partition = custom.first.get();
+		string select = "SELECT *";
+		for (idx_t i = 0; i < columns.size(); i++) {
+			auto value = i >= partition.values.size() || partition.IsNull(i) ? Value() : Value(partition.values[i]);
+			select += ", CAST(" + value.ToSQLString() + " AS " + MapHiveTypeToDuckDB(columns[i].type) + ") AS " +
+			          KeywordHelper::WriteOptionallyQuoted(columns[i].name);
+		}
+		branches.push_back(select + " FROM " + ReaderCallSQL(scan_function, Value(custom.second), custom_options));
+	}
+	Parser parser(context.GetParserOptions());
+	parser.ParseQuery(UnionByNameSQL(branches, 0, branches.size()));
+	auto select = unique_ptr_cast<SQLStatement, SelectStatement>(std::move(parser.statements[0]));
+	return make_uniq<SubqueryRef>(std::move(select), table.name);
+}
+
+//! Scan of metastore table `catalog_name`.`schema_name`.`table_name` with the reader of its storage
+//! format. Returns nullptr if the catalog is not a metastore catalog, or the table does not exist or
+//! has no location.
+static unique_ptr<TableRef> BindMetastoreTableScan(ClientContext &context, const string &catalog_name,
+                                                   const string &schema_name, const string &table_name) {
+	auto catalog = MetastoreCatalogRegistry::Get(context).Find(catalog_name);
+	if (!catalog || !catalog->connector || schema_name.empty()) {
 		return nullptr;
 	}
-	auto hms_config = ParseHmsEndpoint(config_opt->endpoint);
-	std::unique_ptr<IMetastoreConnector> connector = make_uniq<HmsConnector>(std::move(hms_config));
-	auto table_result = connector->GetTable(input.schema_name, input.table_name);
+	auto &connector = *catalog->connector;
+	MetastoreQueryCallScope call_scope(context);
+	// All metastore tables of the query are resolved together on the first replacement scan
+	auto query_state = context.registered_state->GetOrCreate<MetastoreQueryMetadataState>(
+	    MetastoreQueryMetadataState::STATE_KEY);
+	auto prefetched = query_state->Find(context, catalog_name, schema_name, table_name);
+	auto table_result = prefetched.has_value()
+	                        ? std::move(*prefetched)
+	                        : connector.GetTableProjected(schema_name, table_name, METASTORE_SCAN_TABLE_FIELDS);
 	if (!table_result.IsOk()) {
 		if (table_result.error.code == MetastoreErrorCode::NotFound) {
 			return nullptr;
 		}
-		throw BinderException("Failed to resolve HMS table %s.%s.%s: %s", input.catalog_name, input.schema_name,
-		                      input.table_name, table_result.error.message);
+		ThrowIfMetastoreCallInterrupted(table_result.error);
+		throw BinderException("Failed to resolve HMS table %s.%s.%s: %s", catalog_name, schema_name, table_name,
+		                      table_result.error.message);
 	}
 	if (table_result.value.storage_descriptor.location.empty()) {
 		return nullptr;
@@ -141,35 +252,97 @@ static unique_ptr<TableRef> MetastoreReplacementScan(ClientContext &context, Rep
 		scan_function = "read_parquet";
 		break;
 	default:
-		throw BinderException("Unsupported HMS table format for direct query: %s", input.table_name);
+		throw BinderException("Unsupported HMS table format for direct query: %s", table_name);
 	}
-	auto table_function = make_uniq<TableFunctionRef>();
-	vector<unique_ptr<ParsedExpression>> arguments;
-	arguments.push_back(make_uniq<ConstantExpression>(
-	    Value(BuildScanPath(table_result.value.storage_descriptor.location, table_result.value.storage_descriptor.format))));
+	vector<pair<string, Value>> reader_options;
 	if (table_result.value.storage_descriptor.format == MetastoreFormat::CSV) {
-		AddNamedConstant(arguments, "header", Value::BOOLEAN(false));
+		reader_options.emplace_back("header", Value::BOOLEAN(false));
 		auto serde_it = table_result.value.storage_descriptor.serde_parameters.find("field.delim");
 		if (serde_it == table_result.value.storage_descriptor.serde_parameters.end()) {
 			serde_it = table_result.value.storage_descriptor.serde_parameters.find("serialization.format");
 		}
 		if (serde_it != table_result.value.storage_descriptor.serde_parameters.end() && !serde_it->second.empty()) {
-			AddNamedConstant(arguments, "delim", Value(serde_it->second));
+			reader_options.emplace_back("delim", Value(serde_it->second));
 		}
 		if (!table_result.value.storage_descriptor.columns.empty()) {
 			child_list_t<Value> column_types;
 			for (auto &column : table_result.value.storage_descriptor.columns) {
 				column_types.emplace_back(column.name, Value(MapHiveTypeToDuckDB(column.type)));
 			}
-			AddNamedConstant(arguments, "columns", Value::STRUCT(std::move(column_types)));
-			AddNamedConstant(arguments, "auto_detect", Value::BOOLEAN(false));
+			reader_options.emplace_back("columns", Value::STRUCT(std::move(column_types)));
+			reader_options.emplace_back("auto_detect", Value::BOOLEAN(false));
+		}
+	}
+	if (table_result.value.IsPartitioned()) {
+		// Another reference to the table earlier in the query already enumerated its partitions
+		auto partitions = query_state->FindPartitions(catalog_name, schema_name, table_name);
+		if (!partitions) {
+			partitions = query_state->AddPartitions(catalog_name, schema_name, table_name,
+			                                        ResolvePartitions(connector, table_result.value));
+		}
+		auto scan = BindPartitionedScan(context, table_result.value, scan_function, *partitions, reader_options);
+		if (scan) {
+			return scan;
 		}
 	}
+	vector<unique_ptr<ParsedExpression>> arguments;
+	arguments.push_back(make_uniq<ConstantExpression>(Value(
+	    BuildScanPath(table_result.value.storage_descriptor.location, table_result.value.storage_descriptor.format))));
+	for (auto &option : reader_options) {
+		AddNamedConstant(arguments, option.first, option.second);
+	}
+	auto table_function = make_uniq<TableFunctionRef>();
 	table_function->function = make_uniq<FunctionExpression>(scan_function, std::move(arguments));
-	table_function->alias = input.table_name;
+	table_function->alias = table_name;
 	return std::move(table_function);
 }
 
+static unique_ptr<TableRef> MetastoreReplacementScan(ClientContext &context, ReplacementScanInput &input,
+                                                     optional_ptr<ReplacementScanData> data) {
+	(void)data;
+	if (input.catalog_name.empty()) {
+		return nullptr;
+	}
+	return BindMetastoreTableScan(context, input.catalog_name, input.schema_name, input.table_name);
+}
+
+//! metastore_read(catalog, schema, table): the replacement scan as a table function, which views created
+//! by metastore_crawl() read through so partitions and locations are resolved when the view is queried
+static unique_ptr<TableRef> MetastoreReadBindReplace(ClientContext &context, TableFunctionBindInput &input) {
+	for (idx_t i = 0; i < 3; i++) {
+		if (input.inputs[i].IsNull() || input.inputs[i].GetValue<string>().empty()) {
+			throw InvalidInputException("Argument " + to_string(i) + " cannot be NULL or empty");
+		}
+	}
+	auto catalog_name = input.inputs[0].GetValue<string>();
+	auto schema_name = input.inputs[1].GetValue<string>();
+	auto table_name = input.inputs[2].GetValue<string>();
+	auto scan = BindMetastoreTableScan(context, catalog_name, schema_name, table_name);
+	if (!scan) {
+		if (!MetastoreCatalogRegistry::Get(context).Find(catalog_name)) {
+			throw InvalidInputException("Catalog is not attached as metastore: " + catalog_name);
+		}
+		throw BinderException("HMS table %s.%s.%s not found or has no location", catalog_name, schema_name,
+		                      table_name);
+	}
+	return scan;
+}
+
+//! DuckCatalog that drops its metastore registry entry (connector, cache, prefetch) when it is detached
+class MetastoreCatalog : public DuckCatalog {
+public:
+	MetastoreCatalog(AttachedDatabase &db, MetastoreCatalogRegistry &registry_p, string name_p)
+	    : DuckCatalog(db), registry(registry_p), name(std::move(name_p)) {
+	}
+	~MetastoreCatalog() override {
+		registry.Unregister(name, this);
+	}
+
+private:
+	MetastoreCatalogRegistry &registry;
+	string name;
+};
+
 static unique_ptr<Catalog> MetastoreAttach(optional_ptr<StorageExtensionInfo> storage_info, ClientContext &context,
 	                                        AttachedDatabase &db, const string &name, AttachInfo &info,
 	                                        AttachOptions &attach_options) {
@@ -185,10 +358,14 @@ static unique_ptr<Catalog> MetastoreAttach(optional_ptr<StorageExtensionInfo> st
 	if (connector_config.provider != MetastoreProviderType::HMS) {
 		throw InvalidInputException("Only HMS provider is supported in this build");
 	}
-	RegisterMetastoreAttachConfig(name, std::move(connector_config));
 	info.path = ":memory:";
-	auto catalog = make_uniq<DuckCatalog>(db);
+	auto &registry = MetastoreCatalogRegistry::Get(context);
+	auto catalog = make_uniq<MetastoreCatalog>(db, registry, name);
 	catalog->Initialize(false);
+	auto &db_instance = DatabaseInstance::GetDatabase(context);
+	auto attached = registry.Register(db_instance, name, std::move(connector_config), catalog.get());
+	// Warms the metadata cache and connection pool in the background; ATTACH does not wait for it
+	StartMetastorePrefetch(db_instance, std::move(attached));
 	return std::move(catalog);
 }
 
@@ -202,9 +379,16 @@ static unique_ptr<StorageExtension> CreateMetastoreStorageExtension() {
 	auto storage_extension = make_uniq<StorageExtension>();
 	storage_extension->attach = MetastoreAttach;
 	storage_extension->create_transaction_manager = MetastoreCreateTransactionManager;
+	storage_extension->storage_info = make_shared_ptr<MetastoreCatalogRegistry>();
 	return storage_extension;
 }
 
+//! Applies metastore_cache_memory_limit to the shared budget of the database's metadata caches
+static void SetMetastoreCacheMemoryLimit(ClientContext &context, SetScope scope, Value &parameter) {
+	auto limit = DBConfig::ParseMemoryLimit(parameter.ToString());
+	MetastoreCatalogRegistry::Get(context).CacheBudget().SetLimit(limit);
+}
+
 static void LoadInternal(ExtensionLoader &loader) {
 	auto &db_instance = loader.GetDatabaseInstance();
 	auto &config = DBConfig::GetConfig(db_instance);
@@ -212,7 +396,20 @@ static void LoadInternal(ExtensionLoader &loader) {
 	config.replacement_scans.emplace_back(MetastoreReplacementScan);
 	config.AddExtensionOption("metastore_debug", "Enable diagnostic mode for metastore operations",
 	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption("metastore_rpc_timeout",
+	                          "Milliseconds a query may spend waiting on metastore calls, counted from its first "
+	                          "metastore call (0 = no limit)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("metastore_cache_memory_limit",
+	                          "Memory the metadata caches of all metastore catalogs may hold before least recently "
+	                          "used entries are evicted (e.g. '512MB', 'none' = no limit)",
+	                          LogicalType::VARCHAR, Value(METASTORE_CACHE_DEFAULT_MEMORY_LIMIT),
+	                          SetMetastoreCacheMemoryLimit);
 
+	TableFunction read_function("metastore_read", {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+	                            nullptr, nullptr);
+	read_function.bind_replace = MetastoreReadBindReplace;
+	loader.RegisterFunction(read_function);
 	RegisterMetastoreFunctions(loader);
 }
 
@@ -1,14 +1,55 @@
 #include "metastore_functions.hpp"
+#include "metastore_crawl.hpp"
+#include "metastore_hive_types.hpp"
+#include "metastore_metadata_cache.hpp"
+#include "metastore_prefetch.hpp"
 #include "metastore_runtime.hpp"
+#include "metastore_shared_cache.hpp"
 #include "metastore_connector.hpp"
-#include "hms/hms_config.hpp"
-#include "hms/hms_connector.hpp"
 #include "duckdb.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 
 namespace duckdb {
 
+static std::shared_ptr<IMetastoreConnector> GetCatalogConnector(ClientContext &context, const std::string &catalog,
+                                                                idx_t *max_concurrency = nullptr) {
+	auto attached = MetastoreCatalogRegistry::Get(context).Find(catalog);
+	if (!attached) {
+		throw InvalidInputException("Catalog is not attached as metastore: " + catalog);
+	}
+	if (!attached->connector) {
+		throw InvalidInputException("Only HMS provider is supported in this build");
+	}
+	if (max_concurrency) {
+		*max_concurrency = attached->config.max_concurrency;
+	}
+	return attached->connector;
+}
+
+static void ValidateNameArguments(const char *function_name, TableFunctionBindInput &input) {
+	// Validate argument count (3 required: catalog, schema, table_name)
+	if (input.inputs.size() < 3) {
+		throw BinderException("%s requires at least 3 arguments: catalog, schema, table_name", function_name);
+	}
+
+	// Validate that all 3 input arguments are non-empty strings
+	for (idx_t i = 0; i < 3; i++) {
+		if (input.inputs[i].IsNull()) {
+			throw InvalidInputException("Argument " + to_string(i) + " cannot be NULL");
+		}
+		string arg_val = input.inputs[i].GetValue<string>();
+		if (arg_val.empty()) {
+			throw InvalidInputException("Argument " + to_string(i) + " cannot be empty");
+		}
+	}
+}
+
 struct MetastoreScanBindData : public FunctionData {
 	std::string catalog;
 	std::string schema;
@@ -32,21 +73,7 @@ static unique_ptr<FunctionData> MetastoreScanBind(
 		ClientContext &context, TableFunctionBindInput &input,
 		vector<LogicalType> &return_types, vector<string> &names) {
 
-	// Validate argument count (3 required: catalog, schema, table_name)
-	if (input.inputs.size() < 3) {
-		throw BinderException("metastore_scan requires at least 3 arguments: catalog, schema, table_name");
-	}
-
-	// Validate that all 3 input arguments are non-empty strings
-	for (idx_t i = 0; i < 3; i++) {
-		if (input.inputs[i].IsNull()) {
-			throw InvalidInputException("Argument " + to_string(i) + " cannot be NULL");
-		}
-		string arg_val = input.inputs[i].GetValue<string>();
-		if (arg_val.empty()) {
-			throw InvalidInputException("Argument " + to_string(i) + " cannot be empty");
-		}
-	}
+	ValidateNameArguments("metastore_scan", input);
 
 	// Set return schema: 5 VARCHAR columns
 	return_types = {
@@ -92,17 +119,13 @@ static void MetastoreScanExecute(
 		return;
 	}
 	auto &bind_data = data.bind_data->Cast<MetastoreScanBindData>();
-	auto config_opt = LookupMetastoreAttachConfig(bind_data.catalog);
-	if (!config_opt.has_value()) {
-		throw InvalidInputException("Catalog is not attached as metastore: " + bind_data.catalog);
-	}
-	if (config_opt->provider != MetastoreProviderType::HMS) {
-		throw InvalidInputException("Only HMS provider is supported in this build");
-	}
-	auto hms_config = ParseHmsEndpoint(config_opt->endpoint);
-	std::unique_ptr<IMetastoreConnector> connector = make_uniq<HmsConnector>(std::move(hms_config));
-	auto table_result = connector->GetTable(bind_data.schema, bind_data.table_name);
+	auto connector = GetCatalogConnector(context, bind_data.catalog);
+	MetastoreQueryCallScope call_scope(context);
+	// Only the location and format are reported, so columns and properties are never decoded
+	auto table_result =
+	    connector->GetTableProjected(bind_data.schema, bind_data.table_name, MetastoreTableFields::Base);
 	if (!table_result.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(table_result.error);
 		throw InvalidInputException(table_result.error.message);
 	}
 	output.SetCardinality(1);
@@ -114,6 +137,569 @@ static void MetastoreScanExecute(
 	gstate.finished = true;
 }
 
+//===--------------------------------------------------------------------===//
+// metastore_partitions — partition metadata of a metastore table
+//
+// Emits one typed column per partition key, followed by the partition
+// location and the basic statistics HMS keeps in partition parameters.
+// Unfiltered listings fetch partition names once and then page through
+// full descriptors one vector at a time, so memory stays proportional to
+// the number of names rather than the size of all descriptors.
+//===--------------------------------------------------------------------===//
+static constexpr idx_t PARTITION_STAT_COUNT = 3;
+static const char *const PARTITION_STAT_KEYS[PARTITION_STAT_COUNT] = {"numRows", "numFiles", "totalSize"};
+static const char *const PARTITION_STAT_COLUMNS[PARTITION_STAT_COUNT] = {"num_rows", "num_files", "total_size"};
+
+struct MetastorePartitionsBindData : public FunctionData {
+	std::string catalog;
+	std::string schema;
+	std::string table_name;
+	//! Optional HMS filter expression (e.g. "dt >= '2024-01-01'"); empty lists all partitions
+	std::string filter;
+	//! DuckDB types of the partition key columns, in partition spec order
+	vector<LogicalType> key_types;
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto copy = make_uniq<MetastorePartitionsBindData>();
+		copy->catalog = catalog;
+		copy->schema = schema;
+		copy->table_name = table_name;
+		copy->filter = filter;
+		copy->key_types = key_types;
+		return std::move(copy);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<MetastorePartitionsBindData>();
+		return catalog == other.catalog && schema == other.schema && table_name == other.table_name &&
+		       filter == other.filter && key_types == other.key_types;
+	}
+};
+
+static unique_ptr<FunctionData> MetastorePartitionsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                        vector<LogicalType> &return_types, vector<string> &names) {
+	ValidateNameArguments("metastore_partitions", input);
+
+	auto bind_data = make_uniq<MetastorePartitionsBindData>();
+	bind_data->catalog = input.inputs[0].GetValue<string>();
+	bind_data->schema = input.inputs[1].GetValue<string>();
+	bind_data->table_name = input.inputs[2].GetValue<string>();
+	if (input.inputs.size() > 3 && !input.inputs[3].IsNull()) {
+		bind_data->filter = input.inputs[3].GetValue<string>();
+	}
+
+	// The output schema depends on the partition keys, so the table is resolved at bind time
+	auto connector = GetCatalogConnector(context, bind_data->catalog);
+	MetastoreQueryCallScope call_scope(context);
+	auto table_result =
+	    connector->GetTableProjected(bind_data->schema, bind_data->table_name, MetastoreTableFields::PartitionKeys);
+	if (!table_result.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(table_result.error);
+		throw InvalidInputException(table_result.error.message);
+	}
+	for (auto &column : table_result.value.partition_spec.columns) {
+		auto type = MapHiveTypeToLogicalType(column.type);
+		names.push_back(column.name);
+		return_types.push_back(type);
+		bind_data->key_types.push_back(std::move(type));
+	}
+	names.push_back("location");
+	return_types.push_back(LogicalType::VARCHAR);
+	for (idx_t i = 0; i < PARTITION_STAT_COUNT; i++) {
+		names.push_back(PARTITION_STAT_COLUMNS[i]);
+		return_types.push_back(LogicalType::BIGINT);
+	}
+	return std::move(bind_data);
+}
+
+struct MetastorePartitionsGlobalState : public GlobalTableFunctionState {
+	std::shared_ptr<IMetastoreConnector> connector;
+	//! Names of the partitions to emit, fetched in vector-sized batches (unfiltered listing)
+	std::vector<std::string> partition_names;
+	//! Partitions returned by a filtered listing, which HMS serves as a single reply
+	std::vector<MetastorePartitionValue> filtered_partitions;
+	bool filtered = false;
+	//! Number of vector-sized batches to emit
+	idx_t batch_count = 0;
+	//! Next batch to hand out to a scanning thread
+	std::atomic<idx_t> next_batch {0};
+	idx_t max_threads = 1;
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+};
+
+struct MetastorePartitionsLocalState : public LocalTableFunctionState {
+	//! Batch this thread is emitting; reported as the batch index so DuckDB can keep metastore order
+	idx_t batch_index = 0;
+};
+
+static unique_ptr<GlobalTableFunctionState> MetastorePartitionsInitGlobal(ClientContext &context,
+                                                                          TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<MetastorePartitionsBindData>();
+	auto gstate = make_uniq<MetastorePartitionsGlobalState>();
+	idx_t max_concurrency = 1;
+	gstate->connector = GetCatalogConnector(context, bind_data.catalog, &max_concurrency);
+	MetastoreQueryCallScope call_scope(context);
+	if (!bind_data.filter.empty()) {
+		auto partitions_result =
+		    gstate->connector->ListPartitions(bind_data.schema, bind_data.table_name, bind_data.filter);
+		if (!partitions_result.IsOk()) {
+			ThrowIfMetastoreCallInterrupted(partitions_result.error);
+			throw InvalidInputException("Failed to list partitions of %s.%s: %s", bind_data.schema,
+			                            bind_data.table_name, partitions_result.error.message);
+		}
+		gstate->filtered_partitions = std::move(partitions_result.value);
+		gstate->filtered = true;
+		gstate->batch_count = (gstate->filtered_partitions.size() + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+		return std::move(gstate);
+	}
+	auto names_result = gstate->connector->ListPartitionNames(bind_data.schema, bind_data.table_name);
+	if (!names_result.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(names_result.error);
+		throw InvalidInputException("Failed to list partitions of %s.%s: %s", bind_data.schema, bind_data.table_name,
+		                            names_result.error.message);
+	}
+	gstate->partition_names = std::move(names_result.value);
+	gstate->batch_count = (gstate->partition_names.size() + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	// Each thread fetches its own batches with get_partitions_by_names on its own pooled connection,
+	// bounded by the catalog's MAX_CONCURRENCY
+	gstate->max_threads = MaxValue<idx_t>(1, MinValue<idx_t>(gstate->batch_count, max_concurrency));
+	return std::move(gstate);
+}
+
+static unique_ptr<LocalTableFunctionState> MetastorePartitionsInitLocal(ExecutionContext &context,
+                                                                        TableFunctionInitInput &input,
+                                                                        GlobalTableFunctionState *global_state) {
+	return make_uniq<MetastorePartitionsLocalState>();
+}
+
+static bool TryParseStatistic(const MetastoreTableProperties &parameters, const char *key, int64_t &out) {
+	auto it = parameters.find(key);
+	if (it == parameters.end() || it->second.empty()) {
+		return false;
+	}
+	char *end = nullptr;
+	auto value = std::strtoll(it->second.c_str(), &end, 10);
+	// HMS reports -1 for statistics that were never computed
+	if (*end != '\0' || value < 0) {
+		return false;
+	}
+	out = value;
+	return true;
+}
+
+static void WritePartitionChunk(ClientContext &context, const MetastorePartitionsBindData &bind_data,
+                                const MetastorePartitionValue *partitions, idx_t count, DataChunk &output) {
+	auto key_count = bind_data.key_types.size();
+	for (idx_t key_idx = 0; key_idx < key_count; key_idx++) {
+		auto &target = output.data[key_idx];
+		// Non-VARCHAR keys are assembled as strings and cast as a whole vector
+		bool direct = bind_data.key_types[key_idx].id() == LogicalTypeId::VARCHAR;
+		Vector string_values(LogicalType::VARCHAR);
+		auto &strings = direct ? target : string_values;
+		auto string_data = FlatVector::GetData<string_t>(strings);
+		auto &validity = FlatVector::Validity(strings);
+		for (idx_t row = 0; row < count; row++) {
+			auto &partition = partitions[row];
+			if (key_idx >= partition.values.size() || partition.IsNull(key_idx)) {
+				validity.SetInvalid(row);
+				continue;
+			}
+			string_data[row] = StringVector::AddString(strings, partition.values[key_idx]);
+		}
+		if (!direct) {
+			// Values that do not fit the declared key type become NULL rather than failing the scan
+			string cast_error;
+			VectorOperations::TryCast(context, string_values, target, count, &cast_error);
+		}
+	}
+
+	auto &location_vector = output.data[key_count];
+	auto location_data = FlatVector::GetData<string_t>(location_vector);
+	for (idx_t row = 0; row < count; row++) {
+		location_data[row] = StringVector::AddString(location_vector, partitions[row].location);
+	}
+
+	for (idx_t stat_idx = 0; stat_idx < PARTITION_STAT_COUNT; stat_idx++) {
+		auto &stat_vector = output.data[key_count + 1 + stat_idx];
+		auto stat_data = FlatVector::GetData<int64_t>(stat_vector);
+		auto &stat_validity = FlatVector::Validity(stat_vector);
+		for (idx_t row = 0; row < count; row++) {
+			if (!TryParseStatistic(partitions[row].parameters, PARTITION_STAT_KEYS[stat_idx], stat_data[row])) {
+				stat_validity.SetInvalid(row);
+			}
+		}
+	}
+	output.SetCardinality(count);
+}
+
+static void MetastorePartitionsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<MetastorePartitionsBindData>();
+	auto &gstate = data.global_state->Cast<MetastorePartitionsGlobalState>();
+	auto &lstate = data.local_state->Cast<MetastorePartitionsLocalState>();
+
+	if (gstate.filtered) {
+		auto batch_idx = gstate.next_batch++;
+		if (batch_idx >= gstate.batch_count) {
+			output.SetCardinality(0);
+			return;
+		}
+		lstate.batch_index = batch_idx;
+		auto offset = batch_idx * STANDARD_VECTOR_SIZE;
+		auto count = MinValue<idx_t>(gstate.filtered_partitions.size() - offset, STANDARD_VECTOR_SIZE);
+		WritePartitionChunk(context, bind_data, gstate.filtered_partitions.data() + offset, count, output);
+		return;
+	}
+
+	// An empty chunk ends the scan, so batches whose partitions were all dropped since the listing are skipped
+	MetastoreQueryCallScope call_scope(context);
+	auto partitions_result =
+	    FetchPartitionBatch(*gstate.connector, bind_data.schema, bind_data.table_name, gstate.partition_names,
+	                        STANDARD_VECTOR_SIZE, gstate.next_batch, lstate.batch_index);
+	if (!partitions_result.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(partitions_result.error);
+		throw InvalidInputException("Failed to fetch partitions of %s.%s: %s", bind_data.schema, bind_data.table_name,
+		                            partitions_result.error.message);
+	}
+	auto &partitions = partitions_result.value;
+	WritePartitionChunk(context, bind_data, partitions.data(), partitions.size(), output);
+}
+
+static OperatorPartitionData MetastorePartitionsGetPartitionData(ClientContext &context,
+                                                                 TableFunctionGetPartitionInput &input) {
+	if (input.partition_info.RequiresPartitionColumns()) {
+		throw InternalException("metastore_partitions does not support partition columns");
+	}
+	auto &lstate = input.local_state->Cast<MetastorePartitionsLocalState>();
+	return OperatorPartitionData(lstate.batch_index);
+}
+
+//===--------------------------------------------------------------------===//
+// metastore_tables — tables of a metastore catalog matching name patterns
+//
+// Patterns use the metastore's syntax (`*` wildcard, `|` alternatives, no
+// regard to case) and are matched by the metastore, so listing a few
+// tables of a huge warehouse transfers only their names. The optional
+// table_type (e.g. 'EXTERNAL_TABLE', 'VIRTUAL_VIEW') is pushed down too.
+//===--------------------------------------------------------------------===//
+struct MetastoreTablesBindData : public FunctionData {
+	std::string catalog;
+	std::string schema_pattern;
+	std::string table_pattern;
+	std::string table_type;
+
+	unique_ptr<FunctionData> Copy() const override {
+		auto copy = make_uniq<MetastoreTablesBindData>();
+		copy->catalog = catalog;
+		copy->schema_pattern = schema_pattern;
+		copy->table_pattern = table_pattern;
+		copy->table_type = table_type;
+		return std::move(copy);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<MetastoreTablesBindData>();
+		return catalog == other.catalog && schema_pattern == other.schema_pattern &&
+		       table_pattern == other.table_pattern && table_type == other.table_type;
+	}
+};
+
+static unique_ptr<FunctionData> MetastoreTablesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.inputs[0].IsNull() || input.inputs[0].GetValue<string>().empty()) {
+		throw InvalidInputException("metastore_tables requires a catalog name");
+	}
+	auto bind_data = make_uniq<MetastoreTablesBindData>();
+	bind_data->catalog = input.inputs[0].GetValue<string>();
+	// NULL patterns match every name, like omitted ones
+	if (input.inputs.size() > 1 && !input.inputs[1].IsNull()) {
+		bind_data->schema_pattern = input.inputs[1].GetValue<string>();
+	}
+	if (input.inputs.size() > 2 && !input.inputs[2].IsNull()) {
+		bind_data->table_pattern = input.inputs[2].GetValue<string>();
+	}
+	auto table_type = input.named_parameters.find("table_type");
+	if (table_type != input.named_parameters.end() && !table_type->second.IsNull()) {
+		bind_data->table_type = table_type->second.GetValue<string>();
+	}
+
+	names = {"table_catalog", "table_schema", "table_name", "table_type", "comment"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR,
+	                LogicalType::VARCHAR};
+	return std::move(bind_data);
+}
+
+struct MetastoreTablesGlobalState : public GlobalTableFunctionState {
+	std::vector<MetastoreTableSummary> tables;
+	idx_t offset = 0;
+};
+
+static unique_ptr<GlobalTableFunctionState> MetastoreTablesInitGlobal(ClientContext &context,
+                                                                      TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<MetastoreTablesBindData>();
+	auto connector = GetCatalogConnector(context, bind_data.catalog);
+	MetastoreQueryCallScope call_scope(context);
+	std::vector<std::string> table_types;
+	if (!bind_data.table_type.empty()) {
+		table_types.push_back(bind_data.table_type);
+	}
+	auto tables_result = connector->ListTableSummaries(bind_data.schema_pattern, bind_data.table_pattern, table_types);
+	if (!tables_result.IsOk()) {
+		ThrowIfMetastoreCallInterrupted(tables_result.error);
+		throw InvalidInputException("Failed to list tables of %s: %s", bind_data.catalog,
+		                            tables_result.error.message);
+	}
+	auto gstate = make_uniq<MetastoreTablesGlobalState>();
+	gstate->tables = std::move(tables_result.value);
+	std::sort(gstate->tables.begin(), gstate->tables.end(),
+	          [](const MetastoreTableSummary &a, const MetastoreTableSummary &b) {
+		          return a.namespace_name != b.namespace_name ? a.namespace_name < b.namespace_name : a.name < b.name;
+	          });
+	return std::move(gstate);
+}
+
+static void MetastoreTablesExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<MetastoreTablesBindData>();
+	auto &gstate = data.global_state->Cast<MetastoreTablesGlobalState>();
+	idx_t count = 0;
+	while (gstate.offset < gstate.tables.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &table = gstate.tables[gstate.offset++];
+		output.SetValue(0, count, Value(bind_data.catalog));
+		output.SetValue(1, count, Value(table.namespace_name));
+		output.SetValue(2, count, Value(table.name));
+		output.SetValue(3, count, table.table_type.empty() ? Value(LogicalType::VARCHAR) : Value(table.table_type));
+		output.SetValue(4, count, table.comment.has_value() ? Value(*table.comment) : Value(LogicalType::VARCHAR));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// metastore_crawl — expose metastore tables as views of the attached catalog
+//
+// Takes the same patterns as metastore_tables and reports one row per
+// crawled namespace, with the time its views' column lists are from. See
+// CrawlMetastoreIntoCatalog.
+//===--------------------------------------------------------------------===//
+static unique_ptr<FunctionData> MetastoreCrawlBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.inputs[0].IsNull() || input.inputs[0].GetValue<string>().empty()) {
+		throw InvalidInputException("metastore_crawl requires a catalog name");
+	}
+	auto bind_data = make_uniq<MetastoreTablesBindData>();
+	bind_data->catalog = input.inputs[0].GetValue<string>();
+	if (input.inputs.size() > 1 && !input.inputs[1].IsNull()) {
+		bind_data->schema_pattern = input.inputs[1].GetValue<string>();
+	}
+	if (input.inputs.size() > 2 && !input.inputs[2].IsNull()) {
+		bind_data->table_pattern = input.inputs[2].GetValue<string>();
+	}
+	names = {"schema_name", "views_created", "tables_failed", "error", "columns_as_of"};
+	return_types = {LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::VARCHAR,
+	                LogicalType::TIMESTAMP_TZ};
+	return std::move(bind_data);
+}
+
+struct MetastoreCrawlGlobalState : public GlobalTableFunctionState {
+	std::vector<MetastoreCrawlNamespaceResult> results;
+	idx_t offset = 0;
+};
+
+static unique_ptr<GlobalTableFunctionState> MetastoreCrawlInitGlobal(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<MetastoreTablesBindData>();
+	auto gstate = make_uniq<MetastoreCrawlGlobalState>();
+	gstate->results =
+	    CrawlMetastoreIntoCatalog(context, bind_data.catalog, bind_data.schema_pattern, bind_data.table_pattern);
+	std::sort(gstate->results.begin(), gstate->results.end(),
+	          [](const MetastoreCrawlNamespaceResult &a, const MetastoreCrawlNamespaceResult &b) {
+		          return a.namespace_name < b.namespace_name;
+	          });
+	return std::move(gstate);
+}
+
+static void MetastoreCrawlExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &gstate = data.global_state->Cast<MetastoreCrawlGlobalState>();
+	idx_t count = 0;
+	while (gstate.offset < gstate.results.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &result = gstate.results[gstate.offset++];
+		output.SetValue(0, count, Value(result.namespace_name));
+		output.SetValue(1, count, Value::UBIGINT(result.views_created));
+		output.SetValue(2, count, Value::UBIGINT(result.tables_failed));
+		output.SetValue(3, count, result.error.empty() ? Value(LogicalType::VARCHAR) : Value(result.error));
+		output.SetValue(4, count, Value::TIMESTAMPTZ(timestamp_tz_t(result.columns_as_of)));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// metastore_prefetch_status — progress of ATTACH-time PREFETCH jobs
+//===--------------------------------------------------------------------===//
+static unique_ptr<FunctionData> MetastorePrefetchStatusBind(ClientContext &context, TableFunctionBindInput &input,
+                                                            vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"catalog_name",  "state",         "namespaces_total", "namespaces_done", "tables_total",
+	         "tables_loaded", "tables_failed", "elapsed_ms",       "error"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::UBIGINT,
+	                LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT,
+	                LogicalType::UBIGINT, LogicalType::BIGINT,  LogicalType::VARCHAR};
+	return make_uniq<TableFunctionData>();
+}
+
+struct MetastorePrefetchStatusGlobalState : public GlobalTableFunctionState {
+	std::vector<std::shared_ptr<MetastorePrefetchStatus>> statuses;
+	idx_t offset = 0;
+};
+
+static unique_ptr<GlobalTableFunctionState> MetastorePrefetchStatusInitGlobal(ClientContext &context,
+                                                                              TableFunctionInitInput &input) {
+	auto gstate = make_uniq<MetastorePrefetchStatusGlobalState>();
+	for (auto &catalog : MetastoreCatalogRegistry::Get(context).GetAll()) {
+		if (catalog->prefetch) {
+			gstate->statuses.push_back(catalog->prefetch);
+		}
+	}
+	std::sort(gstate->statuses.begin(), gstate->statuses.end(),
+	          [](const std::shared_ptr<MetastorePrefetchStatus> &a, const std::shared_ptr<MetastorePrefetchStatus> &b) {
+		          return a->catalog_name < b->catalog_name;
+	          });
+	return std::move(gstate);
+}
+
+static void MetastorePrefetchStatusExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &gstate = data.global_state->Cast<MetastorePrefetchStatusGlobalState>();
+	idx_t count = 0;
+	while (gstate.offset < gstate.statuses.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &status = *gstate.statuses[gstate.offset++];
+		auto state = status.state.load();
+		auto elapsed_ms = status.elapsed_ms.load();
+		if (state == MetastorePrefetchState::Running) {
+			auto elapsed = std::chrono::steady_clock::now() - status.started_at;
+			elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+		}
+		auto error = status.GetError();
+		output.SetValue(0, count, Value(status.catalog_name));
+		output.SetValue(1, count, Value(MetastorePrefetchStateToString(state)));
+		output.SetValue(2, count, Value::UBIGINT(status.namespaces_total));
+		output.SetValue(3, count, Value::UBIGINT(status.namespaces_done));
+		output.SetValue(4, count, Value::UBIGINT(status.tables_total));
+		output.SetValue(5, count, Value::UBIGINT(status.tables_loaded));
+		output.SetValue(6, count, Value::UBIGINT(status.tables_failed));
+		output.SetValue(7, count, Value::BIGINT(elapsed_ms));
+		output.SetValue(8, count, error.empty() ? Value(LogicalType::VARCHAR) : Value(error));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// metastore_cache_status — size of the metadata cache of each attached catalog
+//===--------------------------------------------------------------------===//
+static unique_ptr<FunctionData> MetastoreCacheStatusBind(ClientContext &context, TableFunctionBindInput &input,
+                                                         vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"catalog_name",      "cached_tables",   "table_bytes",            "pooled_strings",
+	         "string_pool_bytes", "bytes_per_table", "cached_partition_lists", "partition_bytes",
+	         "evictions",         "shared_hits",     "shared_misses",          "shared_stores"};
+	return_types = {LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT,
+	                LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT,
+	                LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT};
+	return make_uniq<TableFunctionData>();
+}
+
+struct MetastoreCacheStatusGlobalState : public GlobalTableFunctionState {
+	std::vector<std::shared_ptr<const MetastoreAttachedCatalog>> catalogs;
+	idx_t offset = 0;
+};
+
+static unique_ptr<GlobalTableFunctionState> MetastoreCacheStatusInitGlobal(ClientContext &context,
+                                                                           TableFunctionInitInput &input) {
+	auto gstate = make_uniq<MetastoreCacheStatusGlobalState>();
+	for (auto &catalog : MetastoreCatalogRegistry::Get(context).GetAll()) {
+		if (catalog->cache) {
+			gstate->catalogs.push_back(catalog);
+		}
+	}
+	std::sort(gstate->catalogs.begin(), gstate->catalogs.end(),
+	          [](const std::shared_ptr<const MetastoreAttachedCatalog> &a,
+	             const std::shared_ptr<const MetastoreAttachedCatalog> &b) { return a->name < b->name; });
+	return std::move(gstate);
+}
+
+static void MetastoreCacheStatusExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &gstate = data.global_state->Cast<MetastoreCacheStatusGlobalState>();
+	idx_t count = 0;
+	while (gstate.offset < gstate.catalogs.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &catalog = *gstate.catalogs[gstate.offset++];
+		auto &cache = *catalog.cache;
+		auto tables = cache.tables->Size();
+		auto table_bytes = cache.tables->MemoryUsage();
+		auto pool_bytes = cache.strings->MemoryUsage();
+		// The pool is shared by the cached tables, so each carries its share of it
+		auto bytes_per_table = tables == 0 ? 0 : (table_bytes + pool_bytes) / tables;
+		output.SetValue(0, count, Value(catalog.name));
+		output.SetValue(1, count, Value::UBIGINT(tables));
+		output.SetValue(2, count, Value::UBIGINT(table_bytes));
+		output.SetValue(3, count, Value::UBIGINT(cache.strings->Size()));
+		output.SetValue(4, count, Value::UBIGINT(pool_bytes));
+		output.SetValue(5, count, Value::UBIGINT(bytes_per_table));
+		// Partition name lists count as partition lists
+		output.SetValue(6, count, Value::UBIGINT(cache.partitions->Size() + cache.partition_names->Size()));
+		output.SetValue(7, count,
+		                Value::UBIGINT(cache.partitions->MemoryUsage() + cache.partition_names->MemoryUsage()));
+		output.SetValue(8, count,
+		                Value::UBIGINT(cache.tables->Evictions() + cache.partitions->Evictions() +
+		                               cache.partition_names->Evictions()));
+		// Lookups and stores of this process in the shared cache; NULL without SHARED_CACHE
+		if (catalog.shared_cache) {
+			output.SetValue(9, count, Value::UBIGINT(catalog.shared_cache->Hits()));
+			output.SetValue(10, count, Value::UBIGINT(catalog.shared_cache->Misses()));
+			output.SetValue(11, count, Value::UBIGINT(catalog.shared_cache->Stores()));
+		} else {
+			for (idx_t column = 9; column < 12; column++) {
+				output.SetValue(column, count, Value(LogicalType::UBIGINT));
+			}
+		}
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//===--------------------------------------------------------------------===//
+// metastore_stats — process-wide metastore call statistics
+//===--------------------------------------------------------------------===//
+static unique_ptr<FunctionData> MetastoreStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"name", "value"};
+	return_types = {LogicalType::VARCHAR, LogicalType::BIGINT};
+	return make_uniq<TableFunctionData>();
+}
+
+struct MetastoreStatsGlobalState : public GlobalTableFunctionState {
+	std::vector<MetastoreStatistic> statistics;
+	idx_t offset = 0;
+};
+
+static unique_ptr<GlobalTableFunctionState> MetastoreStatsInitGlobal(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+	auto gstate = make_uniq<MetastoreStatsGlobalState>();
+	gstate->statistics = CollectMetastoreStatistics();
+	return std::move(gstate);
+}
+
+static void MetastoreStatsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &gstate = data.global_state->Cast<MetastoreStatsGlobalState>();
+	idx_t count = 0;
+	while (gstate.offset < gstate.statistics.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &statistic = gstate.statistics[gstate.offset++];
+		output.SetValue(0, count, Value(statistic.name));
+		output.SetValue(1, count, Value::BIGINT(statistic.value));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
 void RegisterMetastoreFunctions(ExtensionLoader &loader) {
 	// Register metastore_scan table function
 	// Signature: metastore_scan(catalog VARCHAR, schema VARCHAR, table_name VARCHAR)
@@ -124,6 +710,53 @@ void RegisterMetastoreFunctions(ExtensionLoader &loader) {
 			MetastoreScanBind,
 			MetastoreScanInitGlobal
 	));
+
+	// Register metastore_partitions table function
+	// Signature: metastore_partitions(catalog VARCHAR, schema VARCHAR, table_name VARCHAR [, filter VARCHAR])
+	TableFunctionSet partitions_set("metastore_partitions");
+	vector<vector<LogicalType>> partitions_signatures = {
+	    {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+	    {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR}};
+	for (auto &arguments : partitions_signatures) {
+		TableFunction partitions_function(arguments, MetastorePartitionsExecute, MetastorePartitionsBind,
+		                                  MetastorePartitionsInitGlobal, MetastorePartitionsInitLocal);
+		partitions_function.get_partition_data = MetastorePartitionsGetPartitionData;
+		partitions_set.AddFunction(std::move(partitions_function));
+	}
+	loader.RegisterFunction(partitions_set);
+
+	// Signature: metastore_tables(catalog VARCHAR [, schema_pattern VARCHAR [, table_pattern VARCHAR]]
+	//                            [, table_type := VARCHAR])
+	TableFunctionSet tables_set("metastore_tables");
+	for (idx_t argument_count = 1; argument_count <= 3; argument_count++) {
+		vector<LogicalType> arguments(argument_count, LogicalType::VARCHAR);
+		TableFunction tables_function(arguments, MetastoreTablesExecute, MetastoreTablesBind,
+		                              MetastoreTablesInitGlobal);
+		tables_function.named_parameters["table_type"] = LogicalType::VARCHAR;
+		tables_set.AddFunction(std::move(tables_function));
+	}
+	loader.RegisterFunction(tables_set);
+
+	// Signature: metastore_crawl(catalog VARCHAR [, schema_pattern VARCHAR [, table_pattern VARCHAR]])
+	TableFunctionSet crawl_set("metastore_crawl");
+	for (idx_t argument_count = 1; argument_count <= 3; argument_count++) {
+		vector<LogicalType> arguments(argument_count, LogicalType::VARCHAR);
+		crawl_set.AddFunction(
+		    TableFunction(arguments, MetastoreCrawlExecute, MetastoreCrawlBind, MetastoreCrawlInitGlobal));
+	}
+	loader.RegisterFunction(crawl_set);
+
+	// Signature: metastore_prefetch_status()
+	loader.RegisterFunction(TableFunction("metastore_prefetch_status", {}, MetastorePrefetchStatusExecute,
+	                                      MetastorePrefetchStatusBind, MetastorePrefetchStatusInitGlobal));
+
+	// Signature: metastore_cache_status()
+	loader.RegisterFunction(TableFunction("metastore_cache_status", {}, MetastoreCacheStatusExecute,
+	                                      MetastoreCacheStatusBind, MetastoreCacheStatusInitGlobal));
+
+	// Signature: metastore_stats()
+	loader.RegisterFunction(
+	    TableFunction("metastore_stats", {}, MetastoreStatsExecute, MetastoreStatsBind, MetastoreStatsInitGlobal));
 }
 
 } // namespace duckdb
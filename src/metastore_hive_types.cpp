@@ -0,0 +1,57 @@
+#include "metastore_hive_types.hpp"
+
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+static string TrimTypeSuffix(string hive_type) {
+	auto pos = hive_type.find('(');
+	if (pos != string::npos) {
+		hive_type = hive_type.substr(0, pos);
+	}
+	return StringUtil::Lower(hive_type);
+}
+
+string MapHiveTypeToDuckDB(const string &hive_type) {
+	auto normalized = TrimTypeSuffix(hive_type);
+	if (normalized == "tinyint") {
+		return "TINYINT";
+	}
+	if (normalized == "smallint") {
+		return "SMALLINT";
+	}
+	if (normalized == "int" || normalized == "integer") {
+		return "INTEGER";
+	}
+	if (normalized == "bigint") {
+		return "BIGINT";
+	}
+	if (normalized == "float") {
+		return "FLOAT";
+	}
+	if (normalized == "double") {
+		return "DOUBLE";
+	}
+	if (normalized == "boolean") {
+		return "BOOLEAN";
+	}
+	if (normalized == "date") {
+		return "DATE";
+	}
+	if (normalized == "timestamp") {
+		return "TIMESTAMP";
+	}
+	if (normalized == "string" || normalized == "varchar" || normalized == "char") {
+		return "VARCHAR";
+	}
+	if (normalized == "binary") {
+		return "BLOB";
+	}
+	return "VARCHAR";
+}
+
+LogicalType MapHiveTypeToLogicalType(const string &hive_type) {
+	return TransformStringToLogicalType(MapHiveTypeToDuckDB(hive_type));
+}
+
+} // namespace duckdb
@@ -0,0 +1,176 @@
+#include "metastore_prefetch.hpp"
+#include "metastore_task_executor.hpp"
+
+namespace duckdb {
+
+//! Tables per bulk GetTables call; also the granularity of progress updates and cancellation
+static constexpr size_t PREFETCH_BATCH_SIZE = 64;
+
+const char *MetastorePrefetchStateToString(MetastorePrefetchState state) {
+	switch (state) {
+	case MetastorePrefetchState::Running:
+		return "running";
+	case MetastorePrefetchState::Finished:
+		return "finished";
+	case MetastorePrefetchState::Failed:
+		return "failed";
+	case MetastorePrefetchState::Cancelled:
+		return "cancelled";
+	case MetastorePrefetchState::Skipped:
+		return "skipped";
+	default:
+		return "unknown";
+	}
+}
+
+void MetastorePrefetchStatus::SetError(std::string message) {
+	std::lock_guard<std::mutex> guard(error_lock);
+	error = std::move(message);
+}
+
+std::string MetastorePrefetchStatus::GetError() {
+	std::lock_guard<std::mutex> guard(error_lock);
+	return error;
+}
+
+static void FinishPrefetch(MetastorePrefetchStatus &status, MetastorePrefetchState state) {
+	auto elapsed = std::chrono::steady_clock::now() - status.started_at;
+	status.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+	status.state = state;
+}
+
+//===--------------------------------------------------------------------===//
+// PrefetchJob — where one catalog's prefetch stands between its tasks
+//
+// A task makes one metastore call: listing the namespaces, listing one
+// namespace's tables or loading one batch of tables. It then schedules the
+// next task, so a worker thread is held for one call at a time and other
+// queries' tasks get in between.
+//===--------------------------------------------------------------------===//
+struct PrefetchJob {
+	PrefetchJob(DatabaseInstance &db_p, std::shared_ptr<const MetastoreAttachedCatalog> catalog_p)
+	    : db(db_p), catalog(std::move(catalog_p)) {
+	}
+
+	DatabaseInstance &db;
+	//! Held so a DETACH mid-prefetch only cancels it
+	std::shared_ptr<const MetastoreAttachedCatalog> catalog;
+	bool namespaces_listed = false;
+	std::vector<std::string> namespace_names;
+	size_t namespace_index = 0;
+	bool tables_listed = false;
+	std::vector<std::string> table_names;
+	size_t table_offset = 0;
+};
+
+static void NextNamespace(PrefetchJob &job, MetastorePrefetchStatus &status) {
+	status.namespaces_done++;
+	job.namespace_index++;
+	job.tables_listed = false;
+	job.table_names.clear();
+	job.table_offset = 0;
+}
+
+//! Make the job's next metastore call; returns whether there is more to do
+static bool RunPrefetchStep(PrefetchJob &job, MetastorePrefetchStatus &status) {
+	auto &config = job.catalog->config;
+	auto &connector = job.catalog->connector;
+	if (status.cancelled) {
+		FinishPrefetch(status, MetastorePrefetchState::Cancelled);
+		return false;
+	}
+	if (!job.namespaces_listed) {
+		job.namespaces_listed = true;
+		job.namespace_names = config.prefetch_namespaces;
+		if (config.prefetch_all) {
+			auto namespaces_result = connector->ListNamespaces();
+			if (!namespaces_result.IsOk()) {
+				status.SetError(namespaces_result.error.message);
+				FinishPrefetch(status, MetastorePrefetchState::Failed);
+				return false;
+			}
+			job.namespace_names.clear();
+			for (auto &ns : namespaces_result.value) {
+				job.namespace_names.push_back(ns.name);
+			}
+		}
+		status.namespaces_total = job.namespace_names.size();
+	} else if (!job.tables_listed) {
+		auto &namespace_name = job.namespace_names[job.namespace_index];
+		auto tables_result = connector->ListTables(namespace_name);
+		if (tables_result.IsOk()) {
+			job.tables_listed = true;
+			job.table_names = std::move(tables_result.value);
+			status.tables_total += job.table_names.size();
+			if (job.table_names.empty()) {
+				NextNamespace(job, status);
+			}
+		} else {
+			// One unreadable namespace should not stop the others from warming up
+			status.SetError(namespace_name + ": " + tables_result.error.message);
+			NextNamespace(job, status);
+		}
+	} else {
+		auto &namespace_name = job.namespace_names[job.namespace_index];
+		auto &table_names = job.table_names;
+		auto end = MinValue(job.table_offset + PREFETCH_BATCH_SIZE, table_names.size());
+		std::vector<std::string> batch(table_names.begin() + static_cast<std::ptrdiff_t>(job.table_offset),
+		                               table_names.begin() + static_cast<std::ptrdiff_t>(end));
+		job.table_offset = end;
+		// The caching connector stores every table it fetches
+		for (auto &result : connector->GetTables(namespace_name, batch)) {
+			if (result.IsOk()) {
+				status.tables_loaded++;
+			} else {
+				status.tables_failed++;
+				status.SetError(namespace_name + ": " + result.error.message);
+			}
+		}
+		if (job.table_offset == table_names.size()) {
+			NextNamespace(job, status);
+		}
+	}
+	if (job.namespace_index == job.namespace_names.size()) {
+		FinishPrefetch(status, MetastorePrefetchState::Finished);
+		return false;
+	}
+	return true;
+}
+
+static void SkipPrefetch(MetastorePrefetchStatus &status, const std::string &reason) {
+	status.SetError(reason);
+	FinishPrefetch(status, MetastorePrefetchState::Skipped);
+}
+
+//! Schedule the job's next step; false if there is no worker thread to run it on
+static bool SchedulePrefetchStep(std::shared_ptr<PrefetchJob> job) {
+	auto &db = job->db;
+	return ScheduleMetastoreBackgroundTask(db, [job]() {
+		auto &status = *job->catalog->prefetch;
+		bool more;
+		try {
+			more = RunPrefetchStep(*job, status);
+		} catch (std::exception &ex) {
+			status.SetError(ex.what());
+			FinishPrefetch(status, MetastorePrefetchState::Failed);
+			return;
+		}
+		if (more && !SchedulePrefetchStep(job)) {
+			// The threads setting was lowered to 1 while the prefetch ran
+			SkipPrefetch(status, "no worker threads left to continue the prefetch");
+		}
+	});
+}
+
+void StartMetastorePrefetch(DatabaseInstance &db, std::shared_ptr<const MetastoreAttachedCatalog> catalog) {
+	if (!catalog->prefetch || !catalog->connector) {
+		return;
+	}
+	auto status = catalog->prefetch;
+	// Running it inside ATTACH instead would block ATTACH for the whole crawl
+	if (!SchedulePrefetchStep(std::make_shared<PrefetchJob>(db, std::move(catalog)))) {
+		SkipPrefetch(*status, "PREFETCH runs on worker threads and the database has none (threads = 1)");
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,137 @@
+#include "metastore_query_metadata.hpp"
+#include "metastore_runtime.hpp"
+
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/query_node.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+
+#include <map>
+#include <set>
+
+namespace duckdb {
+
+static std::string TableKey(const std::string &catalog_name, const std::string &schema_name,
+                            const std::string &table_name) {
+	return StringUtil::Lower(catalog_name) + "." + StringUtil::Lower(schema_name) + "." + StringUtil::Lower(table_name);
+}
+
+static void CollectTableRefs(QueryNode &node, vector<reference<BaseTableRef>> &refs);
+
+static void CollectTableRefs(ParsedExpression &expr, vector<reference<BaseTableRef>> &refs) {
+	// EnumerateChildren does not descend into subquery bodies, so they are walked here
+	if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+		auto &subquery = expr.Cast<SubqueryExpression>();
+		CollectTableRefs(*subquery.subquery->node, refs);
+	}
+	ParsedExpressionIterator::EnumerateChildren(expr, [&](ParsedExpression &child) { CollectTableRefs(child, refs); });
+}
+
+static void CollectTableRefs(QueryNode &node, vector<reference<BaseTableRef>> &refs) {
+	for (auto &cte : node.cte_map.map) {
+		CollectTableRefs(*cte.second->query->node, refs);
+	}
+	ParsedExpressionIterator::EnumerateQueryNodeChildren(
+	    node, [&](unique_ptr<ParsedExpression> &child) { CollectTableRefs(*child, refs); },
+	    [&](TableRef &ref) {
+		    if (ref.type == TableReferenceType::BASE_TABLE) {
+			    refs.push_back(ref.Cast<BaseTableRef>());
+		    }
+	    });
+}
+
+void MetastoreQueryMetadataState::Resolve(ClientContext &context) {
+	resolved = true;
+	query = context.GetCurrentQuery();
+
+	Parser parser(context.GetParserOptions());
+	try {
+		parser.ParseQuery(query);
+	} catch (std::exception &) {
+		// Unparseable here (e.g. a statement another extension parses); fall back to per-table lookups
+		return;
+	}
+	vector<reference<BaseTableRef>> refs;
+	for (auto &statement : parser.statements) {
+		if (statement->type == StatementType::SELECT_STATEMENT) {
+			CollectTableRefs(*statement->Cast<SelectStatement>().node, refs);
+		}
+	}
+
+	// Group fully qualified references to attached metastores by (catalog, schema)
+	std::map<std::pair<std::string, std::string>, std::vector<std::string>> groups;
+	std::set<std::string> seen;
+	for (auto &ref_wrapper : refs) {
+		auto &ref = ref_wrapper.get();
+		if (ref.catalog_name.empty() || ref.schema_name.empty()) {
+			continue;
+		}
+		if (!seen.insert(TableKey(ref.catalog_name, ref.schema_name, ref.table_name)).second) {
+			continue;
+		}
+		groups[{ref.catalog_name, ref.schema_name}].push_back(ref.table_name);
+	}
+
+	for (auto &group : groups) {
+		auto &catalog_name = group.first.first;
+		auto &schema_name = group.first.second;
+		auto attached = MetastoreCatalogRegistry::Get(context).Find(catalog_name);
+		if (!attached || !attached->connector) {
+			continue;
+		}
+		auto &connector = attached->connector;
+		auto &table_names = group.second;
+		auto results = connector->GetTablesProjected(schema_name, table_names, METASTORE_SCAN_TABLE_FIELDS);
+		for (idx_t i = 0; i < results.size(); i++) {
+			auto &result = results[i];
+			// Only definitive answers are kept; transient failures are retried by the per-table lookup
+			if (result.IsOk() || result.error.code == MetastoreErrorCode::NotFound) {
+				tables.emplace(TableKey(catalog_name, schema_name, table_names[i]), std::move(result));
+			}
+		}
+	}
+}
+
+std::optional<MetastoreResult<MetastoreTable>> MetastoreQueryMetadataState::Find(ClientContext &context,
+                                                                                 const std::string &catalog_name,
+                                                                                 const std::string &schema_name,
+                                                                                 const std::string &table_name) {
+	if (!resolved || query != context.GetCurrentQuery()) {
+		tables.clear();
+		partitions.clear();
+		Resolve(context);
+	}
+	auto it = tables.find(TableKey(catalog_name, schema_name, table_name));
+	if (it == tables.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
+
+const std::vector<MetastorePartitionValue> *
+MetastoreQueryMetadataState::FindPartitions(const std::string &catalog_name, const std::string &schema_name,
+                                            const std::string &table_name) const {
+	auto it = partitions.find(TableKey(catalog_name, schema_name, table_name));
+	return it == partitions.end() ? nullptr : &it->second;
+}
+
+const std::vector<MetastorePartitionValue> *
+MetastoreQueryMetadataState::AddPartitions(const std::string &catalog_name, const std::string &schema_name,
+                                           const std::string &table_name,
+                                           std::vector<MetastorePartitionValue> table_partitions) {
+	auto &kept = partitions[TableKey(catalog_name, schema_name, table_name)];
+	kept = std::move(table_partitions);
+	return &kept;
+}
+
+void MetastoreQueryMetadataState::QueryEnd() {
+	resolved = false;
+	query.clear();
+	tables.clear();
+	partitions.clear();
+}
+
+} // namespace duckdb
@@ -1,29 +1,270 @@
 #include "metastore_runtime.hpp"
+#include "metastore_caching_connector.hpp"
+#include "metastore_coalescing_connector.hpp"
+#include "metastore_prefetch.hpp"
+#include "metastore_shared_cache_connector.hpp"
+#include "metastore_task_executor.hpp"
+#include "hms/hms_config.hpp"
+#include "hms/hms_connector.hpp"
 
-#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/storage/buffer/buffer_pool.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 
-#include <mutex>
-#include <optional>
-#include <string>
-#include <unordered_map>
+#include <algorithm>
 
 namespace duckdb {
 
-static std::mutex runtime_mutex;
-static std::unordered_map<std::string, MetastoreConnectorConfig> runtime_configs;
+//! How long past expiry cached metadata is served when the metastore cannot be reached
+static constexpr uint64_t METASTORE_STALE_IF_ERROR_MS = 60 * 60 * 1000;
 
-void RegisterMetastoreAttachConfig(const std::string &catalog_name, MetastoreConnectorConfig config) {
-	std::lock_guard<std::mutex> lock(runtime_mutex);
-	runtime_configs[StringUtil::Lower(catalog_name)] = std::move(config);
+//! Connector stack of one attached catalog: HMS connector, single-flight coalescing and, with a
+//! CACHE_TTL, the metadata cache whose hot entries are refreshed in the background (returned in `cache`),
+//! backed by the host's shared cache with SHARED_CACHE (returned in `shared_cache`)
+static std::shared_ptr<IMetastoreConnector>
+CreateCatalogConnectorStack(DatabaseInstance &db, const MetastoreConnectorConfig &config,
+                            std::shared_ptr<MetastoreCacheBudget> budget, std::shared_ptr<MetastoreCatalogCache> &cache,
+                            std::shared_ptr<MetastoreSharedCache> &shared_cache) {
+	if (config.provider != MetastoreProviderType::HMS) {
+		return nullptr;
+	}
+	auto hms_config = ParseHmsEndpoint(config.endpoint);
+	hms_config.max_inflight_requests = config.max_concurrency;
+	hms_config.retry.max_attempts = config.max_retries + 1;
+	hms_config.retry.initial_delay_ms = config.retry_backoff_ms;
+	hms_config.hedge_percentile = config.hedge_percentile;
+	hms_config.connection_timeout_ms = config.connect_timeout_ms;
+	hms_config.read_timeout_ms = config.read_timeout_ms;
+	hms_config.max_reply_bytes = static_cast<size_t>(config.max_reply_mb) << 20;
+	// Fan-out work runs on the database's TaskScheduler within the catalog's MAX_CONCURRENCY budget
+	auto limit = std::make_shared<MetastoreConcurrencyLimit>(MaxValue<idx_t>(config.max_concurrency, 1));
+	std::shared_ptr<IMetastoreTaskRunner> task_runner = std::make_shared<MetastoreTaskExecutor>(db, std::move(limit));
+
+	std::unique_ptr<IMetastoreConnector> hms_connector = make_uniq<HmsConnector>(std::move(hms_config));
+	hms_connector->SetTaskRunner(task_runner);
+	// Concurrent identical lookups against this catalog share one metastore request
+	std::shared_ptr<IMetastoreConnector> connector = std::make_shared<CoalescingMetastoreConnector>(
+	    std::move(hms_connector), std::make_shared<MetastoreSingleFlight>());
+	connector->SetTaskRunner(task_runner);
+	if (config.cache_ttl_ms == 0) {
+		return connector;
+	}
+
+	MetastoreCacheOptions options;
+	if (!config.shared_cache_path.empty()) {
+		auto opened =
+		    MetastoreSharedCache::Open(config.shared_cache_path, static_cast<size_t>(config.shared_cache_mb) << 20);
+		if (!opened.IsOk()) {
+			throw_metastore_error(opened.error.code, MetastoreErrorTag {"hms", "Attach", false},
+			                      opened.error.message);
+		}
+		shared_cache = std::move(opened.value);
+		// Shared entries are only taken while younger than the refresh-ahead margin, so a table this process
+		// caches from the segment is at most that much older than one it fetched itself
+		auto max_age_ms =
+		    static_cast<uint64_t>(static_cast<double>(config.cache_ttl_ms) * (1 - options.refresh_ahead_fraction));
+		connector = std::make_shared<SharedCacheMetastoreConnector>(std::move(connector), shared_cache,
+		                                                            config.endpoint, max_age_ms);
+		connector->SetTaskRunner(task_runner);
+	}
+	options.ttl_ms = config.cache_ttl_ms;
+	// A hot entry may be served for up to one extra TTL while its refresh is under way
+	options.max_stale_ms = config.cache_ttl_ms;
+	// While the metastore is down (or its circuit breaker is open) queries keep binding against cached metadata
+	options.stale_if_error_ms = METASTORE_STALE_IF_ERROR_MS;
+	MetastoreRefreshScheduler schedule_refresh = [&db](std::function<void()> job) {
+		if (!ScheduleMetastoreBackgroundTask(db, job)) {
+			// Without worker threads the query refreshes the entry itself: one metastore call, as on a miss
+			job();
+		}
+	};
+	cache = std::make_shared<MetastoreCatalogCache>(options, std::move(budget));
+	std::shared_ptr<IMetastoreConnector> caching_connector =
+	    std::make_shared<CachingMetastoreConnector>(std::move(connector), cache, std::move(schedule_refresh));
+	caching_connector->SetTaskRunner(std::move(task_runner));
+	return caching_connector;
+}
+
+MetastoreCatalogRegistry::MetastoreCatalogRegistry()
+    : cache_budget(
+          std::make_shared<MetastoreCacheBudget>(DBConfig::ParseMemoryLimit(METASTORE_CACHE_DEFAULT_MEMORY_LIMIT))) {
+}
+
+MetastoreCatalogRegistry &MetastoreCatalogRegistry::Get(DatabaseInstance &db) {
+	auto &storage_extensions = DBConfig::GetConfig(db).storage_extensions;
+	auto it = storage_extensions.find("metastore");
+	if (it == storage_extensions.end() || !it->second->storage_info) {
+		throw InternalException("metastore storage extension is not registered");
+	}
+	return static_cast<MetastoreCatalogRegistry &>(*it->second->storage_info);
+}
+
+MetastoreCatalogRegistry &MetastoreCatalogRegistry::Get(ClientContext &context) {
+	return Get(DatabaseInstance::GetDatabase(context));
+}
+
+std::shared_ptr<const MetastoreCatalogRegistry::CatalogMap> MetastoreCatalogRegistry::Snapshot() const {
+	return std::atomic_load(&catalogs);
+}
+
+void MetastoreCatalogRegistry::Publish(std::shared_ptr<const CatalogMap> map) {
+	std::atomic_store(&catalogs, std::move(map));
+}
+
+std::shared_ptr<const MetastoreAttachedCatalog> MetastoreCatalogRegistry::Register(DatabaseInstance &db,
+                                                                                   const std::string &name,
+                                                                                   MetastoreConnectorConfig config,
+                                                                                   const void *owner) {
+	auto entry = std::make_shared<MetastoreAttachedCatalog>();
+	entry->name = name;
+	entry->connector = CreateCatalogConnectorStack(db, config, cache_budget, entry->cache, entry->shared_cache);
+	if (entry->connector && config.HasPrefetch()) {
+		entry->prefetch = std::make_shared<MetastorePrefetchStatus>();
+		entry->prefetch->catalog_name = name;
+	}
+	entry->config = std::move(config);
+	entry->owner = owner;
+
+	std::shared_ptr<const MetastoreAttachedCatalog> replaced;
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+		auto map = std::make_shared<CatalogMap>(*Snapshot());
+		auto &slot = (*map)[name];
+		replaced = std::move(slot);
+		slot = entry;
+		Publish(std::move(map));
+		if (entry->cache && !reporting_cache_memory) {
+			// Released (resized to zero) when the last cached catalog is detached, which happens before
+			// the database tears down its buffer pool
+			auto reservation = std::make_shared<TempBufferPoolReservation>(
+			    MemoryTag::EXTENSION, BufferManager::GetBufferManager(db).GetBufferPool(), 0);
+			cache_budget->SetReporter([reservation](size_t used_bytes) { reservation->Resize(used_bytes); });
+			reporting_cache_memory = true;
+		}
+	}
+	if (replaced && replaced->prefetch) {
+		// Its prefetch would only warm a cache nobody reads any more
+		replaced->prefetch->cancelled = true;
+	}
+	return entry;
+}
+
+void MetastoreCatalogRegistry::Unregister(const std::string &name, const void *owner) {
+	std::shared_ptr<const MetastoreAttachedCatalog> removed;
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+		auto current = Snapshot();
+		auto it = current->find(name);
+		// ATTACH OR REPLACE registers the new catalog before the old one is destroyed
+		if (it == current->end() || it->second->owner != owner) {
+			return;
+		}
+		removed = it->second;
+		auto map = std::make_shared<CatalogMap>(*current);
+		map->erase(name);
+		auto caches_left = std::any_of(map->begin(), map->end(), [](const CatalogMap::value_type &entry) {
+			return entry.second->cache != nullptr;
+		});
+		Publish(std::move(map));
+		if (reporting_cache_memory && !caches_left) {
+			cache_budget->SetReporter(nullptr);
+			reporting_cache_memory = false;
+		}
+	}
+	if (removed->prefetch) {
+		removed->prefetch->cancelled = true;
+	}
 }
 
-std::optional<MetastoreConnectorConfig> LookupMetastoreAttachConfig(const std::string &catalog_name) {
-	std::lock_guard<std::mutex> lock(runtime_mutex);
-	auto it = runtime_configs.find(StringUtil::Lower(catalog_name));
-	if (it == runtime_configs.end()) {
-		return std::nullopt;
+std::shared_ptr<const MetastoreAttachedCatalog> MetastoreCatalogRegistry::Find(const std::string &name) const {
+	auto current = Snapshot();
+	auto it = current->find(name);
+	if (it == current->end()) {
+		return nullptr;
 	}
 	return it->second;
 }
 
+std::vector<std::shared_ptr<const MetastoreAttachedCatalog>> MetastoreCatalogRegistry::GetAll() const {
+	auto current = Snapshot();
+	std::vector<std::shared_ptr<const MetastoreAttachedCatalog>> result;
+	result.reserve(current->size());
+	for (auto &entry : *current) {
+		result.push_back(entry.second);
+	}
+	return result;
+}
+
+namespace {
+
+//! Call control of the running query, created on its first metastore call
+class MetastoreCallControlState : public ClientContextState {
+public:
+	static constexpr const char *STATE_KEY = "metastore_call_control";
+
+	std::shared_ptr<const MetastoreCallControl> Get(ClientContext &context) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (control) {
+			return control;
+		}
+		auto created = std::make_shared<MetastoreCallControl>();
+		auto *client = &context;
+		created->is_cancelled = [client]() { return client->interrupted.load(); };
+		Value timeout;
+		if (context.TryGetCurrentSetting("metastore_rpc_timeout", timeout) && !timeout.IsNull()) {
+			auto timeout_ms = timeout.GetValue<uint64_t>();
+			if (timeout_ms > 0) {
+				created->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+			}
+		}
+		control = std::move(created);
+		return control;
+	}
+
+	void QueryEnd() override {
+		std::lock_guard<std::mutex> guard(lock);
+		control.reset();
+	}
+
+private:
+	std::mutex lock;
+	std::shared_ptr<const MetastoreCallControl> control;
+};
+
+} // namespace
+
+static std::shared_ptr<const MetastoreCallControl> GetQueryCallControl(ClientContext &context) {
+	auto state =
+	    context.registered_state->GetOrCreate<MetastoreCallControlState>(MetastoreCallControlState::STATE_KEY);
+	return state->Get(context);
+}
+
+MetastoreQueryCallScope::MetastoreQueryCallScope(ClientContext &context) : scope(GetQueryCallControl(context)) {
+}
+
+void ThrowIfMetastoreCallInterrupted(const MetastoreError &error) {
+	if (error.code == MetastoreErrorCode::Cancelled) {
+		throw InterruptException();
+	}
+}
+
+std::vector<MetastoreStatistic> CollectMetastoreStatistics() {
+	auto &rpc = HmsRpcStats::Global();
+	return {
+	    {"hms_calls", static_cast<int64_t>(rpc.calls.load())},
+	    {"hms_retries", static_cast<int64_t>(rpc.retries.load())},
+	    {"hms_retries_denied", static_cast<int64_t>(rpc.retries_denied.load())},
+	    {"hms_failures", static_cast<int64_t>(rpc.failures.load())},
+	    {"hms_retry_delay_ms", static_cast<int64_t>(rpc.retry_delay_ms.load())},
+	    {"hms_hedges", static_cast<int64_t>(rpc.hedges.load())},
+	    {"hms_hedge_wins", static_cast<int64_t>(rpc.hedge_wins.load())},
+	    {"hms_breaker_opens", static_cast<int64_t>(rpc.breaker_opens.load())},
+	    {"hms_breaker_rejections", static_cast<int64_t>(rpc.breaker_rejections.load())},
+	    {"hms_dns_lookups", static_cast<int64_t>(rpc.dns_lookups.load())},
+	    {"hms_dns_cache_hits", static_cast<int64_t>(rpc.dns_cache_hits.load())},
+	    {"hms_retry_budget_available", HmsRetryBudget::Global().AvailableRetries()},
+	};
+}
+
 }
@@ -0,0 +1,602 @@
+#include "metastore_shared_cache.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace duckdb {
+
+//! "DDBMSC01" — identifies a metastore shared cache file
+static constexpr uint64_t SHARED_CACHE_MAGIC = 0x313043534d424444ULL;
+//! Bumped whenever the file layout or the record encoding changes
+static constexpr uint32_t SHARED_CACHE_FORMAT = 2;
+static constexpr size_t SHARED_CACHE_MIN_RING_BYTES = 1 << 20;
+static constexpr uint32_t SHARED_CACHE_MIN_SLOTS = 1024;
+//! Expected bytes per record, which sizes the index for the ring
+static constexpr size_t SHARED_CACHE_BYTES_PER_SLOT = 2048;
+//! Records bigger than this share of the ring are not shared; they would push out too many others
+static constexpr size_t SHARED_CACHE_MAX_RECORD_SHARE = 8;
+//! How long a slot may stay locked before a writer takes it over from one that presumably died; a live
+//! writer holds it for a handful of stores
+static constexpr uint64_t SHARED_CACHE_SLOT_LOCK_TIMEOUT_MS = 1000;
+//! Position, key size and payload size in front of every record
+static constexpr size_t SHARED_CACHE_RECORD_HEADER = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics in shared memory must not need a lock");
+
+struct MetastoreSharedCache::Header {
+	uint64_t magic;
+	uint32_t format;
+	uint32_t slot_count;
+	uint64_t ring_capacity;
+	//! Bytes of the ring reserved so far; a record at position P is intact while this is at most P + capacity
+	std::atomic<uint64_t> ring_head;
+};
+
+struct MetastoreSharedCache::Slot {
+	//! Odd while a writer updates the slot; zero for a slot never written
+	std::atomic<uint64_t> sequence;
+	std::atomic<uint64_t> key_hash;
+	std::atomic<uint64_t> position;
+	std::atomic<uint64_t> size;
+	std::atomic<uint64_t> stored_at_ms;
+	//! When the current writer locked the slot (or when another writer first found it locked); zero
+	//! while the slot is unlocked
+	std::atomic<uint64_t> locked_at_ms;
+};
+
+//! Header rounded up to a cache line, so the slots that follow are aligned
+static constexpr size_t SHARED_CACHE_HEADER_BYTES = 64;
+
+static uint64_t SharedCacheNowMs() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+	                                 std::chrono::system_clock::now().time_since_epoch())
+	                                 .count());
+}
+
+//! FNV-1a; never zero, so a zero key hash always means an empty slot
+static uint64_t SharedCacheHash(const std::string &key) {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (auto c : key) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 0x100000001b3ULL;
+	}
+	return hash == 0 ? 1 : hash;
+}
+
+size_t MetastoreSharedCache::FileSize(uint32_t slot_count, uint64_t ring_capacity) {
+	static_assert(sizeof(Header) <= SHARED_CACHE_HEADER_BYTES, "header must fit its reserved space");
+	return SHARED_CACHE_HEADER_BYTES + slot_count * sizeof(Slot) + ring_capacity;
+}
+
+//===--------------------------------------------------------------------===//
+// Record encoding
+//===--------------------------------------------------------------------===//
+namespace {
+
+enum class SharedCacheEntryKind : uint8_t { Table = 1, Partitions = 2, Names = 3 };
+
+class SharedCacheEncoder {
+public:
+	explicit SharedCacheEncoder(std::string &out_p) : out(out_p) {
+	}
+
+	void Byte(uint8_t value) {
+		out.push_back(static_cast<char>(value));
+	}
+	void U32(uint32_t value) {
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+	void String(const std::string &value) {
+		U32(static_cast<uint32_t>(value.size()));
+		out.append(value);
+	}
+	void OptionalString(const std::optional<std::string> &value) {
+		Byte(value ? 1 : 0);
+		if (value) {
+			String(*value);
+		}
+	}
+	void Map(const std::unordered_map<std::string, std::string> &map) {
+		U32(static_cast<uint32_t>(map.size()));
+		for (auto &entry : map) {
+			String(entry.first);
+			String(entry.second);
+		}
+	}
+
+private:
+	std::string &out;
+};
+
+//! Reads what SharedCacheEncoder wrote; any read past the end leaves the decoder failed
+class SharedCacheDecoder {
+public:
+	SharedCacheDecoder(const char *data, size_t size) : position(data), end(data + size) {
+	}
+
+	bool Failed() const {
+		return failed;
+	}
+	bool AtEnd() const {
+		return position == end;
+	}
+
+	uint8_t Byte() {
+		if (!Has(1)) {
+			return 0;
+		}
+		return static_cast<uint8_t>(*position++);
+	}
+	uint32_t U32() {
+		uint32_t value = 0;
+		if (Has(sizeof(value))) {
+			memcpy(&value, position, sizeof(value));
+			position += sizeof(value);
+		}
+		return value;
+	}
+	std::string String() {
+		auto size = U32();
+		if (!Has(size)) {
+			return std::string();
+		}
+		std::string value(position, size);
+		position += size;
+		return value;
+	}
+	std::optional<std::string> OptionalString() {
+		if (Byte() == 0) {
+			return std::nullopt;
+		}
+		return String();
+	}
+	void Map(std::unordered_map<std::string, std::string> &map) {
+		auto count = U32();
+		for (uint32_t i = 0; i < count && !failed; i++) {
+			auto key = String();
+			map.emplace(std::move(key), String());
+		}
+	}
+	//! Element count that the remaining bytes could hold, at `min_size` bytes per element
+	uint32_t Count(size_t min_size) {
+		auto count = U32();
+		if (count > static_cast<size_t>(end - position) / min_size) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+private:
+	bool Has(size_t size) {
+		if (failed || static_cast<size_t>(end - position) < size) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	const char *position;
+	const char *end;
+	bool failed = false;
+};
+
+} // namespace
+
+static std::string EncodeSharedTable(const MetastoreTable &table) {
+	std::string out;
+	SharedCacheEncoder encoder(out);
+	encoder.Byte(static_cast<uint8_t>(SharedCacheEntryKind::Table));
+	encoder.String(table.catalog);
+	encoder.String(table.namespace_name);
+	encoder.String(table.name);
+	auto &descriptor = table.storage_descriptor;
+	encoder.String(descriptor.location);
+	encoder.Byte(static_cast<uint8_t>(descriptor.format));
+	encoder.U32(static_cast<uint32_t>(descriptor.columns.size()));
+	for (auto &column : descriptor.columns) {
+		encoder.String(column.name);
+		encoder.String(column.type);
+	}
+	encoder.Map(descriptor.serde_parameters);
+	encoder.OptionalString(descriptor.serde_class);
+	encoder.OptionalString(descriptor.input_format);
+	encoder.OptionalString(descriptor.output_format);
+	encoder.U32(static_cast<uint32_t>(table.partition_spec.columns.size()));
+	for (auto &column : table.partition_spec.columns) {
+		encoder.String(column.name);
+		encoder.String(column.type);
+	}
+	encoder.Map(table.properties);
+	encoder.OptionalString(table.owner);
+	encoder.U32(static_cast<uint32_t>(table.fields));
+	return out;
+}
+
+static bool DecodeSharedTable(const std::string &payload, MetastoreTable &table) {
+	SharedCacheDecoder decoder(payload.data(), payload.size());
+	if (decoder.Byte() != static_cast<uint8_t>(SharedCacheEntryKind::Table)) {
+		return false;
+	}
+	table.catalog = decoder.String();
+	table.namespace_name = decoder.String();
+	table.name = decoder.String();
+	auto &descriptor = table.storage_descriptor;
+	descriptor.location = decoder.String();
+	descriptor.format = static_cast<MetastoreFormat>(
+	    std::min(decoder.Byte(), static_cast<uint8_t>(MetastoreFormat::Unknown)));
+	descriptor.columns.resize(decoder.Count(2 * sizeof(uint32_t)));
+	for (auto &column : descriptor.columns) {
+		column.name = decoder.String();
+		column.type = decoder.String();
+	}
+	decoder.Map(descriptor.serde_parameters);
+	descriptor.serde_class = decoder.OptionalString();
+	descriptor.input_format = decoder.OptionalString();
+	descriptor.output_format = decoder.OptionalString();
+	table.partition_spec.columns.resize(decoder.Count(2 * sizeof(uint32_t)));
+	for (auto &column : table.partition_spec.columns) {
+		column.name = decoder.String();
+		column.type = decoder.String();
+	}
+	decoder.Map(table.properties);
+	table.owner = decoder.OptionalString();
+	table.fields = static_cast<MetastoreTableFields>(decoder.U32());
+	return !decoder.Failed() && decoder.AtEnd();
+}
+
+static std::string EncodeSharedPartitions(const std::vector<MetastorePartitionValue> &partitions) {
+	std::string out;
+	SharedCacheEncoder encoder(out);
+	encoder.Byte(static_cast<uint8_t>(SharedCacheEntryKind::Partitions));
+	encoder.U32(static_cast<uint32_t>(partitions.size()));
+	for (auto &partition : partitions) {
+		encoder.U32(static_cast<uint32_t>(partition.values.size()));
+		for (size_t i = 0; i < partition.values.size(); i++) {
+			encoder.Byte(partition.IsNull(i) ? 1 : 0);
+			encoder.String(partition.values[i]);
+		}
+		encoder.String(partition.location);
+		encoder.Map(partition.parameters);
+	}
+	return out;
+}
+
+static bool DecodeSharedPartitions(const std::string &payload, std::vector<MetastorePartitionValue> &partitions) {
+	SharedCacheDecoder decoder(payload.data(), payload.size());
+	if (decoder.Byte() != static_cast<uint8_t>(SharedCacheEntryKind::Partitions)) {
+		return false;
+	}
+	// A partition takes at least its value count, location size and parameter count
+	partitions.resize(decoder.Count(3 * sizeof(uint32_t)));
+	for (auto &partition : partitions) {
+		auto value_count = decoder.Count(1 + sizeof(uint32_t));
+		partition.values.resize(value_count);
+		partition.null_values.resize(value_count);
+		for (uint32_t i = 0; i < value_count; i++) {
+			partition.null_values[i] = decoder.Byte() != 0;
+			partition.values[i] = decoder.String();
+		}
+		partition.location = decoder.String();
+		decoder.Map(partition.parameters);
+	}
+	return !decoder.Failed() && decoder.AtEnd();
+}
+
+static std::string EncodeSharedNames(const std::vector<std::string> &names) {
+	std::string out;
+	SharedCacheEncoder encoder(out);
+	encoder.Byte(static_cast<uint8_t>(SharedCacheEntryKind::Names));
+	encoder.U32(static_cast<uint32_t>(names.size()));
+	for (auto &name : names) {
+		encoder.String(name);
+	}
+	return out;
+}
+
+static bool DecodeSharedNames(const std::string &payload, std::vector<std::string> &names) {
+	SharedCacheDecoder decoder(payload.data(), payload.size());
+	if (decoder.Byte() != static_cast<uint8_t>(SharedCacheEntryKind::Names)) {
+		return false;
+	}
+	names.resize(decoder.Count(sizeof(uint32_t)));
+	for (auto &name : names) {
+		name = decoder.String();
+	}
+	return !decoder.Failed() && decoder.AtEnd();
+}
+
+//===--------------------------------------------------------------------===//
+// MetastoreSharedCache
+//===--------------------------------------------------------------------===//
+MetastoreResult<std::shared_ptr<MetastoreSharedCache>> MetastoreSharedCache::Open(const std::string &path,
+                                                                                 size_t capacity_bytes) {
+	using OpenResult = MetastoreResult<std::shared_ptr<MetastoreSharedCache>>;
+	auto fail = [&](const std::string &what) {
+		return OpenResult::Error(MetastoreErrorCode::InvalidConfig,
+		                         "Cannot use shared cache file " + path + ": " + what);
+	};
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		return fail(strerror(errno));
+	}
+	// Every mapping holds a shared lock on the file for as long as it exists. A process that gets the
+	// exclusive lock instead is alone with the file: only it creates the file, or repairs slots that a
+	// writer which died mid-update left locked. The others wait for it in LOCK_SH.
+	bool alone = flock(fd, LOCK_EX | LOCK_NB) == 0;
+	if (!alone && flock(fd, LOCK_SH) != 0) {
+		auto error = fail(strerror(errno));
+		close(fd);
+		return error;
+	}
+	// Closing the file drops its lock
+	auto finish = [&](OpenResult result) {
+		close(fd);
+		return result;
+	};
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		return finish(fail(strerror(errno)));
+	}
+
+	bool created = alone && file_stat.st_size == 0;
+	uint32_t slot_count;
+	uint64_t ring_capacity;
+	if (created) {
+		ring_capacity = std::max<uint64_t>(capacity_bytes, SHARED_CACHE_MIN_RING_BYTES);
+		slot_count = SHARED_CACHE_MIN_SLOTS;
+		while (slot_count < ring_capacity / SHARED_CACHE_BYTES_PER_SLOT) {
+			slot_count *= 2;
+		}
+		if (ftruncate(fd, static_cast<off_t>(FileSize(slot_count, ring_capacity))) != 0) {
+			return finish(fail(strerror(errno)));
+		}
+	} else {
+		uint64_t magic = 0;
+		uint32_t format = 0;
+		if (pread(fd, &magic, sizeof(magic), 0) != sizeof(magic) ||
+		    pread(fd, &format, sizeof(format), sizeof(magic)) != sizeof(format) ||
+		    pread(fd, &slot_count, sizeof(slot_count), sizeof(magic) + sizeof(format)) != sizeof(slot_count) ||
+		    pread(fd, &ring_capacity, sizeof(ring_capacity), 2 * sizeof(uint64_t)) != sizeof(ring_capacity)) {
+			return finish(fail("file is too short"));
+		}
+		if (magic != SHARED_CACHE_MAGIC) {
+			return finish(fail("not a metastore shared cache file"));
+		}
+		if (format != SHARED_CACHE_FORMAT) {
+			return finish(fail("written by an incompatible version of the extension"));
+		}
+		if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 || ring_capacity < SHARED_CACHE_MIN_RING_BYTES ||
+		    static_cast<uint64_t>(file_stat.st_size) != FileSize(slot_count, ring_capacity)) {
+			return finish(fail("file is damaged"));
+		}
+	}
+
+	auto mapping_size = FileSize(slot_count, ring_capacity);
+	auto mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		return finish(fail(strerror(errno)));
+	}
+	if (created) {
+		// The file is zero-filled, which is a valid state for every slot and the ring head; the magic goes
+		// last, so a file whose creator died half-way is rejected rather than used
+		auto header = static_cast<Header *>(mapping);
+		header->format = SHARED_CACHE_FORMAT;
+		header->slot_count = slot_count;
+		header->ring_capacity = ring_capacity;
+		header->magic = SHARED_CACHE_MAGIC;
+		msync(mapping, SHARED_CACHE_HEADER_BYTES, MS_SYNC);
+	}
+	std::shared_ptr<MetastoreSharedCache> cache(
+	    new MetastoreSharedCache(path, fd, static_cast<char *>(mapping), mapping_size));
+	if (alone) {
+		if (!created) {
+			cache->UnlockAbandonedSlots();
+		}
+		flock(fd, LOCK_SH);
+	}
+	return OpenResult::Success(std::move(cache));
+}
+
+MetastoreSharedCache::MetastoreSharedCache(std::string path_p, int fd_p, char *mapping_p, size_t mapping_size_p)
+    : path(std::move(path_p)), fd(fd_p), mapping(mapping_p), mapping_size(mapping_size_p) {
+	header = reinterpret_cast<Header *>(mapping);
+	slots = reinterpret_cast<Slot *>(mapping + SHARED_CACHE_HEADER_BYTES);
+	ring = mapping + FileSize(header->slot_count, 0);
+}
+
+MetastoreSharedCache::~MetastoreSharedCache() {
+	munmap(mapping, mapping_size);
+	close(fd);
+}
+
+void MetastoreSharedCache::UnlockAbandonedSlots() {
+	// Only called while no other process maps the file, so a locked slot has no live writer. Its fields
+	// may be half-updated, which readers already guard against by checking the record they point at.
+	for (uint32_t i = 0; i < header->slot_count; i++) {
+		auto &slot = slots[i];
+		auto sequence = slot.sequence.load(std::memory_order_relaxed);
+		if (sequence % 2 == 1) {
+			slot.locked_at_ms.store(0, std::memory_order_relaxed);
+			slot.sequence.store(sequence + 1, std::memory_order_release);
+		}
+	}
+}
+
+void MetastoreSharedCache::CopyFromRing(uint64_t position, char *target, size_t size) const {
+	auto offset = position % header->ring_capacity;
+	auto first = std::min<uint64_t>(size, header->ring_capacity - offset);
+	memcpy(target, ring + offset, first);
+	memcpy(target + first, ring, size - first);
+}
+
+void MetastoreSharedCache::CopyToRing(uint64_t position, const char *source, size_t size) {
+	auto offset = position % header->ring_capacity;
+	auto first = std::min<uint64_t>(size, header->ring_capacity - offset);
+	memcpy(ring + offset, source, first);
+	memcpy(ring, source + first, size - first);
+}
+
+bool MetastoreSharedCache::Read(const std::string &key, uint64_t max_age_ms, std::string &payload) {
+	auto hash = SharedCacheHash(key);
+	auto &slot = slots[hash & (header->slot_count - 1)];
+	uint64_t position = 0;
+	uint64_t size = 0;
+	bool consistent = false;
+	// A writer holds the slot only for a handful of stores, so a couple of retries are enough
+	for (int attempt = 0; attempt < 4 && !consistent; attempt++) {
+		auto sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence % 2 == 1) {
+			continue;
+		}
+		auto key_hash = slot.key_hash.load(std::memory_order_relaxed);
+		position = slot.position.load(std::memory_order_relaxed);
+		size = slot.size.load(std::memory_order_relaxed);
+		auto stored_at_ms = slot.stored_at_ms.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+			continue;
+		}
+		auto now_ms = SharedCacheNowMs();
+		if (sequence == 0 || key_hash != hash || (now_ms > stored_at_ms && now_ms - stored_at_ms > max_age_ms)) {
+			return false;
+		}
+		consistent = true;
+	}
+	if (!consistent || size < SHARED_CACHE_RECORD_HEADER + key.size() || size > header->ring_capacity) {
+		return false;
+	}
+	std::string record(size, '\0');
+	CopyFromRing(position, &record[0], size);
+	// If the ring was lapped while copying, the copy may mix in a newer record
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (header->ring_head.load(std::memory_order_relaxed) > position + header->ring_capacity) {
+		return false;
+	}
+	uint64_t record_position;
+	uint32_t key_size;
+	uint32_t payload_size;
+	memcpy(&record_position, record.data(), sizeof(record_position));
+	memcpy(&key_size, record.data() + sizeof(record_position), sizeof(key_size));
+	memcpy(&payload_size, record.data() + sizeof(record_position) + sizeof(key_size), sizeof(payload_size));
+	if (record_position != position || key_size != key.size() ||
+	    SHARED_CACHE_RECORD_HEADER + key_size + payload_size != size ||
+	    record.compare(SHARED_CACHE_RECORD_HEADER, key_size, key) != 0) {
+		return false;
+	}
+	payload = record.substr(SHARED_CACHE_RECORD_HEADER + key_size);
+	return true;
+}
+
+void MetastoreSharedCache::Write(const std::string &key, const std::string &payload) {
+	auto size = SHARED_CACHE_RECORD_HEADER + key.size() + payload.size();
+	if (size > header->ring_capacity / SHARED_CACHE_MAX_RECORD_SHARE) {
+		return;
+	}
+	auto position = header->ring_head.fetch_add(size, std::memory_order_acq_rel);
+	std::string record;
+	record.reserve(size);
+	auto key_size = static_cast<uint32_t>(key.size());
+	auto payload_size = static_cast<uint32_t>(payload.size());
+	record.append(reinterpret_cast<const char *>(&position), sizeof(position));
+	record.append(reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+	record.append(reinterpret_cast<const char *>(&payload_size), sizeof(payload_size));
+	record.append(key);
+	record.append(payload);
+	CopyToRing(position, record.data(), size);
+
+	auto hash = SharedCacheHash(key);
+	auto &slot = slots[hash & (header->slot_count - 1)];
+	auto now_ms = SharedCacheNowMs();
+	auto sequence = slot.sequence.load(std::memory_order_relaxed);
+	auto locked = sequence + 1;
+	if (sequence % 2 == 1) {
+		// Another process is publishing to this slot, and normally its value wins. If it has held the slot
+		// for too long, it died half-way and the slot is taken over.
+		auto locked_at_ms = slot.locked_at_ms.load(std::memory_order_relaxed);
+		if (locked_at_ms == 0) {
+			// Locked but not stamped yet (or never, if the writer died right away): start the clock
+			uint64_t unstamped = 0;
+			slot.locked_at_ms.compare_exchange_strong(unstamped, now_ms, std::memory_order_relaxed);
+			return;
+		}
+		if (now_ms < locked_at_ms + SHARED_CACHE_SLOT_LOCK_TIMEOUT_MS) {
+			return;
+		}
+		locked = sequence + 2;
+	}
+	if (!slot.sequence.compare_exchange_strong(sequence, locked, std::memory_order_acquire)) {
+		return;
+	}
+	slot.locked_at_ms.store(now_ms, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.key_hash.store(hash, std::memory_order_relaxed);
+	slot.position.store(position, std::memory_order_relaxed);
+	slot.size.store(size, std::memory_order_relaxed);
+	slot.stored_at_ms.store(now_ms, std::memory_order_relaxed);
+	slot.locked_at_ms.store(0, std::memory_order_relaxed);
+	// Fails only if another writer took the slot over in the meantime; its value wins then
+	if (slot.sequence.compare_exchange_strong(locked, locked + 1, std::memory_order_release,
+	                                          std::memory_order_relaxed)) {
+		stores++;
+	}
+}
+
+bool MetastoreSharedCache::GetTable(const std::string &key, uint64_t max_age_ms, MetastoreTable &out) {
+	std::string payload;
+	MetastoreTable table;
+	if (!Read(key, max_age_ms, payload) || !DecodeSharedTable(payload, table)) {
+		misses++;
+		return false;
+	}
+	hits++;
+	out = std::move(table);
+	return true;
+}
+
+void MetastoreSharedCache::PutTable(const std::string &key, const MetastoreTable &table) {
+	Write(key, EncodeSharedTable(table));
+}
+
+bool MetastoreSharedCache::GetPartitions(const std::string &key, uint64_t max_age_ms,
+                                         std::vector<MetastorePartitionValue> &out) {
+	std::string payload;
+	std::vector<MetastorePartitionValue> partitions;
+	if (!Read(key, max_age_ms, payload) || !DecodeSharedPartitions(payload, partitions)) {
+		misses++;
+		return false;
+	}
+	hits++;
+	out = std::move(partitions);
+	return true;
+}
+
+void MetastoreSharedCache::PutPartitions(const std::string &key,
+                                         const std::vector<MetastorePartitionValue> &partitions) {
+	Write(key, EncodeSharedPartitions(partitions));
+}
+
+bool MetastoreSharedCache::GetNames(const std::string &key, uint64_t max_age_ms, std::vector<std::string> &out) {
+	std::string payload;
+	std::vector<std::string> names;
+	if (!Read(key, max_age_ms, payload) || !DecodeSharedNames(payload, names)) {
+		misses++;
+		return false;
+	}
+	hits++;
+	out = std::move(names);
+	return true;
+}
+
+void MetastoreSharedCache::PutNames(const std::string &key, const std::vector<std::string> &names) {
+	Write(key, EncodeSharedNames(names));
+}
+
+} // namespace duckdb
@@ -0,0 +1,193 @@
+#include "metastore_shared_cache_connector.hpp"
+#include "metastore_single_flight.hpp"
+
+namespace duckdb {
+
+SharedCacheMetastoreConnector::SharedCacheMetastoreConnector(std::shared_ptr<IMetastoreConnector> inner_p,
+                                                             std::shared_ptr<MetastoreSharedCache> shared_cache_p,
+                                                             const std::string &endpoint, uint64_t max_age_ms_p)
+    : inner(std::move(inner_p)), shared_cache(std::move(shared_cache_p)), max_age_ms(max_age_ms_p) {
+	MetastoreSingleFlight::AppendKeyPart(key_prefix, endpoint);
+}
+
+std::string SharedCacheMetastoreConnector::TableKey(const std::string &namespace_name, const std::string &table_name,
+                                                    MetastoreTableFields fields) const {
+	auto key = key_prefix + "table/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	if (fields != MetastoreTableFields::All) {
+		MetastoreSingleFlight::AppendKeyPart(key, std::to_string(static_cast<uint32_t>(fields)));
+	}
+	return key;
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>> SharedCacheMetastoreConnector::ListNamespaces() {
+	return inner->ListNamespaces();
+}
+
+MetastoreResult<std::vector<std::string>> SharedCacheMetastoreConnector::ListTables(const std::string &namespace_name) {
+	return inner->ListTables(namespace_name);
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>>
+SharedCacheMetastoreConnector::ListNamespacesMatching(const std::string &pattern) {
+	return inner->ListNamespacesMatching(pattern);
+}
+
+MetastoreResult<std::vector<std::string>>
+SharedCacheMetastoreConnector::ListTablesMatching(const std::string &namespace_name, const std::string &pattern,
+                                                  const std::string &table_type) {
+	return inner->ListTablesMatching(namespace_name, pattern, table_type);
+}
+
+MetastoreResult<std::vector<MetastoreTableSummary>>
+SharedCacheMetastoreConnector::ListTableSummaries(const std::string &namespace_pattern,
+                                                  const std::string &table_pattern,
+                                                  const std::vector<std::string> &table_types) {
+	return inner->ListTableSummaries(namespace_pattern, table_pattern, table_types);
+}
+
+MetastoreResult<MetastoreTable> SharedCacheMetastoreConnector::GetTable(const std::string &namespace_name,
+                                                                        const std::string &table_name) {
+	auto key = TableKey(namespace_name, table_name, MetastoreTableFields::All);
+	MetastoreTable table;
+	if (shared_cache->GetTable(key, max_age_ms, table)) {
+		return MetastoreResult<MetastoreTable>::Success(std::move(table));
+	}
+	auto result = inner->GetTable(namespace_name, table_name);
+	if (result.IsOk()) {
+		shared_cache->PutTable(key, result.value);
+	}
+	return result;
+}
+
+MetastoreResult<MetastoreTable> SharedCacheMetastoreConnector::GetTableProjected(const std::string &namespace_name,
+                                                                                 const std::string &table_name,
+                                                                                 MetastoreTableFields fields) {
+	// Like the per-process cache, a full table serves any projection, and a projection is only ever shared
+	// under its own key
+	MetastoreTable table;
+	if (shared_cache->GetTable(TableKey(namespace_name, table_name, MetastoreTableFields::All), max_age_ms, table)) {
+		return MetastoreResult<MetastoreTable>::Success(std::move(table));
+	}
+	auto key = TableKey(namespace_name, table_name, fields);
+	if (fields != MetastoreTableFields::All && shared_cache->GetTable(key, max_age_ms, table)) {
+		return MetastoreResult<MetastoreTable>::Success(std::move(table));
+	}
+	auto result = inner->GetTableProjected(namespace_name, table_name, fields);
+	if (result.IsOk()) {
+		shared_cache->PutTable(TableKey(namespace_name, table_name, result.value.fields), result.value);
+	}
+	return result;
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+SharedCacheMetastoreConnector::GetTables(const std::string &namespace_name,
+                                         const std::vector<std::string> &table_names) {
+	return GetTablesProjected(namespace_name, table_names, MetastoreTableFields::All);
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+SharedCacheMetastoreConnector::GetTablesProjected(const std::string &namespace_name,
+                                                  const std::vector<std::string> &table_names,
+                                                  MetastoreTableFields fields) {
+	// Serve what the segment has and fetch the rest in one bulk call; keys are those of GetTableProjected
+	std::vector<MetastoreResult<MetastoreTable>> results(table_names.size());
+	std::vector<std::string> missing_names;
+	std::vector<size_t> missing_positions;
+	for (size_t i = 0; i < table_names.size(); i++) {
+		MetastoreTable table;
+		if (shared_cache->GetTable(TableKey(namespace_name, table_names[i], MetastoreTableFields::All), max_age_ms,
+		                           table) ||
+		    (fields != MetastoreTableFields::All &&
+		     shared_cache->GetTable(TableKey(namespace_name, table_names[i], fields), max_age_ms, table))) {
+			results[i] = MetastoreResult<MetastoreTable>::Success(std::move(table));
+		} else {
+			missing_names.push_back(table_names[i]);
+			missing_positions.push_back(i);
+		}
+	}
+	if (missing_names.empty()) {
+		return results;
+	}
+	auto fetched = inner->GetTablesProjected(namespace_name, missing_names, fields);
+	for (size_t i = 0; i < fetched.size(); i++) {
+		if (fetched[i].IsOk()) {
+			shared_cache->PutTable(TableKey(namespace_name, missing_names[i], fetched[i].value.fields),
+			                       fetched[i].value);
+		}
+		results[missing_positions[i]] = std::move(fetched[i]);
+	}
+	return results;
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+SharedCacheMetastoreConnector::ListPartitions(const std::string &namespace_name, const std::string &table_name,
+                                              const std::string &predicate) {
+	auto key = key_prefix + "partitions/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	MetastoreSingleFlight::AppendKeyPart(key, predicate);
+	std::vector<MetastorePartitionValue> partitions;
+	if (shared_cache->GetPartitions(key, max_age_ms, partitions)) {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(partitions));
+	}
+	auto result = inner->ListPartitions(namespace_name, table_name, predicate);
+	if (result.IsOk()) {
+		shared_cache->PutPartitions(key, result.value);
+	}
+	return result;
+}
+
+MetastoreResult<std::vector<std::string>>
+SharedCacheMetastoreConnector::ListPartitionNames(const std::string &namespace_name, const std::string &table_name) {
+	auto key = key_prefix + "partition_names/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	std::vector<std::string> names;
+	if (shared_cache->GetNames(key, max_age_ms, names)) {
+		return MetastoreResult<std::vector<std::string>>::Success(std::move(names));
+	}
+	auto result = inner->ListPartitionNames(namespace_name, table_name);
+	if (result.IsOk()) {
+		shared_cache->PutNames(key, result.value);
+	}
+	return result;
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+SharedCacheMetastoreConnector::GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+                                                    const std::vector<std::string> &partition_names) {
+	return GetPartitionsByNamesProjected(namespace_name, table_name, partition_names, MetastorePartitionFields::All);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+SharedCacheMetastoreConnector::GetPartitionsByNamesProjected(const std::string &namespace_name,
+                                                             const std::string &table_name,
+                                                             const std::vector<std::string> &partition_names,
+                                                             MetastorePartitionFields fields) {
+	// Shared per name list, like in the per-process cache
+	auto key = key_prefix + "partitions_by_names/";
+	MetastoreSingleFlight::AppendKeyPart(key, namespace_name);
+	MetastoreSingleFlight::AppendKeyPart(key, table_name);
+	MetastoreSingleFlight::AppendKeyPart(key, std::to_string(static_cast<uint32_t>(fields)));
+	MetastoreSingleFlight::AppendKeyDigest(key, partition_names);
+	std::vector<MetastorePartitionValue> partitions;
+	if (shared_cache->GetPartitions(key, max_age_ms, partitions)) {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(partitions));
+	}
+	auto result = fields == MetastorePartitionFields::All
+	                  ? inner->GetPartitionsByNames(namespace_name, table_name, partition_names)
+	                  : inner->GetPartitionsByNamesProjected(namespace_name, table_name, partition_names, fields);
+	if (result.IsOk()) {
+		shared_cache->PutPartitions(key, result.value);
+	}
+	return result;
+}
+
+MetastoreResult<MetastoreTableProperties>
+SharedCacheMetastoreConnector::GetTableStats(const std::string &namespace_name, const std::string &table_name) {
+	return inner->GetTableStats(namespace_name, table_name);
+}
+
+} // namespace duckdb
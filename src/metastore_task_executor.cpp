@@ -0,0 +1,137 @@
+#include "metastore_task_executor.hpp"
+#include "metastore_call_scope.hpp"
+
+#include "duckdb/parallel/task_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+namespace duckdb {
+
+namespace {
+
+class MetastoreFanOutTask : public BaseExecutorTask {
+public:
+	MetastoreFanOutTask(TaskExecutor &executor, const std::function<void()> &work_p)
+	    : BaseExecutorTask(executor), work(work_p) {
+	}
+
+	void ExecuteTask() override {
+		work();
+	}
+
+	string TaskType() const override {
+		return "MetastoreFanOutTask";
+	}
+
+private:
+	const std::function<void()> &work;
+};
+
+//! Fire-and-forget task; owns the producer token it was scheduled with
+class MetastoreBackgroundTask : public Task {
+public:
+	MetastoreBackgroundTask(unique_ptr<ProducerToken> token_p, std::function<void()> job_p)
+	    : token(std::move(token_p)), job(std::move(job_p)) {
+	}
+
+	TaskExecutionResult Execute(TaskExecutionMode mode) override {
+		RunBackgroundJob(job);
+		return TaskExecutionResult::TASK_FINISHED;
+	}
+
+	string TaskType() const override {
+		return "MetastoreBackgroundTask";
+	}
+
+	static void RunBackgroundJob(const std::function<void()> &job) {
+		// Background work outlives the query that scheduled it and must not inherit its interrupt
+		MetastoreCallScope scope(nullptr);
+		try {
+			job();
+		} catch (...) { // NOLINT
+		}
+	}
+
+	unique_ptr<ProducerToken> token;
+
+private:
+	std::function<void()> job;
+};
+
+//! Returns the caller slot and all helper slots to the catalog budget, also when a task failed
+struct ConcurrencyReservation {
+	ConcurrencyReservation(MetastoreConcurrencyLimit &limit_p) : limit(limit_p) {
+		limit.active++;
+	}
+	~ConcurrencyReservation() {
+		limit.active -= 1 + helpers;
+	}
+
+	MetastoreConcurrencyLimit &limit;
+	idx_t helpers = 0;
+};
+
+} // namespace
+
+MetastoreTaskExecutor::MetastoreTaskExecutor(DatabaseInstance &db_p, std::shared_ptr<MetastoreConcurrencyLimit> limit_p)
+    : db(db_p), limit(std::move(limit_p)) {
+}
+
+idx_t MetastoreTaskExecutor::ReserveHelpers(idx_t wanted) {
+	auto current = limit->active.load();
+	while (true) {
+		idx_t available = current < limit->max_concurrency ? limit->max_concurrency - current : 0;
+		auto granted = MinValue<idx_t>(wanted, available);
+		if (granted == 0 || limit->active.compare_exchange_weak(current, current + granted)) {
+			return granted;
+		}
+	}
+}
+
+void MetastoreTaskExecutor::RunAll(size_t count, const std::function<void(size_t)> &fn) {
+	if (count == 0) {
+		return;
+	}
+	std::atomic<size_t> next_index {0};
+	// Helpers run on scheduler threads; they make their calls under the caller's query scope
+	auto control = MetastoreCallScope::Current();
+	std::function<void()> work = [&]() {
+		MetastoreCallScope scope(control);
+		for (auto i = next_index++; i < count; i = next_index++) {
+			fn(i);
+		}
+	};
+
+	// The calling thread always takes part, so a single item never touches the scheduler
+	ConcurrencyReservation reservation(*limit);
+	if (count > 1) {
+		auto &scheduler = TaskScheduler::GetScheduler(db);
+		auto threads = NumericCast<idx_t>(MaxValue<int32_t>(scheduler.NumberOfThreads(), 1));
+		reservation.helpers = ReserveHelpers(MinValue<idx_t>(count, threads) - 1);
+	}
+	if (reservation.helpers == 0) {
+		work();
+		return;
+	}
+
+	TaskExecutor executor(TaskScheduler::GetScheduler(db));
+	for (idx_t i = 0; i < reservation.helpers; i++) {
+		executor.ScheduleTask(make_uniq<MetastoreFanOutTask>(executor, work));
+	}
+	work();
+	// Runs helper tasks that no worker has started (they find no items left) and waits for the rest
+	executor.WorkOnTasks();
+}
+
+bool ScheduleMetastoreBackgroundTask(DatabaseInstance &db, std::function<void()> job) {
+	auto &scheduler = TaskScheduler::GetScheduler(db);
+	if (scheduler.NumberOfThreads() <= 1) {
+		// No worker threads besides the query threads: nobody would pick the task up
+		return false;
+	}
+	auto task = make_shared_ptr<MetastoreBackgroundTask>(scheduler.CreateProducer(), std::move(job));
+	auto &token = *task->token;
+	scheduler.ScheduleTask(token, std::move(task));
+	return true;
+}
+
+} // namespace duckdb
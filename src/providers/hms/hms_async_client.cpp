@@ -0,0 +1,1016 @@
+#include "hms/hms_async_client.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+namespace duckdb {
+
+namespace {
+
+//! Bytes requested from the socket per recv() call
+static constexpr size_t HMS_RECV_CHUNK_SIZE = 64 * 1024;
+//! Shortest wait before a hedged copy is sent, so a burst of fast calls never doubles the load
+static constexpr int64_t HMS_MIN_HEDGE_DELAY_US = 5000;
+//! How often a cancellable event loop wakes up to check for an interrupt
+static constexpr int64_t HMS_CANCEL_POLL_MS = 50;
+
+#ifdef MSG_NOSIGNAL
+static constexpr int HMS_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int HMS_SEND_FLAGS = 0;
+#endif
+
+bool ConfigureSocket(int fd) {
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+		return false;
+	}
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	// Requests are written in one go and latency-bound; don't let Nagle hold back the tail
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+	return true;
+}
+
+double UnitRandom() {
+	thread_local std::mt19937_64 generator(std::random_device {}());
+	return std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+}
+
+} // namespace
+
+//===--------------------------------------------------------------------===//
+// Poller — readiness notification over the client's sockets
+//===--------------------------------------------------------------------===//
+class HmsAsyncClient::Poller {
+public:
+#ifdef __linux__
+	Poller() : epoll_fd(epoll_create1(EPOLL_CLOEXEC)) {
+	}
+	~Poller() {
+		if (epoll_fd >= 0) {
+			close(epoll_fd);
+		}
+	}
+
+	bool IsValid() const {
+		return epoll_fd >= 0;
+	}
+
+	void Watch(int fd, bool want_write, bool add) {
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = want_write ? EPOLLOUT : EPOLLIN;
+		event.data.fd = fd;
+		epoll_ctl(epoll_fd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+	}
+
+	void Remove(int fd) {
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	}
+
+	void Wait(int timeout_ms, std::vector<int> &ready) {
+		ready.clear();
+		epoll_event events[64];
+		int count = epoll_wait(epoll_fd, events, 64, timeout_ms);
+		for (int i = 0; i < count; i++) {
+			ready.push_back(events[i].data.fd);
+		}
+	}
+
+private:
+	int epoll_fd;
+#else
+	bool IsValid() const {
+		return true;
+	}
+
+	void Watch(int fd, bool want_write, bool add) {
+		interest[fd] = want_write;
+	}
+
+	void Remove(int fd) {
+		interest.erase(fd);
+	}
+
+	void Wait(int timeout_ms, std::vector<int> &ready) {
+		ready.clear();
+		std::vector<pollfd> fds;
+		fds.reserve(interest.size());
+		for (auto &entry : interest) {
+			pollfd pfd;
+			pfd.fd = entry.first;
+			pfd.events = entry.second ? POLLOUT : POLLIN;
+			pfd.revents = 0;
+			fds.push_back(pfd);
+		}
+		if (poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms) <= 0) {
+			return;
+		}
+		for (auto &pfd : fds) {
+			if (pfd.revents != 0) {
+				ready.push_back(pfd.fd);
+			}
+		}
+	}
+
+private:
+	std::unordered_map<int, bool> interest;
+#endif
+};
+
+//===--------------------------------------------------------------------===//
+// LookupSignal — wakes the event loop when a background DNS lookup finishes
+//
+// Shared with the lookup threads, so the pipe stays open until the last of
+// them is done, even if the client is gone by then.
+//===--------------------------------------------------------------------===//
+class HmsAsyncClient::LookupSignal {
+public:
+	LookupSignal() {
+		if (pipe(fds) != 0) {
+			fds[0] = fds[1] = -1;
+			return;
+		}
+		for (auto fd : fds) {
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+			fcntl(fd, F_SETFD, FD_CLOEXEC);
+		}
+	}
+	~LookupSignal() {
+		for (auto fd : fds) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+	}
+
+	bool IsValid() const {
+		return fds[0] >= 0;
+	}
+	int ReadFd() const {
+		return fds[0];
+	}
+
+	void Notify() {
+		// A full pipe already wakes the loop, so a failed write loses nothing
+		char byte = 1;
+		auto written = write(fds[1], &byte, 1);
+		(void)written;
+	}
+	void Drain() {
+		char buffer[64];
+		while (read(fds[0], buffer, sizeof(buffer)) > 0) {
+		}
+	}
+
+private:
+	int fds[2];
+};
+
+//===--------------------------------------------------------------------===//
+// HmsAsyncClient
+//===--------------------------------------------------------------------===//
+HmsAsyncClient::HmsAsyncClient(const HmsConfig &config_p, HmsEndpointSet &endpoints_p, size_t max_connections_p)
+    : config(config_p), endpoints(endpoints_p), max_connections(max_connections_p == 0 ? 1 : max_connections_p),
+      poller(new Poller()), control(MetastoreCallScope::Current()) {
+}
+
+HmsAsyncClient::~HmsAsyncClient() {
+	// Only reached with calls still open if Run() was abandoned; their replies are unusable
+	for (auto &entry : connections) {
+		if (entry.second->call) {
+			endpoints.OnCallCancelled(entry.second->endpoint);
+		}
+		CloseAttempts(*entry.second);
+		poller->Remove(entry.first);
+		close(entry.first);
+	}
+	for (auto &pending : resolving) {
+		// Lets go of a half-open probe the call may have been picked for
+		endpoints.OnCallStarted(pending.endpoint);
+		endpoints.OnCallCancelled(pending.endpoint);
+	}
+}
+
+void HmsAsyncClient::Submit(const std::string &method, const std::function<void(ThriftWriter &)> &build_args,
+                            HmsReplyParser parse_reply, HmsCallCompletion on_complete, bool hedgeable) {
+	auto call = std::unique_ptr<Call>(new Call());
+	call->method = method;
+	call->seqid = next_seqid++;
+	ThriftWriter writer;
+	writer.WriteMessageBegin(method, ThriftMessageType::Call, call->seqid);
+	writer.WriteStructBegin();
+	build_args(writer);
+	writer.WriteFieldStop();
+	writer.WriteStructEnd();
+	call->request = writer.Release();
+	call->parse_reply = std::move(parse_reply);
+	call->on_complete = std::move(on_complete);
+	call->hedgeable = hedgeable;
+	queue.push_back(std::move(call));
+	HmsRpcStats::Global().calls++;
+	HmsRetryBudget::Global().RecordCall();
+}
+
+void HmsAsyncClient::SubmitListCall(const std::string &method, const std::function<void(ThriftWriter &)> &build_args,
+                                    HmsListReplyParser parse_list, HmsReplyParser parse_reply,
+                                    HmsCallCompletion on_complete) {
+	Submit(method, build_args, std::move(parse_reply), std::move(on_complete));
+	queue.back()->parse_list = std::move(parse_list);
+}
+
+MetastoreResult<int> HmsAsyncClient::ConnectNext(Connection &connection, bool &in_progress) {
+	int last_errno = 0;
+	auto &addresses = *connection.addresses;
+	while (connection.next_address < addresses.size()) {
+		auto &address = addresses[connection.next_address++];
+		int fd = socket(address.family, address.socktype, address.protocol);
+		if (fd < 0) {
+			last_errno = errno;
+			continue;
+		}
+		if (!ConfigureSocket(fd)) {
+			last_errno = errno;
+			close(fd);
+			continue;
+		}
+		if (connect(fd, reinterpret_cast<const sockaddr *>(&address.address), address.length) == 0) {
+			in_progress = false;
+			return MetastoreResult<int>::Success(fd);
+		}
+		if (errno == EINPROGRESS) {
+			in_progress = true;
+			return MetastoreResult<int>::Success(fd);
+		}
+		last_errno = errno;
+		close(fd);
+	}
+	return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS socket connect failed",
+	                                   last_errno ? strerror(last_errno) : "", true);
+}
+
+void HmsAsyncClient::StartRacingAttempts(std::chrono::steady_clock::time_point now) {
+	for (auto &entry : connections) {
+		auto &connection = *entry.second;
+		if (!connection.connecting || connection.next_address >= connection.addresses->size() ||
+		    now < connection.next_attempt_at) {
+			continue;
+		}
+		connection.next_attempt_at = now + std::chrono::milliseconds(HMS_CONNECT_ATTEMPT_DELAY_MS);
+		bool in_progress = false;
+		auto attempt = ConnectNext(connection, in_progress);
+		if (!attempt.IsOk()) {
+			// The remaining addresses failed right away; the attempts already in flight may still connect
+			continue;
+		}
+		// An attempt that connected synchronously is reported writable by the next wait and wins there
+		connection.racing.push_back(attempt.value);
+		attempt_owner[attempt.value] = connection.fd;
+		poller->Watch(attempt.value, true, true);
+	}
+}
+
+bool HmsAsyncClient::FinishConnect(Connection &connection, int fd) {
+	int socket_error = 0;
+	socklen_t length = sizeof(socket_error);
+	if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &socket_error, &length) != 0) {
+		socket_error = errno;
+	}
+	auto racing = std::find(connection.racing.begin(), connection.racing.end(), fd);
+	if (racing != connection.racing.end()) {
+		connection.racing.erase(racing);
+		attempt_owner.erase(fd);
+	}
+	if (socket_error == 0) {
+		// First attempt to connect wins; the others are abandoned
+		if (fd != connection.fd) {
+			poller->Remove(connection.fd);
+			close(connection.fd);
+			Rekey(connection, fd);
+		}
+		CloseAttempts(connection);
+		connection.connecting = false;
+		TouchDeadline(connection);
+		return true;
+	}
+
+	poller->Remove(fd);
+	close(fd);
+	if (fd != connection.fd) {
+		return true;
+	}
+	if (!connection.racing.empty()) {
+		// Another attempt is still in flight; it carries the connection from now on
+		auto next_fd = connection.racing.back();
+		connection.racing.pop_back();
+		attempt_owner.erase(next_fd);
+		Rekey(connection, next_fd);
+		return true;
+	}
+	// Nothing else in flight: try the next address right away
+	bool in_progress = false;
+	auto next = ConnectNext(connection, in_progress);
+	if (!next.IsOk()) {
+		auto &address = endpoints.Endpoint(connection.endpoint);
+		// None of the addresses accepted a connection; the host may have moved
+		HmsResolver::Global().Invalidate(address.host, address.port);
+		next.error.detail = strerror(socket_error);
+		FailCall(connection, std::move(next));
+		return false;
+	}
+	Rekey(connection, next.value);
+	connection.connecting = in_progress;
+	connection.next_attempt_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(HMS_CONNECT_ATTEMPT_DELAY_MS);
+	poller->Watch(connection.fd, true, true);
+	return true;
+}
+
+void HmsAsyncClient::CloseAttempts(Connection &connection) {
+	for (auto fd : connection.racing) {
+		poller->Remove(fd);
+		close(fd);
+		attempt_owner.erase(fd);
+	}
+	connection.racing.clear();
+}
+
+void HmsAsyncClient::Rekey(Connection &connection, int new_fd) {
+	auto old_fd = connection.fd;
+	auto owned = std::move(connections[old_fd]);
+	connections.erase(old_fd);
+	connection.fd = new_fd;
+	connections[new_fd] = std::move(owned);
+	for (auto racing_fd : connection.racing) {
+		attempt_owner[racing_fd] = new_fd;
+	}
+}
+
+void HmsAsyncClient::Dispatch() {
+	while (!queue.empty() && connections.size() + resolving.size() < max_connections) {
+		auto call = std::move(queue.front());
+		queue.pop_front();
+
+		auto endpoint = endpoints.Pick(call->avoid_endpoint);
+		if (endpoint == HmsEndpointSet::NO_ENDPOINT) {
+			// Retrying cannot help before a breaker lets a probe through; callers may fall back to cached data
+			HmsRpcStats::Global().breaker_rejections++;
+			FinishCall(std::move(call),
+			           MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS circuit breaker open",
+			                                       "every metastore instance failed recently", false));
+			continue;
+		}
+		// A replayed call skips the pool: its other idle connections are likely just as stale
+		int fd = call->replayed ? -1 : endpoints.Pool(endpoint).TryAcquire();
+		if (fd < 0) {
+			auto &address = endpoints.Endpoint(endpoint);
+			MetastoreResult<HmsAddressList> resolved;
+			if (!HmsResolver::Global().TryResolveCached(address.host, address.port, resolved)) {
+				if (AwaitLookup(call, endpoint)) {
+					continue;
+				}
+				resolved = HmsResolver::Global().Resolve(address.host, address.port);
+			}
+			Connect(std::move(call), endpoint, std::move(resolved));
+			continue;
+		}
+		auto connection = std::unique_ptr<Connection>(new Connection());
+		connection->endpoint = endpoint;
+		connection->reused = true;
+		connection->fd = fd;
+		auto &conn = *connection;
+		connections[fd] = std::move(connection);
+		poller->Watch(fd, true, true);
+		StartCall(conn, std::move(call));
+	}
+}
+
+void HmsAsyncClient::Connect(std::unique_ptr<Call> call, size_t endpoint, MetastoreResult<HmsAddressList> resolved) {
+	if (!resolved.IsOk()) {
+		endpoints.OnCallStarted(endpoint);
+		endpoints.OnCallFinished(endpoint, false, std::chrono::microseconds(0));
+		FinishCall(std::move(call), MetastoreResult<int>::Error(resolved.error.code, resolved.error.message,
+		                                                        resolved.error.detail, resolved.error.retryable));
+		return;
+	}
+	auto connection = std::unique_ptr<Connection>(new Connection());
+	connection->endpoint = endpoint;
+	connection->addresses = std::move(resolved.value);
+	auto connected = ConnectNext(*connection, connection->connecting);
+	if (!connected.IsOk()) {
+		auto &address = endpoints.Endpoint(endpoint);
+		HmsResolver::Global().Invalidate(address.host, address.port);
+		endpoints.OnCallStarted(endpoint);
+		endpoints.OnCallFinished(endpoint, false, std::chrono::microseconds(0));
+		FinishCall(std::move(call), std::move(connected));
+		return;
+	}
+	connection->next_attempt_at =
+	    std::chrono::steady_clock::now() + std::chrono::milliseconds(HMS_CONNECT_ATTEMPT_DELAY_MS);
+	connection->fd = connected.value;
+	auto &conn = *connection;
+	connections[conn.fd] = std::move(connection);
+	poller->Watch(conn.fd, true, true);
+	StartCall(conn, std::move(call));
+}
+
+bool HmsAsyncClient::AwaitLookup(std::unique_ptr<Call> &call, size_t endpoint) {
+	if (!lookup_signal) {
+		lookup_signal = std::make_shared<LookupSignal>();
+		if (lookup_signal->IsValid()) {
+			poller->Watch(lookup_signal->ReadFd(), false, true);
+		}
+	}
+	if (!lookup_signal->IsValid()) {
+		return false;
+	}
+	// Calls to the same instance wait for one lookup
+	bool lookup_running = std::any_of(resolving.begin(), resolving.end(),
+	                                  [&](const PendingLookup &pending) { return pending.endpoint == endpoint; });
+	if (!lookup_running) {
+		auto &address = endpoints.Endpoint(endpoint);
+		auto signal = lookup_signal;
+		HmsResolver::Global().ResolveInBackground(address.host, address.port, [signal]() { signal->Notify(); });
+	}
+	PendingLookup pending;
+	pending.endpoint = endpoint;
+	pending.call = std::move(call);
+	pending.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.connection_timeout_ms);
+	resolving.push_back(std::move(pending));
+	return true;
+}
+
+void HmsAsyncClient::ResumeLookups(std::chrono::steady_clock::time_point now) {
+	// Taken out first: finishing a call may cancel a hedged sibling that is parked as well
+	std::vector<std::pair<PendingLookup, MetastoreResult<HmsAddressList>>> finished;
+	for (size_t i = 0; i < resolving.size();) {
+		auto &address = endpoints.Endpoint(resolving[i].endpoint);
+		MetastoreResult<HmsAddressList> resolved;
+		if (HmsResolver::Global().TryResolveCached(address.host, address.port, resolved)) {
+			finished.emplace_back(std::move(resolving[i]), std::move(resolved));
+		} else if (resolving[i].deadline <= now) {
+			finished.emplace_back(std::move(resolving[i]), MetastoreResult<HmsAddressList>::Error(
+			                                                   MetastoreErrorCode::Transient,
+			                                                   "HMS DNS resolution timed out", address.host, true));
+		} else {
+			i++;
+			continue;
+		}
+		resolving[i] = std::move(resolving.back());
+		resolving.pop_back();
+	}
+	for (auto &entry : finished) {
+		if (entry.first.call->hedge && entry.first.call->hedge->done) {
+			// Its sibling answered while it waited
+			endpoints.OnCallStarted(entry.first.endpoint);
+			endpoints.OnCallCancelled(entry.first.endpoint);
+			continue;
+		}
+		Connect(std::move(entry.first.call), entry.first.endpoint, std::move(entry.second));
+	}
+}
+
+void HmsAsyncClient::StartCall(Connection &connection, std::unique_ptr<Call> call) {
+	connection.call = std::move(call);
+	connection.sent = 0;
+	connection.received.clear();
+	connection.reply_bytes = 0;
+	connection.scanner.Reset();
+	connection.streaming = static_cast<bool>(connection.call->parse_list.element);
+	connection.stream.Reset();
+	connection.call->started_at = std::chrono::steady_clock::now();
+	TouchDeadline(connection);
+	endpoints.OnCallStarted(connection.endpoint);
+	poller->Watch(connection.fd, true, false);
+}
+
+void HmsAsyncClient::HandleWritable(Connection &connection) {
+	auto &request = connection.call->request;
+	while (connection.sent < request.size()) {
+		auto sent = send(connection.fd, request.data() + connection.sent, request.size() - connection.sent,
+		                 HMS_SEND_FLAGS);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return;
+			}
+			FailCall(connection, MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
+			                                                 "Failed to send HMS request", strerror(errno), true));
+			return;
+		}
+		connection.sent += static_cast<size_t>(sent);
+		TouchDeadline(connection);
+	}
+	poller->Watch(connection.fd, false, false);
+}
+
+void HmsAsyncClient::HandleReadable(Connection &connection) {
+	auto &received = connection.received;
+	bool peer_closed = false;
+	while (true) {
+		auto old_size = received.size();
+		received.resize(old_size + HMS_RECV_CHUNK_SIZE);
+		auto count = recv(connection.fd, received.data() + old_size, HMS_RECV_CHUNK_SIZE, 0);
+		if (count > 0) {
+			received.resize(old_size + static_cast<size_t>(count));
+			connection.reply_bytes += static_cast<size_t>(count);
+			TouchDeadline(connection);
+			if (connection.streaming && !PumpListReply(connection)) {
+				return;
+			}
+			if (received.size() > config.max_reply_bytes) {
+				FailCall(connection, MetastoreResult<int>::Error(
+				                         MetastoreErrorCode::Transient, "HMS reply exceeds the reply memory limit",
+				                         "more than " + std::to_string(config.max_reply_bytes) +
+				                             " bytes would have to be buffered; raise MAX_REPLY_MB",
+				                         false));
+				return;
+			}
+			continue;
+		}
+		received.resize(old_size);
+		if (count == 0) {
+			peer_closed = true;
+			break;
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			break;
+		}
+		FailCall(connection, MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS response read failed",
+		                                                 strerror(errno), true));
+		return;
+	}
+
+	if (connection.streaming) {
+		if (peer_closed) {
+			FailCall(connection, MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS response read failed",
+			                                                 "connection closed by server", true));
+		}
+		return;
+	}
+	auto status = connection.scanner.Feed(received.data(), received.size());
+	if (status == ThriftMessageScanner::Status::Malformed) {
+		FailCall(connection,
+		         MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true));
+		return;
+	}
+	if (status == ThriftMessageScanner::Status::NeedMore) {
+		if (peer_closed) {
+			FailCall(connection, MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS response read failed",
+			                                                 "connection closed by server", true));
+		}
+		return;
+	}
+	if (connection.scanner.MessageSize() != received.size()) {
+		// Only one call is outstanding per connection, so trailing bytes mean the stream is out of sync
+		FailCall(connection, MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
+		                                                 "Unexpected data after HMS reply", "", true));
+		return;
+	}
+	CompleteCall(connection);
+}
+
+void HmsAsyncClient::CompleteCall(Connection &connection) {
+	auto &call = *connection.call;
+	ThriftReader reader(connection.received.data(), connection.received.size());
+	std::string method;
+	ThriftMessageType message_type;
+	int32_t seqid;
+	auto result = ReadThriftMessageHeader(reader, method, message_type, seqid);
+	if (result.IsOk()) {
+		if (seqid != call.seqid || method != call.method) {
+			result = MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS reply header mismatch", "", true);
+		} else if (message_type == ThriftMessageType::Exception) {
+			result = ParseApplicationException(reader);
+		} else if (message_type != ThriftMessageType::Reply) {
+			result = MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Unexpected HMS reply type", "", true);
+		} else {
+			result = call.parse_reply(reader);
+		}
+	}
+	FinishReply(connection, std::move(result));
+}
+
+bool HmsAsyncClient::PumpListReply(Connection &connection) {
+	auto &received = connection.received;
+	auto &stream = connection.stream;
+	auto &call = *connection.call;
+	while (true) {
+		switch (stream.Next(received.data(), received.size())) {
+		case ThriftListReplyStream::Event::NeedMore:
+			// Only the element still being received is kept
+			if (stream.Consumed() > 0) {
+				received.erase(received.begin(), received.begin() + static_cast<std::ptrdiff_t>(stream.Consumed()));
+				stream.Discard(stream.Consumed());
+			}
+			return true;
+		case ThriftListReplyStream::Event::NotStreamable:
+			connection.streaming = false;
+			return true;
+		case ThriftListReplyStream::Event::Malformed:
+			FailCall(connection,
+			         MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true));
+			return false;
+		case ThriftListReplyStream::Event::ListBegin: {
+			ThriftReader reader(received.data(), received.size());
+			std::string method;
+			ThriftMessageType message_type;
+			int32_t seqid;
+			auto header = ReadThriftMessageHeader(reader, method, message_type, seqid);
+			if (header.IsOk() && (seqid != call.seqid || method != call.method)) {
+				header = MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "HMS reply header mismatch", "",
+				                                         true);
+			}
+			if (!header.IsOk()) {
+				FailCall(connection, MetastoreResult<int>::Error(header.error.code, std::move(header.error.message),
+				                                                 std::move(header.error.detail), header.error.retryable));
+				return false;
+			}
+			if (call.parse_list.begin) {
+				call.parse_list.begin(stream.ElementCount());
+			}
+			break;
+		}
+		case ThriftListReplyStream::Event::Element: {
+			ThriftReader reader(received.data() + stream.ElementBegin(), stream.Consumed() - stream.ElementBegin());
+			auto parsed = call.parse_list.element(reader);
+			if (!parsed.IsOk()) {
+				// The rest of the reply is still on the wire, so the connection cannot be reused
+				FailCall(connection, std::move(parsed));
+				return false;
+			}
+			break;
+		}
+		case ThriftListReplyStream::Event::End:
+			if (stream.Consumed() != received.size()) {
+				FailCall(connection, MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
+				                                                 "Unexpected data after HMS reply", "", true));
+				return false;
+			}
+			FinishReply(connection, MetastoreResult<int>::Success(0));
+			return false;
+		}
+	}
+}
+
+void HmsAsyncClient::FinishReply(Connection &connection, MetastoreResult<int> result) {
+	auto call = std::move(connection.call);
+	// Errors the metastore answered with (e.g. no such table) still mean the instance is healthy
+	endpoints.OnCallFinished(connection.endpoint, result.IsOk() || !result.error.retryable,
+	                         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+	                                                                               call->started_at));
+
+	// The whole reply was consumed, so the connection sits at a message boundary and goes back to
+	// the pool. The next queued call is placed like any other: it picks this connection up again only
+	// if the endpoint set chooses this instance for it, so a hedge copy never lands next to its
+	// sibling and queued calls keep being balanced across instances.
+	CloseConnection(connection, true);
+	Dispatch();
+	FinishCall(std::move(call), std::move(result));
+}
+
+void HmsAsyncClient::FailCall(Connection &connection, MetastoreResult<int> error) {
+	auto call = std::move(connection.call);
+	// A pooled connection the server closed while idle fails before any reply byte arrives; all
+	// HMS calls made here are reads, so replaying them once on a fresh connection is safe.
+	bool replay = connection.reused && connection.reply_bytes == 0 && !call->replayed;
+	if (replay) {
+		// A stale socket says nothing about the server, so it must not count toward the circuit breaker:
+		// after a restart, a burst over the pooled connections would otherwise open it against a healthy one
+		endpoints.OnCallCancelled(connection.endpoint);
+	} else {
+		endpoints.OnCallFinished(connection.endpoint, false,
+		                         std::chrono::duration_cast<std::chrono::microseconds>(
+		                             std::chrono::steady_clock::now() - call->started_at));
+	}
+	CloseConnection(connection, false);
+	if (replay) {
+		call->replayed = true;
+		queue.push_front(std::move(call));
+		return;
+	}
+	FinishCall(std::move(call), std::move(error));
+}
+
+void HmsAsyncClient::FinishCall(std::unique_ptr<Call> call, MetastoreResult<int> result) {
+	auto &stats = HmsRpcStats::Global();
+	auto hedge = call->hedge;
+	if (hedge) {
+		if (hedge->done) {
+			return;
+		}
+		// While the other copy is still out, a transport failure of this one is not the call's outcome
+		if (!result.IsOk() && result.error.code == MetastoreErrorCode::Transient && hedge->outstanding > 1) {
+			hedge->outstanding--;
+			return;
+		}
+	}
+	if (!result.IsOk() && result.error.retryable && config.retry.ShouldRetry(call->attempts)) {
+		if (HmsRetryBudget::Global().TryAcquireRetry()) {
+			auto delay_ms = config.retry.ComputeJitteredDelay(call->attempts, UnitRandom());
+			stats.retries++;
+			stats.retry_delay_ms += delay_ms;
+			call->attempts++;
+			call->replayed = false;
+			delayed.emplace_back(std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms),
+			                     std::move(call));
+			return;
+		}
+		stats.retries_denied++;
+	}
+	if (!result.IsOk()) {
+		stats.failures++;
+	}
+	if (hedge) {
+		hedge->done = true;
+		if (result.IsOk() && call->hedge_copy) {
+			stats.hedge_wins++;
+		}
+		CancelSiblings(hedge);
+	}
+	call->on_complete(std::move(result));
+}
+
+std::chrono::steady_clock::time_point
+HmsAsyncClient::StartHedges(std::chrono::steady_clock::time_point now) {
+	auto next_check = std::chrono::steady_clock::time_point::max();
+	if (config.hedge_percentile == 0 || endpoints.Size() < 2 || !queue.empty()) {
+		return next_check;
+	}
+	auto delay = endpoints.LatencyPercentile(config.hedge_percentile);
+	if (delay.count() == 0) {
+		// Not enough history yet to tell a slow call from a normal one
+		return next_check;
+	}
+	delay = std::max(delay, std::chrono::microseconds(HMS_MIN_HEDGE_DELAY_US));
+	for (auto &entry : connections) {
+		auto &connection = *entry.second;
+		auto &call = connection.call;
+		if (!call || !call->hedgeable || call->hedge) {
+			continue;
+		}
+		auto hedge_at = call->started_at + delay;
+		if (hedge_at > now) {
+			next_check = std::min(next_check, hedge_at);
+			continue;
+		}
+		// Hedges only use spare connection slots; they never delay calls that have not been sent yet
+		if (connections.size() + resolving.size() + queue.size() >= max_connections) {
+			break;
+		}
+		call->hedge = std::make_shared<HedgeGroup>();
+		auto copy = std::unique_ptr<Call>(new Call());
+		copy->method = call->method;
+		copy->seqid = call->seqid;
+		copy->request = call->request;
+		copy->parse_reply = call->parse_reply;
+		copy->on_complete = call->on_complete;
+		copy->attempts = call->attempts;
+		copy->hedgeable = true;
+		copy->hedge_copy = true;
+		copy->avoid_endpoint = connection.endpoint;
+		copy->hedge = call->hedge;
+		queue.push_back(std::move(copy));
+		HmsRpcStats::Global().hedges++;
+	}
+	return next_check;
+}
+
+void HmsAsyncClient::CancelSiblings(const std::shared_ptr<HedgeGroup> &hedge) {
+	std::vector<int> sibling_fds;
+	for (auto &entry : connections) {
+		if (entry.second->call && entry.second->call->hedge == hedge) {
+			sibling_fds.push_back(entry.first);
+		}
+	}
+	for (auto fd : sibling_fds) {
+		auto &connection = *connections[fd];
+		endpoints.OnCallCancelled(connection.endpoint);
+		connection.call.reset();
+		// The reply may already be on its way, so the connection is not at a message boundary
+		CloseConnection(connection, false);
+	}
+	for (auto it = queue.begin(); it != queue.end();) {
+		it = (*it)->hedge == hedge ? queue.erase(it) : it + 1;
+	}
+	for (size_t i = 0; i < resolving.size();) {
+		if (resolving[i].call->hedge != hedge) {
+			i++;
+			continue;
+		}
+		endpoints.OnCallStarted(resolving[i].endpoint);
+		endpoints.OnCallCancelled(resolving[i].endpoint);
+		resolving[i] = std::move(resolving.back());
+		resolving.pop_back();
+	}
+	for (size_t i = 0; i < delayed.size();) {
+		if (delayed[i].second->hedge != hedge) {
+			i++;
+			continue;
+		}
+		delayed[i] = std::move(delayed.back());
+		delayed.pop_back();
+	}
+}
+
+void HmsAsyncClient::PromoteDelayed(std::chrono::steady_clock::time_point now) {
+	for (size_t i = 0; i < delayed.size();) {
+		if (delayed[i].first > now) {
+			i++;
+			continue;
+		}
+		queue.push_front(std::move(delayed[i].second));
+		delayed[i] = std::move(delayed.back());
+		delayed.pop_back();
+	}
+}
+
+void HmsAsyncClient::TouchDeadline(Connection &connection) {
+	auto timeout_ms = connection.connecting ? config.connection_timeout_ms : config.read_timeout_ms;
+	connection.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+}
+
+bool HmsAsyncClient::AbortIfStopped() {
+	if (!control) {
+		return false;
+	}
+	MetastoreResult<int> error;
+	if (control->IsCancelled()) {
+		error = MetastoreResult<int>::Error(MetastoreErrorCode::Cancelled, "Metastore call interrupted");
+	} else if (std::chrono::steady_clock::now() >= control->deadline) {
+		error = MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Metastore call deadline exceeded",
+		                                    "metastore_rpc_timeout elapsed", false);
+	} else {
+		return false;
+	}
+	// Completions may submit follow-up calls; they fail the same way
+	while (!connections.empty() || !resolving.empty() || !queue.empty() || !delayed.empty()) {
+		std::vector<std::unique_ptr<Call>> calls;
+		for (auto &entry : connections) {
+			auto &connection = *entry.second;
+			CloseAttempts(connection);
+			poller->Remove(connection.fd);
+			close(connection.fd);
+			if (connection.call) {
+				endpoints.OnCallCancelled(connection.endpoint);
+				calls.push_back(std::move(connection.call));
+			}
+		}
+		connections.clear();
+		for (auto &pending : resolving) {
+			endpoints.OnCallStarted(pending.endpoint);
+			endpoints.OnCallCancelled(pending.endpoint);
+			calls.push_back(std::move(pending.call));
+		}
+		resolving.clear();
+		for (auto &call : queue) {
+			calls.push_back(std::move(call));
+		}
+		queue.clear();
+		for (auto &entry : delayed) {
+			calls.push_back(std::move(entry.second));
+		}
+		delayed.clear();
+		for (auto &call : calls) {
+			if (call->hedge) {
+				if (call->hedge->done) {
+					continue;
+				}
+				call->hedge->done = true;
+			}
+			HmsRpcStats::Global().failures++;
+			call->on_complete(error);
+		}
+	}
+	return true;
+}
+
+void HmsAsyncClient::CloseConnection(Connection &connection, bool return_to_pool) {
+	auto fd = connection.fd;
+	CloseAttempts(connection);
+	poller->Remove(fd);
+	if (return_to_pool) {
+		endpoints.Pool(connection.endpoint).Release(fd);
+	} else {
+		close(fd);
+	}
+	connections.erase(fd);
+}
+
+void HmsAsyncClient::Run() {
+	if (!poller->IsValid()) {
+		while (!queue.empty()) {
+			auto call = std::move(queue.front());
+			queue.pop_front();
+			HmsRpcStats::Global().failures++;
+			call->on_complete(MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
+			                                              "Failed to create HMS event loop", strerror(errno), true));
+		}
+		return;
+	}
+
+	std::vector<int> ready;
+	std::vector<int> expired;
+	if (AbortIfStopped()) {
+		return;
+	}
+	Dispatch();
+	while (!connections.empty() || !resolving.empty() || !delayed.empty()) {
+		if (AbortIfStopped()) {
+			return;
+		}
+		auto now = std::chrono::steady_clock::now();
+		auto next_hedge = StartHedges(now);
+		Dispatch();
+		auto next_deadline = std::min(now + std::chrono::milliseconds(config.read_timeout_ms), next_hedge);
+		for (auto &entry : connections) {
+			auto &connection = *entry.second;
+			next_deadline = std::min(next_deadline, connection.deadline);
+			if (connection.connecting && connection.next_address < connection.addresses->size()) {
+				next_deadline = std::min(next_deadline, connection.next_attempt_at);
+			}
+		}
+		for (auto &entry : delayed) {
+			next_deadline = std::min(next_deadline, entry.first);
+		}
+		for (auto &pending : resolving) {
+			next_deadline = std::min(next_deadline, pending.deadline);
+		}
+		if (control) {
+			next_deadline = std::min(next_deadline, control->deadline);
+			if (control->is_cancelled) {
+				next_deadline = std::min(next_deadline, now + std::chrono::milliseconds(HMS_CANCEL_POLL_MS));
+			}
+		}
+		auto wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(next_deadline - now).count() + 1;
+		poller->Wait(static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait_ms, INT_MAX))), ready);
+
+		for (auto fd : ready) {
+			if (lookup_signal && fd == lookup_signal->ReadFd()) {
+				lookup_signal->Drain();
+				continue;
+			}
+			auto owner = attempt_owner.find(fd);
+			auto it = connections.find(owner == attempt_owner.end() ? fd : owner->second);
+			if (it == connections.end()) {
+				continue;
+			}
+			auto &connection = *it->second;
+			if (connection.connecting) {
+				if (!FinishConnect(connection, fd) || connection.connecting) {
+					continue;
+				}
+			} else if (fd != connection.fd) {
+				continue;
+			}
+			if (connection.sent < connection.call->request.size()) {
+				HandleWritable(connection);
+			} else {
+				HandleReadable(connection);
+			}
+		}
+
+		// Fail calls whose connection did not connect, or made no progress, in time
+		now = std::chrono::steady_clock::now();
+		expired.clear();
+		for (auto &entry : connections) {
+			if (entry.second->deadline <= now) {
+				expired.push_back(entry.first);
+			}
+		}
+		for (auto fd : expired) {
+			auto it = connections.find(fd);
+			if (it != connections.end()) {
+				auto message = it->second->connecting ? "HMS connect timed out" : "HMS request timed out";
+				FailCall(*it->second, MetastoreResult<int>::Error(MetastoreErrorCode::Transient, message, "", true));
+			}
+		}
+		StartRacingAttempts(now);
+		ResumeLookups(now);
+		PromoteDelayed(now);
+		Dispatch();
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "hms/hms_config.hpp"
+#include "hms/hms_endpoint_set.hpp"
+#include "hms/hms_resolver.hpp"
+#include "hms/hms_thrift.hpp"
+#include "metastore_call_scope.hpp"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//! Parses the body of a successful reply (positioned after the message header)
+using HmsReplyParser = std::function<MetastoreResult<int>(ThriftReader &)>;
+//! Receives the outcome of a call: the parser's result, or the transport / protocol error
+using HmsCallCompletion = std::function<void(MetastoreResult<int>)>;
+
+//! Receives the elements of a list<struct> reply as they arrive
+struct HmsListReplyParser {
+	//! Called with the element count before the first element of every attempt, so whatever an
+	//! earlier attempt of the call left behind can be dropped
+	std::function<void(size_t count)> begin;
+	//! Parses one element; the reader holds exactly that element
+	std::function<MetastoreResult<int>(ThriftReader &element)> element;
+};
+
+//! Delay before a slow connect attempt is raced by one to the next address (RFC 8305 recommends 250 ms)
+static constexpr uint32_t HMS_CONNECT_ATTEMPT_DELAY_MS = 250;
+
+//===--------------------------------------------------------------------===//
+// HmsAsyncClient — event-driven Thrift client with many calls in flight
+//
+// Calls are queued with Submit() and executed by Run(), which multiplexes
+// up to max_connections non-blocking sockets (epoll on Linux, poll(2)
+// elsewhere) on the calling thread. Each connection carries one call at a
+// time — HMS serves a connection's requests strictly in order, so more
+// parallelism comes from more connections, not pipelining — and every
+// reply is matched to its call by seqid and method name before it is
+// parsed. Each call goes to the instance the HmsEndpointSet picks, and its
+// connection comes from and returns to that instance's HmsConnectionPool;
+// a pooled connection that fails before any reply byte arrives is replayed
+// once on a fresh connection. Fresh connections resolve their host through
+// the HmsResolver cache; a call whose host has to be looked up waits, without
+// a connection and without blocking the loop, for a background lookup (at
+// most config.connection_timeout_ms). They connect Happy-Eyeballs style: when
+// an attempt has not completed after HMS_CONNECT_ATTEMPT_DELAY_MS, the next
+// address is tried in parallel and the first socket to connect wins. A call submitted as hedgeable that is still
+// unanswered after config.hedge_percentile of recent latencies is also sent
+// to another instance when a connection slot is free; the first reply wins
+// and the other copy's connection is closed. Calls that still fail
+// with a retryable error are retried per config.retry after a jittered
+// backoff, as long as the process-wide HmsRetryBudget allows; waiting calls
+// do not hold a connection or block other calls. A connect attempt fails
+// after config.connection_timeout_ms, and an open call whose connection
+// sends and receives nothing for config.read_timeout_ms fails as well. When
+// every instance's circuit breaker is open, calls fail without being sent.
+//
+// The client picks up the MetastoreCallScope of the thread that creates it.
+// Once that query is interrupted or its metadata deadline passes, Run()
+// closes every open connection (they are mid-call, so not pooled) and
+// fails all remaining calls without retrying them.
+//
+// Replies are buffered until complete, except for calls submitted with
+// SubmitListCall(): their list elements are parsed as they arrive and the
+// bytes dropped, so the buffer holds one element however long the list.
+// Either way, a call fails once more than config.max_reply_bytes of its
+// reply would have to be held at once.
+//
+// A client is driven by one thread at a time. Parsers and completions run
+// on that thread inside Run() and may Submit() follow-up calls.
+//===--------------------------------------------------------------------===//
+class HmsAsyncClient {
+public:
+	HmsAsyncClient(const HmsConfig &config, HmsEndpointSet &endpoints, size_t max_connections);
+	~HmsAsyncClient();
+
+	HmsAsyncClient(const HmsAsyncClient &) = delete;
+	HmsAsyncClient &operator=(const HmsAsyncClient &) = delete;
+
+	//! Queue a call. `build_args` writes the argument struct fields; `parse_reply` decodes a
+	//! successful reply and its result is passed to `on_complete`. Only idempotent reads whose parser
+	//! may run again after a failed attempt should be `hedgeable`.
+	void Submit(const std::string &method, const std::function<void(ThriftWriter &)> &build_args,
+	            HmsReplyParser parse_reply, HmsCallCompletion on_complete, bool hedgeable = false);
+
+	//! Queue a call whose reply is a list of structs. Each element is handed to `parse_list` as soon
+	//! as it has been received; replies of another shape (exceptions, an empty result) are buffered
+	//! and go to `parse_reply`. Never hedged, since two copies would interleave their elements.
+	void SubmitListCall(const std::string &method, const std::function<void(ThriftWriter &)> &build_args,
+	                    HmsListReplyParser parse_list, HmsReplyParser parse_reply, HmsCallCompletion on_complete);
+
+	//! Drive I/O until every submitted call (including ones submitted by completions) finished.
+	void Run();
+
+private:
+	//! The copies of one hedged call
+	struct HedgeGroup {
+		//! Copies that have not failed yet
+		uint32_t outstanding = 2;
+		bool done = false;
+	};
+
+	struct Call {
+		std::string method;
+		int32_t seqid = 0;
+		std::vector<uint8_t> request;
+		HmsReplyParser parse_reply;
+		//! Set for calls whose list reply is parsed element by element
+		HmsListReplyParser parse_list;
+		HmsCallCompletion on_complete;
+		//! Set once the call was re-queued after a stale pooled connection failed
+		bool replayed = false;
+		//! Attempts made so far, including the one in progress
+		uint32_t attempts = 1;
+		//! May be sent to a second instance when slow
+		bool hedgeable = false;
+		//! This is the second copy of a hedged call
+		bool hedge_copy = false;
+		//! Instance the call should avoid (the one its sibling copy went to)
+		size_t avoid_endpoint = HmsEndpointSet::NO_ENDPOINT;
+		std::chrono::steady_clock::time_point started_at;
+		//! Shared by both copies once the call was hedged
+		std::shared_ptr<HedgeGroup> hedge;
+	};
+
+	struct Connection {
+		int fd = -1;
+		//! Instance in the endpoint set
+		size_t endpoint = 0;
+		//! Non-blocking connect still in progress
+		bool connecting = false;
+		//! Taken from the pool rather than freshly connected
+		bool reused = false;
+		//! Resolved addresses of the instance and the next one to try
+		HmsAddressList addresses;
+		size_t next_address = 0;
+		//! Connect attempts racing the one on `fd`
+		std::vector<int> racing;
+		//! When to start another parallel attempt if none has connected yet
+		std::chrono::steady_clock::time_point next_attempt_at;
+		std::unique_ptr<Call> call;
+		size_t sent = 0;
+		//! Reply bytes not parsed yet
+		std::vector<uint8_t> received;
+		//! Reply bytes received in total, including ones already parsed and dropped
+		size_t reply_bytes = 0;
+		ThriftMessageScanner scanner;
+		//! The reply is being parsed element by element
+		bool streaming = false;
+		ThriftListReplyStream stream;
+		std::chrono::steady_clock::time_point deadline;
+	};
+
+	//! A call waiting for its instance's host to be looked up
+	struct PendingLookup {
+		size_t endpoint;
+		std::unique_ptr<Call> call;
+		std::chrono::steady_clock::time_point deadline;
+	};
+
+	void Dispatch();
+	//! Open a fresh connection to `endpoint` at the resolved addresses and start the call on it
+	void Connect(std::unique_ptr<Call> call, size_t endpoint, MetastoreResult<HmsAddressList> resolved);
+	//! Park the call until a background lookup of its instance's host finishes; false if the loop could
+	//! not be woken up for it
+	bool AwaitLookup(std::unique_ptr<Call> &call, size_t endpoint);
+	//! Connect the parked calls whose lookup finished and fail those that waited too long
+	void ResumeLookups(std::chrono::steady_clock::time_point now);
+	//! Start a non-blocking connect to the connection's next untried address; returns the socket or an error
+	MetastoreResult<int> ConnectNext(Connection &connection, bool &in_progress);
+	//! Start another connect attempt in parallel for every connection whose attempts are slow
+	void StartRacingAttempts(std::chrono::steady_clock::time_point now);
+	//! Attempt `fd` of a connecting connection became writable. Returns false if the call failed
+	//! (and the connection is gone).
+	bool FinishConnect(Connection &connection, int fd);
+	//! Close the connection's racing attempts
+	void CloseAttempts(Connection &connection);
+	//! Move the connection to another socket in the connection map
+	void Rekey(Connection &connection, int new_fd);
+	void StartCall(Connection &connection, std::unique_ptr<Call> call);
+	void HandleWritable(Connection &connection);
+	void HandleReadable(Connection &connection);
+	void CompleteCall(Connection &connection);
+	//! Hand the list elements received so far to the call's parser. Returns false if the call
+	//! finished or failed (the connection may be gone).
+	bool PumpListReply(Connection &connection);
+	//! The reply was fully consumed: pool the connection, place the next queued call and report the outcome
+	void FinishReply(Connection &connection, MetastoreResult<int> result);
+	void FailCall(Connection &connection, MetastoreResult<int> error);
+	//! Hand the outcome to the call's completion, or schedule a retry for a retryable failure
+	void FinishCall(std::unique_ptr<Call> call, MetastoreResult<int> result);
+	//! Send a copy of every slow hedgeable call to another instance; returns the next time to check
+	std::chrono::steady_clock::time_point StartHedges(std::chrono::steady_clock::time_point now);
+	//! Drop the other copy of a hedged call that just succeeded
+	void CancelSiblings(const std::shared_ptr<HedgeGroup> &hedge);
+	//! Move retries whose backoff elapsed to the front of the queue
+	void PromoteDelayed(std::chrono::steady_clock::time_point now);
+	//! If the scope's query was interrupted or ran past its deadline, fail every call; returns whether it did
+	bool AbortIfStopped();
+	void CloseConnection(Connection &connection, bool return_to_pool);
+	//! Restart the connection's inactivity deadline (connect or read timeout, depending on its state)
+	void TouchDeadline(Connection &connection);
+
+	class Poller;
+	class LookupSignal;
+
+	const HmsConfig &config;
+	HmsEndpointSet &endpoints;
+	size_t max_connections;
+	int32_t next_seqid = 1;
+	std::deque<std::unique_ptr<Call>> queue;
+	//! Calls waiting out their retry backoff, with the time they may be sent again
+	std::vector<std::pair<std::chrono::steady_clock::time_point, std::unique_ptr<Call>>> delayed;
+	std::unordered_map<int, std::unique_ptr<Connection>> connections;
+	//! Calls parked until the addresses of their instance are known
+	std::vector<PendingLookup> resolving;
+	//! Created with the first background lookup
+	std::shared_ptr<LookupSignal> lookup_signal;
+	//! Racing connect attempt socket -> socket its connection is keyed by
+	std::unordered_map<int, int> attempt_owner;
+	std::unique_ptr<Poller> poller;
+	//! Cancellation and deadline of the query the calls are made for; null when nothing can stop them
+	std::shared_ptr<const MetastoreCallControl> control;
+};
+
+} // namespace duckdb
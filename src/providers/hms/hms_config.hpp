@@ -1,9 +1,12 @@
 #pragma once
 
 #include "metastore_errors.hpp"
+#include "hms/hms_retry.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace duckdb {
 
@@ -26,18 +29,42 @@ inline const char *HmsTransportToString(HmsTransport transport) {
 	}
 }
 
+//! One HMS instance of a (possibly replicated) metastore
+struct HmsEndpoint {
+	std::string host;
+	uint16_t port = 9083;
+};
+
 //===--------------------------------------------------------------------===//
 // HmsConfig — parsed HMS endpoint configuration
 //===--------------------------------------------------------------------===//
 struct HmsConfig {
-	//! Hostname or IP of the HMS Thrift server
+	//! Hostname or IP of the HMS Thrift server (the first one when several are configured)
 	std::string endpoint;
 	//! Wire transport (plain Thrift or TLS)
 	HmsTransport transport = HmsTransport::Thrift;
-	//! Connection timeout in milliseconds
-	uint32_t connection_timeout_ms = 30000;
+	//! How long a TCP connect may take before the attempt fails
+	uint32_t connection_timeout_ms = 5000;
+	//! How long a connection may go without sending or receiving a byte while a call is open
+	uint32_t read_timeout_ms = 10000;
 	//! HMS Thrift port (default: 9083)
 	uint16_t port = 9083;
+	//! Maximum calls a single connector operation keeps in flight (one connection each)
+	uint32_t max_inflight_requests = 8;
+	//! Backoff for calls that fail with a retryable error
+	HmsRetryPolicy retry;
+	//! Every configured HMS instance, in URI order; calls are balanced across them
+	std::vector<HmsEndpoint> endpoints;
+	//! Latency percentile of recent calls after which an idempotent read is also sent to a second
+	//! instance, first reply wins; 0 disables hedging
+	uint32_t hedge_percentile = 0;
+	//! Consecutive failures after which an instance's circuit breaker opens; 0 disables the breaker
+	uint32_t breaker_failure_threshold = 5;
+	//! How long an open breaker rejects calls before letting a single probe call through
+	uint32_t breaker_open_ms = 5000;
+	//! Most bytes of one reply held in memory at once: the whole reply, or for streamed list replies
+	//! the element being received
+	size_t max_reply_bytes = size_t(256) << 20;
 };
 
 //===--------------------------------------------------------------------===//
@@ -48,6 +75,9 @@ struct HmsConfig {
 //   thrift+ssl://hostname:9083   -> ThriftTLS transport
 //   hostname:9083                -> bare host:port, defaults to Thrift
 //   hostname                     -> bare host, defaults to Thrift + port 9083
+//   thrift://h1:9083,h2:9083     -> several instances of one metastore; the
+//                                   scheme may be given once or per instance
+//                                   but must not differ between them
 //
 // Throws MetastoreException with InvalidConfig on malformed URI.
 //===--------------------------------------------------------------------===//
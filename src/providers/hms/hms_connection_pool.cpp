@@ -0,0 +1,54 @@
+#include "hms/hms_connection_pool.hpp"
+
+#include <unistd.h>
+#include <unordered_map>
+
+namespace duckdb {
+
+HmsConnectionPool::~HmsConnectionPool() {
+	for (auto fd : idle) {
+		close(fd);
+	}
+}
+
+std::shared_ptr<HmsConnectionPool> HmsConnectionPool::ForEndpoint(const std::string &host, uint16_t port) {
+	static std::mutex registry_lock;
+	static std::unordered_map<std::string, std::shared_ptr<HmsConnectionPool>> registry;
+
+	auto key = host + ":" + std::to_string(port);
+	std::lock_guard<std::mutex> guard(registry_lock);
+	auto &pool = registry[key];
+	if (!pool) {
+		pool = std::make_shared<HmsConnectionPool>();
+	}
+	return pool;
+}
+
+int HmsConnectionPool::TryAcquire() {
+	std::lock_guard<std::mutex> guard(lock);
+	if (idle.empty()) {
+		return -1;
+	}
+	// LIFO: the most recently used connection is the least likely to have been closed by the server
+	auto fd = idle.back();
+	idle.pop_back();
+	return fd;
+}
+
+void HmsConnectionPool::Release(int fd) {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (idle.size() < max_idle) {
+			idle.push_back(fd);
+			return;
+		}
+	}
+	close(fd);
+}
+
+size_t HmsConnectionPool::IdleCount() {
+	std::lock_guard<std::mutex> guard(lock);
+	return idle.size();
+}
+
+} // namespace duckdb
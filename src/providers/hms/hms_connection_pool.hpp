@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// HmsConnectionPool — idle Thrift connections to one HMS endpoint
+//
+// Pools are shared process-wide per host:port, so every HmsConnector that
+// talks to the same metastore reuses the same sockets. Connections are only
+// handed back after a reply was fully consumed; a connection that fails
+// mid-call is closed instead of being returned.
+//===--------------------------------------------------------------------===//
+class HmsConnectionPool {
+public:
+	explicit HmsConnectionPool(size_t max_idle_p = 16) : max_idle(max_idle_p) {
+	}
+	~HmsConnectionPool();
+
+	HmsConnectionPool(const HmsConnectionPool &) = delete;
+	HmsConnectionPool &operator=(const HmsConnectionPool &) = delete;
+
+	//! Get the shared pool for an endpoint, creating it on first use.
+	static std::shared_ptr<HmsConnectionPool> ForEndpoint(const std::string &host, uint16_t port);
+
+	//! Take an idle connection. Returns -1 if none is available.
+	int TryAcquire();
+	//! Return a healthy connection; closes it if the pool is already full.
+	void Release(int fd);
+
+	size_t IdleCount();
+
+private:
+	std::mutex lock;
+	std::vector<int> idle;
+	size_t max_idle;
+};
+
+} // namespace duckdb
@@ -1,599 +1,297 @@
 #include "hms/hms_connector.hpp"
+#include "hms/hms_async_client.hpp"
+#include "hms/hms_decode.hpp"
 #include "hms/hms_mapper.hpp"
+#include "hms/hms_partition_name.hpp"
+#include "hms/hms_thrift.hpp"
 
-#include <arpa/inet.h>
-#include <cerrno>
+#include <algorithm>
 #include <cstdint>
-#include <cstring>
-#include <netdb.h>
-#include <optional>
-#include <sstream>
 #include <functional>
-#include <sys/socket.h>
-#include <unistd.h>
+#include <optional>
 
 namespace duckdb {
 
 namespace {
 
-enum class ThriftType : uint8_t {
-	Stop = 0,
-	Void = 1,
-	Bool = 2,
-	Byte = 3,
-	Double = 4,
-	I16 = 6,
-	I32 = 8,
-	I64 = 10,
-	String = 11,
-	Struct = 12,
-	Map = 13,
-	Set = 14,
-	List = 15
-};
-
-enum class ThriftMessageType : uint8_t {
-	Call = 1,
-	Reply = 2,
-	Exception = 3
-};
-
-static constexpr int32_t THRIFT_VERSION_1 = 0x80010000;
-
-class SocketHandle {
-public:
-	explicit SocketHandle(int fd_p) : fd(fd_p) {
-	}
-	~SocketHandle() {
-		if (fd >= 0) {
-			close(fd);
-		}
-	}
-	SocketHandle(const SocketHandle &) = delete;
-	SocketHandle &operator=(const SocketHandle &) = delete;
-	int fd;
-};
-
-class ThriftWriter {
-public:
-	void WriteByte(uint8_t v) {
-		buffer.push_back(v);
-	}
-
-	void WriteI16(int16_t v) {
-		buffer.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
-		buffer.push_back(static_cast<uint8_t>(v & 0xFF));
-	}
-
-	void WriteI32(int32_t v) {
-		buffer.push_back(static_cast<uint8_t>((v >> 24) & 0xFF));
-		buffer.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
-		buffer.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
-		buffer.push_back(static_cast<uint8_t>(v & 0xFF));
-	}
-
-	void WriteString(const std::string &s) {
-		WriteI32(static_cast<int32_t>(s.size()));
-		buffer.insert(buffer.end(), s.begin(), s.end());
-	}
-
-	void WriteMessageBegin(const std::string &name, ThriftMessageType message_type, int32_t seqid) {
-		WriteI32(THRIFT_VERSION_1 | static_cast<int32_t>(message_type));
-		WriteString(name);
-		WriteI32(seqid);
-	}
-
-	void WriteFieldBegin(ThriftType type, int16_t field_id) {
-		WriteByte(static_cast<uint8_t>(type));
-		WriteI16(field_id);
-	}
-
-	void WriteFieldStop() {
-		WriteByte(static_cast<uint8_t>(ThriftType::Stop));
-	}
-
-	void WriteStructBegin() {
-	}
-
-	void WriteStructEnd() {
-	}
-
-	const std::vector<uint8_t> &Data() const {
-		return buffer;
-	}
-
-private:
-	std::vector<uint8_t> buffer;
-};
-
-class ThriftReader {
-public:
-	explicit ThriftReader(int fd_p) : fd(fd_p) {
-	}
-
-	bool ReadExact(uint8_t *dst, size_t n) {
-		size_t off = 0;
-		while (off < n) {
-			ssize_t read_count = recv(fd, dst + off, n - off, 0);
-			if (read_count <= 0) {
-				return false;
-			}
-			off += static_cast<size_t>(read_count);
-		}
-		return true;
-	}
-
-	bool ReadByte(uint8_t &out) {
-		return ReadExact(&out, 1);
-	}
-
-	bool ReadI16(int16_t &out) {
-		uint8_t b[2];
-		if (!ReadExact(b, sizeof(b))) {
-			return false;
-		}
-		out = static_cast<int16_t>((static_cast<int16_t>(b[0]) << 8) | static_cast<int16_t>(b[1]));
-		return true;
-	}
-
-	bool ReadI32(int32_t &out) {
-		uint8_t b[4];
-		if (!ReadExact(b, sizeof(b))) {
-			return false;
-		}
-		out = (static_cast<int32_t>(b[0]) << 24) | (static_cast<int32_t>(b[1]) << 16) |
-		      (static_cast<int32_t>(b[2]) << 8) | static_cast<int32_t>(b[3]);
-		return true;
-	}
-
-	bool ReadI64(int64_t &out) {
-		uint8_t b[8];
-		if (!ReadExact(b, sizeof(b))) {
-			return false;
-		}
-		out = (static_cast<int64_t>(b[0]) << 56) | (static_cast<int64_t>(b[1]) << 48) |
-		      (static_cast<int64_t>(b[2]) << 40) | (static_cast<int64_t>(b[3]) << 32) |
-		      (static_cast<int64_t>(b[4]) << 24) | (static_cast<int64_t>(b[5]) << 16) |
-		      (static_cast<int64_t>(b[6]) << 8) | static_cast<int64_t>(b[7]);
-		return true;
-	}
+//! Largest decode arena a thread keeps between replies
+static constexpr size_t HMS_DECODE_ARENA_RETAIN_BYTES = 1 << 20;
 
-	bool ReadString(std::string &out) {
-		int32_t len;
-		if (!ReadI32(len) || len < 0) {
-			return false;
-		}
-		out.resize(static_cast<size_t>(len));
-		if (len == 0) {
-			return true;
-		}
-		return ReadExact(reinterpret_cast<uint8_t *>(&out[0]), static_cast<size_t>(len));
-	}
+//! Arena for decoding replies on this thread. Replies are decoded one at a time on the thread that
+//! runs the event loop, and nothing decoded into the arena outlives the reply parser.
+HmsDecodeArena &ReplyArena() {
+	thread_local HmsDecodeArena arena;
+	return arena;
+}
 
-	bool Skip(ThriftType type) {
-		switch (type) {
-		case ThriftType::Stop:
-		case ThriftType::Void:
-			return true;
-		case ThriftType::Bool:
-		case ThriftType::Byte: {
-			uint8_t x;
-			return ReadByte(x);
-		}
-		case ThriftType::I16: {
-			int16_t x;
-			return ReadI16(x);
-		}
-		case ThriftType::I32: {
-			int32_t x;
-			return ReadI32(x);
-		}
-		case ThriftType::I64: {
-			int64_t x;
-			return ReadI64(x);
-		}
-		case ThriftType::Double: {
-			uint8_t d[8];
-			return ReadExact(d, sizeof(d));
-		}
-		case ThriftType::String: {
-			std::string s;
-			return ReadString(s);
-		}
-		case ThriftType::Struct: {
-			while (true) {
-				uint8_t field_type_raw;
-				if (!ReadByte(field_type_raw)) {
-					return false;
-				}
-				auto field_type = static_cast<ThriftType>(field_type_raw);
-				if (field_type == ThriftType::Stop) {
-					return true;
-				}
-				int16_t field_id;
-				if (!ReadI16(field_id) || !Skip(field_type)) {
-					return false;
-				}
-			}
+//! Parse a MetaException / NoSuchObjectException reply field into an error.
+template <typename T>
+MetastoreResult<T> ParseRemoteException(ThriftReader &reader, int16_t field_id) {
+	std::string message;
+	while (true) {
+		uint8_t field_type_raw;
+		if (!reader.ReadByte(field_type_raw)) {
+			return MetastoreResult<T>::Error(MetastoreErrorCode::Transient, "Malformed HMS exception", "", true);
 		}
-		case ThriftType::Map: {
-			uint8_t key_type_raw, val_type_raw;
-			int32_t count;
-			if (!ReadByte(key_type_raw) || !ReadByte(val_type_raw) || !ReadI32(count) || count < 0) {
-				return false;
-			}
-			auto key_type = static_cast<ThriftType>(key_type_raw);
-			auto val_type = static_cast<ThriftType>(val_type_raw);
-			for (int32_t i = 0; i < count; i++) {
-				if (!Skip(key_type) || !Skip(val_type)) {
-					return false;
-				}
-			}
-			return true;
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			break;
 		}
-		case ThriftType::Set:
-		case ThriftType::List: {
-			uint8_t elem_type_raw;
-			int32_t count;
-			if (!ReadByte(elem_type_raw) || !ReadI32(count) || count < 0) {
-				return false;
-			}
-			auto elem_type = static_cast<ThriftType>(elem_type_raw);
-			for (int32_t i = 0; i < count; i++) {
-				if (!Skip(elem_type)) {
-					return false;
-				}
-			}
-			return true;
+		int16_t exception_field_id;
+		if (!reader.ReadI16(exception_field_id)) {
+			return MetastoreResult<T>::Error(MetastoreErrorCode::Transient, "Malformed HMS exception", "", true);
 		}
-		default:
-			return false;
+		bool ok = exception_field_id == 1 && field_type == ThriftType::String ? reader.ReadString(message)
+		                                                                       : reader.Skip(field_type);
+		if (!ok) {
+			return MetastoreResult<T>::Error(MetastoreErrorCode::Transient, "Malformed HMS exception", "", true);
 		}
 	}
-
-private:
-	int fd;
-};
-
-bool SendAll(int fd, const std::vector<uint8_t> &buf) {
-	size_t offset = 0;
-	while (offset < buf.size()) {
-		ssize_t sent = send(fd, buf.data() + offset, buf.size() - offset, 0);
-		if (sent <= 0) {
-			return false;
-		}
-		offset += static_cast<size_t>(sent);
+	// By HMS IDL convention o1 is MetaException and o2 is NoSuchObjectException
+	if (field_id == 2) {
+		return MetastoreResult<T>::Error(MetastoreErrorCode::NotFound, "HMS object not found", message, false);
 	}
-	return true;
+	return MetastoreResult<T>::Error(MetastoreErrorCode::Transient, "HMS remote exception", message, false);
 }
 
-MetastoreResult<int> ConnectSocket(const std::string &host, uint16_t port) {
-	addrinfo hints;
-	memset(&hints, 0, sizeof(hints));
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_STREAM;
-
-	addrinfo *results = nullptr;
-	std::string port_string = std::to_string(port);
-	int gai_result = getaddrinfo(host.c_str(), port_string.c_str(), &hints, &results);
-	if (gai_result != 0) {
-		return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS DNS resolution failed",
-		                                   gai_strerror(gai_result), true);
-	}
-
-	int fd = -1;
-	for (addrinfo *addr = results; addr != nullptr; addr = addr->ai_next) {
-		fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
-		if (fd < 0) {
-			continue;
-		}
-		timeval timeout;
-		timeout.tv_sec = 10;
-		timeout.tv_usec = 0;
-		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-		if (connect(fd, addr->ai_addr, addr->ai_addrlen) == 0) {
-			freeaddrinfo(results);
-			return MetastoreResult<int>::Success(fd);
-		}
-		close(fd);
-		fd = -1;
-	}
+//! Decode one Partition struct and append an owned copy; the arena only ever holds one partition
+MetastoreResult<int> AppendDecodedPartition(ThriftReader &reader, std::vector<MetastorePartitionValue> &partitions,
+                                            MetastorePartitionFields fields = MetastorePartitionFields::All) {
+	auto &arena = ReplyArena();
+	HmsPartitionView partition;
+	bool ok = DecodeHmsPartition(reader, arena, partition, fields);
+	if (ok) {
+		partitions.push_back(MaterializeHmsPartition(partition));
+	}
+	arena.Reset(HMS_DECODE_ARENA_RETAIN_BYTES);
+	if (!ok) {
+		return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed to parse HMS partition payload", "",
+		                                   true);
+	}
+	return MetastoreResult<int>::Success(0);
+}
 
-	freeaddrinfo(results);
-	return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS socket connect failed",
-	                                   strerror(errno), true);
+//! Collect a streamed list<Partition> reply into `partitions`, one partition at a time
+HmsListReplyParser PartitionListParser(std::vector<MetastorePartitionValue> &partitions,
+                                       MetastorePartitionFields fields = MetastorePartitionFields::All) {
+	HmsListReplyParser parser;
+	parser.begin = [&partitions](size_t) { partitions.clear(); };
+	parser.element = [&partitions, fields](ThriftReader &reader) {
+		return AppendDecodedPartition(reader, partitions, fields);
+	};
+	return parser;
 }
 
-MetastoreResult<int32_t> ReadMessageHeader(ThriftReader &reader, std::string &method_name,
-	                                        ThriftMessageType &message_type, int32_t &seqid) {
-	int32_t version_and_type;
-	if (!reader.ReadI32(version_and_type)) {
-		return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "HMS response read failed", "", true);
+//! PartitionFilterMode values of a GetPartitionsFilterSpec
+static constexpr int32_t HMS_PARTITION_FILTER_BY_NAMES = 0;
+//! Despite the name, filters in this mode are filter strings as taken by get_partitions_by_filter
+static constexpr int32_t HMS_PARTITION_FILTER_BY_EXPR = 2;
+
+//! Write the GetPartitionsRequest argument of get_partitions_with_specs. Its projection names the
+//! Partition fields the server fills in; the rest, above all each partition's full storage
+//! descriptor, is neither loaded by the metastore nor sent.
+void WriteGetPartitionsRequest(ThriftWriter &writer, const std::string &namespace_name, const std::string &table_name,
+                               MetastorePartitionFields fields, int32_t filter_mode, const std::string *filters,
+                               size_t filter_count) {
+	bool with_parameters = fields == MetastorePartitionFields::All;
+	writer.WriteFieldBegin(ThriftType::Struct, 1);
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString(namespace_name);
+	writer.WriteFieldBegin(ThriftType::String, 3);
+	writer.WriteString(table_name);
+	// GetProjectionsSpec
+	writer.WriteFieldBegin(ThriftType::Struct, 7);
+	writer.WriteFieldBegin(ThriftType::List, 1);
+	writer.WriteListBegin(ThriftType::String, with_parameters ? 3 : 2);
+	writer.WriteString("values");
+	writer.WriteString("sd.location");
+	if (with_parameters) {
+		writer.WriteString("parameters");
 	}
-	if ((version_and_type & 0xFFFF0000) != THRIFT_VERSION_1) {
-		return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Unsupported, "Unsupported Thrift version", "", false);
-	}
-	message_type = static_cast<ThriftMessageType>(version_and_type & 0x000000FF);
-	if (!reader.ReadString(method_name) || !reader.ReadI32(seqid)) {
-		return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "HMS response header parse failed", "", true);
+	writer.WriteFieldStop();
+	// GetPartitionsFilterSpec
+	writer.WriteFieldBegin(ThriftType::Struct, 8);
+	writer.WriteFieldBegin(ThriftType::I32, 7);
+	writer.WriteI32(filter_mode);
+	writer.WriteFieldBegin(ThriftType::List, 8);
+	writer.WriteListBegin(ThriftType::String, static_cast<int32_t>(filter_count));
+	for (size_t i = 0; i < filter_count; i++) {
+		writer.WriteString(filters[i]);
 	}
-	return MetastoreResult<int32_t>::Success(0);
+	writer.WriteFieldStop();
+	writer.WriteFieldStop();
 }
 
-MetastoreResult<int32_t> ParseApplicationException(ThriftReader &reader) {
-	std::string message;
-	int32_t ex_type = 0;
+//! Decode a GetPartitionsResponse ({1: list<PartitionSpec>}) into owned partitions, one spec at a time
+bool ParsePartitionsResponse(ThriftReader &reader, std::vector<MetastorePartitionValue> &partitions,
+                             MetastorePartitionFields fields) {
+	auto &arena = ReplyArena();
 	while (true) {
-		uint8_t field_type_raw;
-		if (!reader.ReadByte(field_type_raw)) {
-			return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
-		}
-		auto field_type = static_cast<ThriftType>(field_type_raw);
-		if (field_type == ThriftType::Stop) {
-			break;
-		}
+		ThriftType field_type;
 		int16_t field_id;
-		if (!reader.ReadI16(field_id)) {
-			return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
-		}
-		if (field_id == 1 && field_type == ThriftType::String) {
-			if (!reader.ReadString(message)) {
-				return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
-			}
-		} else if (field_id == 2 && field_type == ThriftType::I32) {
-			if (!reader.ReadI32(ex_type)) {
-				return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
-			}
-		} else {
-			if (!reader.Skip(field_type)) {
-				return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
-			}
-		}
-	}
-	return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "HMS remote exception", message, true);
-}
-
-bool ParseFieldSchema(ThriftReader &reader, MetastorePartitionColumn &col) {
-	while (true) {
-		uint8_t field_type_raw;
-		if (!reader.ReadByte(field_type_raw)) {
+		if (!reader.ReadFieldBegin(field_type, field_id)) {
 			return false;
 		}
-		auto field_type = static_cast<ThriftType>(field_type_raw);
 		if (field_type == ThriftType::Stop) {
 			return true;
 		}
-		int16_t field_id;
-		if (!reader.ReadI16(field_id)) {
-			return false;
-		}
-		if (field_id == 1 && field_type == ThriftType::String) {
-			if (!reader.ReadString(col.name)) {
+		if (field_id != 1 || field_type != ThriftType::List) {
+			if (!reader.Skip(field_type)) {
 				return false;
 			}
-		} else if (field_id == 2 && field_type == ThriftType::String) {
-			if (!reader.ReadString(col.type)) {
-				return false;
+			continue;
+		}
+		uint8_t elem_type_raw;
+		int32_t count;
+		if (!reader.ReadByte(elem_type_raw) || !reader.ReadI32(count) || count < 0 ||
+		    static_cast<ThriftType>(elem_type_raw) != ThriftType::Struct) {
+			return false;
+		}
+		for (int32_t i = 0; i < count; i++) {
+			HmsPartitionSpecView spec;
+			bool ok = DecodeHmsPartitionSpec(reader, arena, spec, fields);
+			if (ok) {
+				for (auto &partition : spec.shared_partitions) {
+					partitions.push_back(MaterializeHmsPartition(partition, spec.shared_location));
+				}
+				for (auto &partition : spec.partitions) {
+					partitions.push_back(MaterializeHmsPartition(partition));
+				}
 			}
-		} else {
-			if (!reader.Skip(field_type)) {
+			arena.Reset(HMS_DECODE_ARENA_RETAIN_BYTES);
+			if (!ok) {
 				return false;
 			}
 		}
 	}
 }
 
-bool ParseSerdeInfo(ThriftReader &reader, MetastoreStorageDescriptor &sd) {
+//! Parse a get_partitions_with_specs reply into `partitions`
+MetastoreResult<int> ParsePartitionSpecsResult(ThriftReader &reader, std::vector<MetastorePartitionValue> &partitions,
+                                               MetastorePartitionFields fields) {
+	// A retried call parses into the same vector; drop whatever a failed attempt left behind
+	partitions.clear();
+	std::optional<MetastoreResult<int>> result;
 	while (true) {
-		uint8_t field_type_raw;
-		if (!reader.ReadByte(field_type_raw)) {
-			return false;
+		ThriftType field_type;
+		int16_t field_id;
+		if (!reader.ReadFieldBegin(field_type, field_id)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
-		auto field_type = static_cast<ThriftType>(field_type_raw);
 		if (field_type == ThriftType::Stop) {
-			return true;
-		}
-		int16_t field_id;
-		if (!reader.ReadI16(field_id)) {
-			return false;
+			break;
 		}
-		if (field_id == 2 && field_type == ThriftType::String) {
-			std::string serde;
-			if (!reader.ReadString(serde)) {
-				return false;
-			}
-			sd.serde_class = std::move(serde);
-		} else if (field_id == 3 && field_type == ThriftType::Map) {
-			uint8_t key_type_raw, val_type_raw;
-			int32_t count;
-			if (!reader.ReadByte(key_type_raw) || !reader.ReadByte(val_type_raw) || !reader.ReadI32(count) || count < 0) {
-				return false;
-			}
-			auto key_type = static_cast<ThriftType>(key_type_raw);
-			auto val_type = static_cast<ThriftType>(val_type_raw);
-			for (int32_t i = 0; i < count; i++) {
-				if (key_type == ThriftType::String && val_type == ThriftType::String) {
-					std::string key;
-					std::string val;
-					if (!reader.ReadString(key) || !reader.ReadString(val)) {
-						return false;
-					}
-					sd.serde_parameters[std::move(key)] = std::move(val);
-				} else {
-					if (!reader.Skip(key_type) || !reader.Skip(val_type)) {
-						return false;
-					}
-				}
-			}
-		} else {
-			if (!reader.Skip(field_type)) {
-				return false;
+		if (field_id == 0 && field_type == ThriftType::Struct) {
+			if (!ParsePartitionsResponse(reader, partitions, fields)) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
+				                                   "Failed to parse HMS partition payload", "", true);
 			}
+			result = MetastoreResult<int>::Success(0);
+		} else if (field_type == ThriftType::Struct) {
+			result = ParseRemoteException<int>(reader, field_id);
+		} else if (!reader.Skip(field_type)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
 	}
+	if (!result.has_value()) {
+		return MetastoreResult<int>::Error(MetastoreErrorCode::NotFound, "Empty HMS result", "", false);
+	}
+	return std::move(*result);
 }
 
-bool ParseStorageDescriptor(ThriftReader &reader, MetastoreStorageDescriptor &sd) {
+//! Parse a get_table_meta reply ({0: list<TableMeta>}) into `summaries`
+MetastoreResult<int> ParseTableMetaResult(ThriftReader &reader, std::vector<MetastoreTableSummary> &summaries) {
+	summaries.clear();
+	std::optional<MetastoreResult<int>> result;
 	while (true) {
-		uint8_t field_type_raw;
-		if (!reader.ReadByte(field_type_raw)) {
-			return false;
+		ThriftType field_type;
+		int16_t field_id;
+		if (!reader.ReadFieldBegin(field_type, field_id)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
-		auto field_type = static_cast<ThriftType>(field_type_raw);
 		if (field_type == ThriftType::Stop) {
-			return true;
-		}
-		int16_t field_id;
-		if (!reader.ReadI16(field_id)) {
-			return false;
+			break;
 		}
-		if (field_id == 2 && field_type == ThriftType::String) {
-			if (!reader.ReadString(sd.location)) {
-				return false;
-			}
-		} else if (field_id == 1 && field_type == ThriftType::List) {
+		if (field_id == 0 && field_type == ThriftType::List) {
 			uint8_t elem_type_raw;
 			int32_t count;
-			if (!reader.ReadByte(elem_type_raw) || !reader.ReadI32(count) || count < 0) {
-				return false;
+			if (!reader.ReadByte(elem_type_raw) || !reader.ReadI32(count) || count < 0 ||
+			    static_cast<ThriftType>(elem_type_raw) != ThriftType::Struct) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS list payload", "",
+				                                   true);
 			}
-			auto elem_type = static_cast<ThriftType>(elem_type_raw);
+			auto &arena = ReplyArena();
+			summaries.reserve(static_cast<size_t>(count));
 			for (int32_t i = 0; i < count; i++) {
-				if (elem_type == ThriftType::Struct) {
-					MetastoreColumn col;
-					MetastorePartitionColumn parsed_col;
-					if (!ParseFieldSchema(reader, parsed_col)) {
-						return false;
-					}
-					col.name = std::move(parsed_col.name);
-					col.type = std::move(parsed_col.type);
-					sd.columns.push_back(std::move(col));
-				} else {
-					if (!reader.Skip(elem_type)) {
-						return false;
-					}
+				HmsTableMetaView view;
+				bool ok = DecodeHmsTableMeta(reader, arena, view);
+				if (ok) {
+					summaries.push_back(MaterializeHmsTableSummary(view));
+				}
+				arena.Reset(HMS_DECODE_ARENA_RETAIN_BYTES);
+				if (!ok) {
+					return MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
+					                                   "Failed to parse HMS table meta payload", "", true);
 				}
 			}
-		} else if (field_id == 3 && field_type == ThriftType::String) {
-			std::string input_format;
-			if (!reader.ReadString(input_format)) {
-				return false;
-			}
-			sd.input_format = std::move(input_format);
-		} else if (field_id == 4 && field_type == ThriftType::String) {
-			std::string output_format;
-			if (!reader.ReadString(output_format)) {
-				return false;
-			}
-			sd.output_format = std::move(output_format);
-		} else if (field_id == 7 && field_type == ThriftType::Struct) {
-			if (!ParseSerdeInfo(reader, sd)) {
-				return false;
-			}
-		} else {
-			if (!reader.Skip(field_type)) {
-				return false;
-			}
+			result = MetastoreResult<int>::Success(0);
+		} else if (field_type == ThriftType::Struct) {
+			result = ParseRemoteException<int>(reader, field_id);
+		} else if (!reader.Skip(field_type)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
 	}
+	if (!result.has_value()) {
+		return MetastoreResult<int>::Error(MetastoreErrorCode::NotFound, "Empty HMS result", "", false);
+	}
+	return std::move(*result);
 }
 
-bool ParseTableStruct(ThriftReader &reader, MetastoreTable &table) {
+//! Handles the replies of a partition list call that are not streamed: exceptions and empty results
+MetastoreResult<std::vector<MetastorePartitionValue>> ParsePartitionListResult(ThriftReader &reader) {
+	using ResultType = MetastoreResult<std::vector<MetastorePartitionValue>>;
+	std::optional<ResultType> result;
 	while (true) {
 		uint8_t field_type_raw;
 		if (!reader.ReadByte(field_type_raw)) {
-			return false;
+			return ResultType::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
 		auto field_type = static_cast<ThriftType>(field_type_raw);
 		if (field_type == ThriftType::Stop) {
-			return true;
+			break;
 		}
 		int16_t field_id;
 		if (!reader.ReadI16(field_id)) {
-			return false;
+			return ResultType::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
-		if (field_id == 1 && field_type == ThriftType::String) {
-			if (!reader.ReadString(table.name)) {
-				return false;
-			}
-		} else if (field_id == 2 && field_type == ThriftType::String) {
-			if (!reader.ReadString(table.namespace_name)) {
-				return false;
-			}
-		} else if (field_id == 3 && field_type == ThriftType::String) {
-			std::string owner;
-			if (!reader.ReadString(owner)) {
-				return false;
-			}
-			table.owner = std::move(owner);
-		} else if (field_id == 7 && field_type == ThriftType::Struct) {
-			if (!ParseStorageDescriptor(reader, table.storage_descriptor)) {
-				return false;
-			}
-		} else if (field_id == 8 && field_type == ThriftType::List) {
+		if (field_id == 0 && field_type == ThriftType::List) {
 			uint8_t elem_type_raw;
 			int32_t count;
 			if (!reader.ReadByte(elem_type_raw) || !reader.ReadI32(count) || count < 0) {
-				return false;
-			}
-			auto elem_type = static_cast<ThriftType>(elem_type_raw);
-			for (int32_t i = 0; i < count; i++) {
-				if (elem_type == ThriftType::Struct) {
-					MetastorePartitionColumn col;
-					if (!ParseFieldSchema(reader, col)) {
-						return false;
-					}
-					table.partition_spec.columns.push_back(std::move(col));
-				} else {
-					if (!reader.Skip(elem_type)) {
-						return false;
-					}
-				}
+				return ResultType::Error(MetastoreErrorCode::Transient, "Malformed HMS list payload", "", true);
 			}
-		} else if (field_id == 9 && field_type == ThriftType::Map) {
-			uint8_t key_type_raw, val_type_raw;
-			int32_t count;
-			if (!reader.ReadByte(key_type_raw) || !reader.ReadByte(val_type_raw) || !reader.ReadI32(count) || count < 0) {
-				return false;
+			if (static_cast<ThriftType>(elem_type_raw) != ThriftType::Struct) {
+				return ResultType::Error(MetastoreErrorCode::Unsupported, "Unexpected HMS list element type", "",
+				                         false);
 			}
-			auto key_type = static_cast<ThriftType>(key_type_raw);
-			auto val_type = static_cast<ThriftType>(val_type_raw);
+			std::vector<MetastorePartitionValue> partitions;
 			for (int32_t i = 0; i < count; i++) {
-				if (key_type == ThriftType::String && val_type == ThriftType::String) {
-					std::string key;
-					std::string val;
-					if (!reader.ReadString(key) || !reader.ReadString(val)) {
-						return false;
-					}
-					table.properties[std::move(key)] = std::move(val);
-				} else {
-					if (!reader.Skip(key_type) || !reader.Skip(val_type)) {
-						return false;
-					}
+				auto appended = AppendDecodedPartition(reader, partitions);
+				if (!appended.IsOk()) {
+					return ResultType::Error(appended.error.code, std::move(appended.error.message), "", true);
 				}
 			}
-		} else {
-			if (!reader.Skip(field_type)) {
-				return false;
-			}
+			result = ResultType::Success(std::move(partitions));
+		} else if (field_type == ThriftType::Struct) {
+			result = ParseRemoteException<std::vector<MetastorePartitionValue>>(reader, field_id);
+		} else if (!reader.Skip(field_type)) {
+			return ResultType::Error(MetastoreErrorCode::Transient, "Malformed HMS response", "", true);
 		}
 	}
-}
-
-std::vector<std::string> ParsePartitionNameValues(const std::string &partition_name) {
-	std::vector<std::string> values;
-	std::stringstream ss(partition_name);
-	std::string segment;
-	while (std::getline(ss, segment, '/')) {
-		auto eq_pos = segment.find('=');
-		if (eq_pos == std::string::npos || eq_pos + 1 >= segment.size()) {
-			values.push_back(segment);
-		} else {
-			values.push_back(segment.substr(eq_pos + 1));
-		}
+	if (!result.has_value()) {
+		return ResultType::Error(MetastoreErrorCode::NotFound, "Empty HMS result", "", false);
 	}
-	return values;
+	return std::move(*result);
 }
 
 MetastoreResult<std::vector<std::string>> ParseStringListResult(ThriftReader &reader) {
@@ -657,149 +355,135 @@ MetastoreResult<std::vector<std::string>> ParseStringListResult(ThriftReader &re
 	}
 }
 
-template <typename BuildArgs>
-MetastoreResult<int> InvokeRpc(const HmsConfig &config, const std::string &method_name, int32_t seqid,
-	                             BuildArgs build_args, std::function<MetastoreResult<int>(ThriftReader &)> parse_result) {
-	auto sock_result = ConnectSocket(config.endpoint, config.port);
-	if (!sock_result.IsOk()) {
-		return MetastoreResult<int>::Error(sock_result.error.code, std::move(sock_result.error.message),
-		                                  std::move(sock_result.error.detail), sock_result.error.retryable);
-	}
-	SocketHandle socket(sock_result.value);
-
-	ThriftWriter writer;
-	writer.WriteMessageBegin(method_name, ThriftMessageType::Call, seqid);
-	writer.WriteStructBegin();
-	build_args(writer);
-	writer.WriteFieldStop();
-	writer.WriteStructEnd();
-
-	if (!SendAll(socket.fd, writer.Data())) {
-		return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed to send HMS request", "", true);
-	}
+//! Run a single call to completion on a private event loop. A hedgeable call may use a second
+//! connection for its hedged copy.
+MetastoreResult<int> InvokeRpc(const HmsConfig &config, HmsEndpointSet &endpoints, const std::string &method_name,
+                               const std::function<void(ThriftWriter &)> &build_args, HmsReplyParser parse_result,
+                               bool hedgeable = false) {
+	HmsAsyncClient client(config, endpoints, hedgeable ? 2 : 1);
+	MetastoreResult<int> result;
+	client.Submit(
+	    method_name, build_args, std::move(parse_result),
+	    [&](MetastoreResult<int> status) { result = std::move(status); }, hedgeable);
+	client.Run();
+	return result;
+}
 
-	ThriftReader reader(socket.fd);
-	std::string response_method;
-	ThriftMessageType response_type;
-	int32_t response_seqid;
-	auto header_status = ReadMessageHeader(reader, response_method, response_type, response_seqid);
-	if (!header_status.IsOk()) {
-		return header_status;
-	}
-	if (response_type == ThriftMessageType::Exception) {
-		return ParseApplicationException(reader);
-	}
-	if (response_type != ThriftMessageType::Reply) {
-		return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Unexpected HMS reply type", "", true);
-	}
-	if (response_method != method_name || response_seqid != seqid) {
-		return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS reply header mismatch", "", true);
-	}
-	return parse_result(reader);
+//! Run a single list call to completion on a private event loop, its elements streamed to `parse_list`
+MetastoreResult<int> InvokeListRpc(const HmsConfig &config, HmsEndpointSet &endpoints, const std::string &method_name,
+                                   const std::function<void(ThriftWriter &)> &build_args,
+                                   HmsListReplyParser parse_list, HmsReplyParser parse_result) {
+	HmsAsyncClient client(config, endpoints, 1);
+	MetastoreResult<int> result;
+	client.SubmitListCall(method_name, build_args, std::move(parse_list), std::move(parse_result),
+	                      [&](MetastoreResult<int> status) { result = std::move(status); });
+	client.Run();
+	return result;
 }
 
+//! Run a call whose reply is a list<string> to completion
+MetastoreResult<std::vector<std::string>> InvokeStringListRpc(const HmsConfig &config, HmsEndpointSet &endpoints,
+                                                              const std::string &method_name,
+                                                              const std::function<void(ThriftWriter &)> &build_args) {
+	std::vector<std::string> values;
+	auto status = InvokeRpc(config, endpoints, method_name, build_args, [&](ThriftReader &reader) {
+		auto parsed = ParseStringListResult(reader);
+		if (!parsed.IsOk()) {
+			return MetastoreResult<int>::Error(parsed.error.code, std::move(parsed.error.message),
+			                                   std::move(parsed.error.detail), parsed.error.retryable);
+		}
+		values = std::move(parsed.value);
+		return MetastoreResult<int>::Success(0);
+	});
+	if (!status.IsOk()) {
+		return MetastoreResult<std::vector<std::string>>::Error(status.error.code, std::move(status.error.message),
+		                                                       std::move(status.error.detail), status.error.retryable);
+	}
+	return MetastoreResult<std::vector<std::string>>::Success(std::move(values));
 }
 
-HmsConnector::HmsConnector(HmsConfig config) : config_(std::move(config)) {
+//! HMS patterns have no "match everything" default; an empty pattern means all names
+const std::string &HmsPattern(const std::string &pattern) {
+	static const std::string MATCH_ALL = "*";
+	return pattern.empty() ? MATCH_ALL : pattern;
 }
 
-MetastoreResult<std::vector<MetastoreNamespace>> HmsConnector::ListNamespaces() {
-	auto status = InvokeRpc(config_, "get_all_databases", 1,
-	                       [&](ThriftWriter &writer) {},
-	                       [&](ThriftReader &reader) {
-			                   auto parsed = ParseStringListResult(reader);
-			                   if (!parsed.IsOk()) {
-				                   return MetastoreResult<int>::Error(parsed.error.code, std::move(parsed.error.message),
-				                                                     std::move(parsed.error.detail), parsed.error.retryable);
-			                   }
-			                   namespaces_cache = std::move(parsed.value);
-			                   return MetastoreResult<int>::Success(0);
-		                   });
-	if (!status.IsOk()) {
-		return MetastoreResult<std::vector<MetastoreNamespace>>::Error(status.error.code, std::move(status.error.message),
-		                                                              std::move(status.error.detail), status.error.retryable);
-	}
+std::vector<MetastoreNamespace> ToHmsNamespaces(std::vector<std::string> names) {
 	std::vector<MetastoreNamespace> result;
-	result.reserve(namespaces_cache.size());
-	for (auto &name : namespaces_cache) {
+	result.reserve(names.size());
+	for (auto &name : names) {
 		MetastoreNamespace ns;
-		ns.name = name;
+		ns.name = std::move(name);
 		ns.catalog = "hms";
 		result.push_back(std::move(ns));
 	}
-	return MetastoreResult<std::vector<MetastoreNamespace>>::Success(std::move(result));
+	return result;
 }
 
-MetastoreResult<std::vector<std::string>> HmsConnector::ListTables(const std::string &namespace_name) {
-	std::vector<std::string> tables;
-	auto status = InvokeRpc(config_, "get_all_tables", 2,
-	                       [&](ThriftWriter &writer) {
-		                       writer.WriteFieldBegin(ThriftType::String, 1);
-		                       writer.WriteString(namespace_name);
-	                       },
-	                       [&](ThriftReader &reader) {
-		                       auto parsed = ParseStringListResult(reader);
-		                       if (!parsed.IsOk()) {
-			                       return MetastoreResult<int>::Error(parsed.error.code, std::move(parsed.error.message),
-			                                                         std::move(parsed.error.detail), parsed.error.retryable);
-		                       }
-		                       tables = std::move(parsed.value);
-		                       return MetastoreResult<int>::Success(0);
-	                       });
-	if (!status.IsOk()) {
-		return MetastoreResult<std::vector<std::string>>::Error(status.error.code, std::move(status.error.message),
-		                                                       std::move(status.error.detail), status.error.retryable);
+void WriteGetTableArgs(ThriftWriter &writer, const std::string &namespace_name, const std::string &table_name) {
+	writer.WriteFieldBegin(ThriftType::String, 1);
+	writer.WriteString(namespace_name);
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString(table_name);
+}
+
+MetastoreResult<int> ParseGetTableResult(ThriftReader &reader, MetastoreTable &table,
+                                         MetastoreTableFields fields = MetastoreTableFields::All) {
+	// A retried call parses into the same table; drop whatever a failed attempt left behind
+	table = MetastoreTable();
+	bool found_success = false;
+	while (true) {
+		uint8_t field_type_raw;
+		if (!reader.ReadByte(field_type_raw)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS get_table response", "",
+			                                   true);
+		}
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			break;
+		}
+		int16_t field_id;
+		if (!reader.ReadI16(field_id)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS get_table response", "",
+			                                   true);
+		}
+		if (field_id == 0 && field_type == ThriftType::Struct) {
+			auto &arena = ReplyArena();
+			HmsTableView view;
+			bool ok = DecodeHmsTable(reader, arena, view, fields);
+			if (ok) {
+				table.name = std::string(view.name);
+				table.namespace_name = std::string(view.db_name);
+				if (view.owner.has_value()) {
+					table.owner = std::string(*view.owner);
+				}
+				table.storage_descriptor = MaterializeHmsStorageDescriptor(view.storage_descriptor);
+				table.partition_spec = MaterializeHmsPartitionKeys(view.partition_keys);
+				table.properties = MaterializeHmsProperties(view.parameters);
+				table.fields = fields;
+			}
+			arena.Reset(HMS_DECODE_ARENA_RETAIN_BYTES);
+			if (!ok) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed to parse HMS table payload",
+				                                   "", true);
+			}
+			found_success = true;
+		} else {
+			if (!reader.Skip(field_type)) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Malformed HMS get_table response",
+				                                   "", true);
+			}
+		}
 	}
-	return MetastoreResult<std::vector<std::string>>::Success(std::move(tables));
+	if (!found_success) {
+		return MetastoreResult<int>::Error(MetastoreErrorCode::NotFound, "HMS table not found", "", false);
+	}
+	return MetastoreResult<int>::Success(0);
 }
 
-MetastoreResult<MetastoreTable> HmsConnector::GetTable(const std::string &namespace_name,
-                                                       const std::string &table_name) {
-	MetastoreTable table;
-	table.catalog = "hms";
-	auto status = InvokeRpc(config_, "get_table", 3,
-	                       [&](ThriftWriter &writer) {
-		                       writer.WriteFieldBegin(ThriftType::String, 1);
-		                       writer.WriteString(namespace_name);
-		                       writer.WriteFieldBegin(ThriftType::String, 2);
-		                       writer.WriteString(table_name);
-	                       },
-	                       [&](ThriftReader &reader) {
-		                       bool found_success = false;
-		                       while (true) {
-			                       uint8_t field_type_raw;
-			                       if (!reader.ReadByte(field_type_raw)) {
-				                       return MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
-				                                                         "Malformed HMS get_table response", "", true);
-			                       }
-			                       auto field_type = static_cast<ThriftType>(field_type_raw);
-			                       if (field_type == ThriftType::Stop) {
-				                       break;
-			                       }
-			                       int16_t field_id;
-			                       if (!reader.ReadI16(field_id)) {
-				                       return MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
-				                                                         "Malformed HMS get_table response", "", true);
-			                       }
-			                       if (field_id == 0 && field_type == ThriftType::Struct) {
-				                       if (!ParseTableStruct(reader, table)) {
-					                       return MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
-					                                                         "Failed to parse HMS table payload", "", true);
-				                       }
-				                       found_success = true;
-			                       } else {
-				                       if (!reader.Skip(field_type)) {
-					                       return MetastoreResult<int>::Error(MetastoreErrorCode::Transient,
-					                                                         "Malformed HMS get_table response", "", true);
-				                       }
-			                       }
-		                       }
-		                       if (!found_success) {
-			                       return MetastoreResult<int>::Error(MetastoreErrorCode::NotFound, "HMS table not found", "",
-			                                                         false);
-		                       }
-		                       return MetastoreResult<int>::Success(0);
-	                       });
+//! Turn a get_table outcome and its raw payload into the mapped table.
+MetastoreResult<MetastoreTable> FinishTable(MetastoreResult<int> status, const std::string &namespace_name,
+                                            const std::string &table_name, MetastoreTable table) {
 	if (!status.IsOk()) {
 		return MetastoreResult<MetastoreTable>::Error(status.error.code, std::move(status.error.message),
 		                                             std::move(status.error.detail), status.error.retryable);
@@ -811,21 +495,193 @@ MetastoreResult<MetastoreTable> HmsConnector::GetTable(const std::string &namesp
 	}
 	auto final_table = std::move(mapped.value);
 	final_table.owner = std::move(table.owner);
+	final_table.fields = table.fields;
 	return MetastoreResult<MetastoreTable>::Success(std::move(final_table));
 }
 
-MetastoreResult<std::vector<MetastorePartitionValue>>
-HmsConnector::ListPartitions(const std::string &namespace_name, const std::string &table_name,
-                             const std::string &predicate) {
+} // namespace
+
+HmsConnector::HmsConnector(HmsConfig config)
+    : config_(std::move(config)), endpoints_(std::make_shared<HmsEndpointSet>(config_)) {
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>> HmsConnector::ListNamespaces() {
+	auto names = InvokeStringListRpc(config_, *endpoints_, "get_all_databases", [&](ThriftWriter &writer) {});
+	if (!names.IsOk()) {
+		return MetastoreResult<std::vector<MetastoreNamespace>>::Error(names.error.code, std::move(names.error.message),
+		                                                              std::move(names.error.detail), names.error.retryable);
+	}
+	return MetastoreResult<std::vector<MetastoreNamespace>>::Success(ToHmsNamespaces(std::move(names.value)));
+}
+
+MetastoreResult<std::vector<std::string>> HmsConnector::ListTables(const std::string &namespace_name) {
+	return InvokeStringListRpc(config_, *endpoints_, "get_all_tables", [&](ThriftWriter &writer) {
+		writer.WriteFieldBegin(ThriftType::String, 1);
+		writer.WriteString(namespace_name);
+	});
+}
+
+MetastoreResult<std::vector<MetastoreNamespace>> HmsConnector::ListNamespacesMatching(const std::string &pattern) {
+	if (pattern.empty()) {
+		return ListNamespaces();
+	}
+	// The server matches the pattern, so only matching names cross the wire
+	auto names = InvokeStringListRpc(config_, *endpoints_, "get_databases", [&](ThriftWriter &writer) {
+		writer.WriteFieldBegin(ThriftType::String, 1);
+		writer.WriteString(pattern);
+	});
+	if (!names.IsOk()) {
+		return MetastoreResult<std::vector<MetastoreNamespace>>::Error(names.error.code, std::move(names.error.message),
+		                                                              std::move(names.error.detail), names.error.retryable);
+	}
+	return MetastoreResult<std::vector<MetastoreNamespace>>::Success(ToHmsNamespaces(std::move(names.value)));
+}
+
+MetastoreResult<std::vector<std::string>> HmsConnector::ListTablesMatching(const std::string &namespace_name,
+                                                                           const std::string &pattern,
+                                                                           const std::string &table_type) {
+	if (table_type.empty()) {
+		if (pattern.empty()) {
+			return ListTables(namespace_name);
+		}
+		return InvokeStringListRpc(config_, *endpoints_, "get_tables", [&](ThriftWriter &writer) {
+			writer.WriteFieldBegin(ThriftType::String, 1);
+			writer.WriteString(namespace_name);
+			writer.WriteFieldBegin(ThriftType::String, 2);
+			writer.WriteString(pattern);
+		});
+	}
+	if (tables_by_type_supported_.load(std::memory_order_relaxed)) {
+		auto result = InvokeStringListRpc(config_, *endpoints_, "get_tables_by_type", [&](ThriftWriter &writer) {
+			writer.WriteFieldBegin(ThriftType::String, 1);
+			writer.WriteString(namespace_name);
+			writer.WriteFieldBegin(ThriftType::String, 2);
+			writer.WriteString(HmsPattern(pattern));
+			writer.WriteFieldBegin(ThriftType::String, 3);
+			writer.WriteString(table_type);
+		});
+		if (result.IsOk() || !IsHmsUnknownMethodError(result.error)) {
+			return result;
+		}
+		tables_by_type_supported_.store(false, std::memory_order_relaxed);
+	}
+	// Database names cannot contain pattern characters, so the namespace doubles as its own pattern
+	auto summaries = FetchTableMeta(namespace_name, pattern, {table_type});
+	if (!summaries.IsOk()) {
+		if (IsHmsUnknownMethodError(summaries.error)) {
+			return MetastoreResult<std::vector<std::string>>::Error(
+			    MetastoreErrorCode::Unsupported, "Filtering tables by type not supported by this metastore");
+		}
+		return MetastoreResult<std::vector<std::string>>::Error(
+		    summaries.error.code, std::move(summaries.error.message), std::move(summaries.error.detail),
+		    summaries.error.retryable);
+	}
+	std::vector<std::string> tables;
+	tables.reserve(summaries.value.size());
+	for (auto &summary : summaries.value) {
+		tables.push_back(std::move(summary.name));
+	}
+	return MetastoreResult<std::vector<std::string>>::Success(std::move(tables));
+}
+
+MetastoreResult<std::vector<MetastoreTableSummary>>
+HmsConnector::ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+                                 const std::vector<std::string> &table_types) {
+	auto result = FetchTableMeta(namespace_pattern, table_pattern, table_types);
+	if (result.IsOk() || !IsHmsUnknownMethodError(result.error)) {
+		return result;
+	}
+	// One get_databases and a get_tables or get_tables_by_type per namespace instead of a single call
+	return IMetastoreConnector::ListTableSummaries(namespace_pattern, table_pattern, table_types);
+}
+
+MetastoreResult<std::vector<MetastoreTableSummary>>
+HmsConnector::FetchTableMeta(const std::string &namespace_pattern, const std::string &table_pattern,
+                             const std::vector<std::string> &table_types) {
+	if (!table_meta_supported_.load(std::memory_order_relaxed)) {
+		return MetastoreResult<std::vector<MetastoreTableSummary>>::Error(MetastoreErrorCode::Unsupported,
+		                                                                  HMS_UNKNOWN_METHOD_MESSAGE);
+	}
+	std::vector<MetastoreTableSummary> summaries;
+	auto status = InvokeRpc(
+	    config_, *endpoints_, "get_table_meta",
+	    [&](ThriftWriter &writer) {
+		    writer.WriteFieldBegin(ThriftType::String, 1);
+		    writer.WriteString(HmsPattern(namespace_pattern));
+		    writer.WriteFieldBegin(ThriftType::String, 2);
+		    writer.WriteString(HmsPattern(table_pattern));
+		    // An empty type list means every type
+		    writer.WriteFieldBegin(ThriftType::List, 3);
+		    writer.WriteListBegin(ThriftType::String, static_cast<int32_t>(table_types.size()));
+		    for (auto &type : table_types) {
+			    writer.WriteString(type);
+		    }
+	    },
+	    [&](ThriftReader &reader) { return ParseTableMetaResult(reader, summaries); });
+	if (!status.IsOk()) {
+		if (IsHmsUnknownMethodError(status.error)) {
+			table_meta_supported_.store(false, std::memory_order_relaxed);
+		}
+		return MetastoreResult<std::vector<MetastoreTableSummary>>::Error(
+		    status.error.code, std::move(status.error.message), std::move(status.error.detail),
+		    status.error.retryable);
+	}
+	return MetastoreResult<std::vector<MetastoreTableSummary>>::Success(std::move(summaries));
+}
+
+MetastoreResult<MetastoreTable> HmsConnector::GetTable(const std::string &namespace_name,
+                                                       const std::string &table_name) {
+	return GetTableProjected(namespace_name, table_name, MetastoreTableFields::All);
+}
+
+MetastoreResult<MetastoreTable> HmsConnector::GetTableProjected(const std::string &namespace_name,
+                                                                const std::string &table_name,
+                                                                MetastoreTableFields fields) {
+	// The server still sends the whole table; unrequested parts are skipped without being decoded
+	MetastoreTable table;
+	auto status = InvokeRpc(
+	    config_, *endpoints_, "get_table",
+	    [&](ThriftWriter &writer) { WriteGetTableArgs(writer, namespace_name, table_name); },
+	    [&](ThriftReader &reader) { return ParseGetTableResult(reader, table, fields); }, true);
+	return FinishTable(std::move(status), namespace_name, table_name, std::move(table));
+}
+
+std::vector<MetastoreResult<MetastoreTable>> HmsConnector::GetTables(const std::string &namespace_name,
+                                                                     const std::vector<std::string> &table_names) {
+	return GetTablesProjected(namespace_name, table_names, MetastoreTableFields::All);
+}
+
+std::vector<MetastoreResult<MetastoreTable>>
+HmsConnector::GetTablesProjected(const std::string &namespace_name, const std::vector<std::string> &table_names,
+                                 MetastoreTableFields fields) {
+	// One event loop keeps up to max_inflight_requests get_table calls outstanding at once
+	std::vector<MetastoreTable> tables(table_names.size());
+	std::vector<MetastoreResult<MetastoreTable>> results(table_names.size());
+	HmsAsyncClient client(config_, *endpoints_, config_.max_inflight_requests);
+	for (size_t i = 0; i < table_names.size(); i++) {
+		client.Submit(
+		    "get_table", [&, i](ThriftWriter &writer) { WriteGetTableArgs(writer, namespace_name, table_names[i]); },
+		    [&, i](ThriftReader &reader) { return ParseGetTableResult(reader, tables[i], fields); },
+		    [&, i](MetastoreResult<int> status) {
+			    results[i] = FinishTable(std::move(status), namespace_name, table_names[i], std::move(tables[i]));
+		    },
+		    true);
+	}
+	client.Run();
+	return results;
+}
+
+MetastoreResult<std::vector<std::string>> HmsConnector::ListPartitionNames(const std::string &namespace_name,
+                                                                           const std::string &table_name) {
 	std::vector<std::string> partition_names;
-	auto status = InvokeRpc(config_, "get_partition_names", 4,
+	auto status = InvokeRpc(config_, *endpoints_, "get_partition_names",
 	                       [&](ThriftWriter &writer) {
 		                       writer.WriteFieldBegin(ThriftType::String, 1);
 		                       writer.WriteString(namespace_name);
 		                       writer.WriteFieldBegin(ThriftType::String, 2);
 		                       writer.WriteString(table_name);
 		                       writer.WriteFieldBegin(ThriftType::I16, 3);
-		                       writer.WriteI16(5000);
+		                       writer.WriteI16(-1);
 	                       },
 	                       [&](ThriftReader &reader) {
 		                       auto parsed = ParseStringListResult(reader);
@@ -838,18 +694,176 @@ HmsConnector::ListPartitions(const std::string &namespace_name, const std::strin
 	                       });
 	if (!status.IsOk()) {
 		if (status.error.code == MetastoreErrorCode::NotFound) {
-			return MetastoreResult<std::vector<MetastorePartitionValue>>::Success({});
+			return MetastoreResult<std::vector<std::string>>::Success({});
+		}
+		return MetastoreResult<std::vector<std::string>>::Error(status.error.code, std::move(status.error.message),
+		                                                       std::move(status.error.detail), status.error.retryable);
+	}
+	return MetastoreResult<std::vector<std::string>>::Success(std::move(partition_names));
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+HmsConnector::GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+                                   const std::vector<std::string> &partition_names) {
+	return GetPartitionsByNamesProjected(namespace_name, table_name, partition_names, MetastorePartitionFields::All);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+HmsConnector::GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+                                            const std::vector<std::string> &partition_names,
+                                            MetastorePartitionFields fields) {
+	if (partition_names.empty()) {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success({});
+	}
+	if (partition_specs_supported_.load(std::memory_order_relaxed)) {
+		auto result = FetchPartitionsByNames(namespace_name, table_name, partition_names, fields, true);
+		if (result.IsOk() || !IsHmsUnknownMethodError(result.error)) {
+			return result;
 		}
-		return MetastoreResult<std::vector<MetastorePartitionValue>>::Error(status.error.code,
-		                                                                  std::move(status.error.message),
-		                                                                  std::move(status.error.detail),
-		                                                                  status.error.retryable);
+		partition_specs_supported_.store(false, std::memory_order_relaxed);
+	}
+	return FetchPartitionsByNames(namespace_name, table_name, partition_names, fields, false);
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+HmsConnector::FetchPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+                                     const std::vector<std::string> &partition_names, MetastorePartitionFields fields,
+                                     bool with_specs) {
+	// All batches go out on one event loop with up to max_inflight_requests connections busy at
+	// once; replies are merged in batch order. Within a batch, get_partitions_with_specs groups
+	// partitions by whether they share the table's storage location.
+	auto batch_count = (partition_names.size() + HMS_PARTITION_BATCH_SIZE - 1) / HMS_PARTITION_BATCH_SIZE;
+	std::vector<std::vector<MetastorePartitionValue>> batch_partitions(batch_count);
+	std::vector<MetastoreResult<int>> batch_status(batch_count);
+	HmsAsyncClient client(config_, *endpoints_, config_.max_inflight_requests);
+	for (size_t batch_idx = 0; batch_idx < batch_count; batch_idx++) {
+		auto begin = batch_idx * HMS_PARTITION_BATCH_SIZE;
+		auto end = std::min(partition_names.size(), begin + HMS_PARTITION_BATCH_SIZE);
+		auto on_complete = [&, batch_idx](MetastoreResult<int> status) { batch_status[batch_idx] = std::move(status); };
+		if (with_specs) {
+			client.Submit(
+			    "get_partitions_with_specs",
+			    [&, begin, end](ThriftWriter &writer) {
+				    WriteGetPartitionsRequest(writer, namespace_name, table_name, fields, HMS_PARTITION_FILTER_BY_NAMES,
+				                              partition_names.data() + begin, end - begin);
+			    },
+			    [&, batch_idx](ThriftReader &reader) {
+				    return ParsePartitionSpecsResult(reader, batch_partitions[batch_idx], fields);
+			    },
+			    std::move(on_complete));
+			continue;
+		}
+		client.SubmitListCall(
+		    "get_partitions_by_names",
+		    [&, begin, end](ThriftWriter &writer) {
+			    writer.WriteFieldBegin(ThriftType::String, 1);
+			    writer.WriteString(namespace_name);
+			    writer.WriteFieldBegin(ThriftType::String, 2);
+			    writer.WriteString(table_name);
+			    writer.WriteFieldBegin(ThriftType::List, 3);
+			    writer.WriteListBegin(ThriftType::String, static_cast<int32_t>(end - begin));
+			    for (auto i = begin; i < end; i++) {
+				    writer.WriteString(partition_names[i]);
+			    }
+		    },
+		    PartitionListParser(batch_partitions[batch_idx], fields),
+		    [&, batch_idx](ThriftReader &reader) {
+			    auto parsed = ParsePartitionListResult(reader);
+			    if (!parsed.IsOk()) {
+				    return MetastoreResult<int>::Error(parsed.error.code, std::move(parsed.error.message),
+				                                      std::move(parsed.error.detail), parsed.error.retryable);
+			    }
+			    batch_partitions[batch_idx] = std::move(parsed.value);
+			    return MetastoreResult<int>::Success(0);
+		    },
+		    std::move(on_complete));
+	}
+	client.Run();
+
+	std::vector<MetastorePartitionValue> partitions;
+	partitions.reserve(partition_names.size());
+	for (size_t batch_idx = 0; batch_idx < batch_count; batch_idx++) {
+		auto &status = batch_status[batch_idx];
+		if (!status.IsOk()) {
+			return MetastoreResult<std::vector<MetastorePartitionValue>>::Error(
+			    status.error.code, std::move(status.error.message), std::move(status.error.detail),
+			    status.error.retryable);
+		}
+		for (auto &partition : batch_partitions[batch_idx]) {
+			partitions.push_back(std::move(partition));
+		}
+	}
+	return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(partitions));
+}
+
+MetastoreResult<std::vector<MetastorePartitionValue>>
+HmsConnector::ListPartitions(const std::string &namespace_name, const std::string &table_name,
+                             const std::string &predicate) {
+	if (!predicate.empty()) {
+		std::vector<MetastorePartitionValue> partitions;
+		if (partition_specs_supported_.load(std::memory_order_relaxed)) {
+			auto status = InvokeRpc(
+			    config_, *endpoints_, "get_partitions_with_specs",
+			    [&](ThriftWriter &writer) {
+				    WriteGetPartitionsRequest(writer, namespace_name, table_name, MetastorePartitionFields::All,
+				                              HMS_PARTITION_FILTER_BY_EXPR, &predicate, 1);
+			    },
+			    [&](ThriftReader &reader) {
+				    return ParsePartitionSpecsResult(reader, partitions, MetastorePartitionFields::All);
+			    });
+			if (status.IsOk()) {
+				return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(partitions));
+			}
+			if (!IsHmsUnknownMethodError(status.error)) {
+				return MetastoreResult<std::vector<MetastorePartitionValue>>::Error(
+				    status.error.code, std::move(status.error.message), std::move(status.error.detail),
+				    status.error.retryable);
+			}
+			partition_specs_supported_.store(false, std::memory_order_relaxed);
+		}
+		auto status = InvokeListRpc(config_, *endpoints_, "get_partitions_by_filter",
+		                           [&](ThriftWriter &writer) {
+			                           writer.WriteFieldBegin(ThriftType::String, 1);
+			                           writer.WriteString(namespace_name);
+			                           writer.WriteFieldBegin(ThriftType::String, 2);
+			                           writer.WriteString(table_name);
+			                           writer.WriteFieldBegin(ThriftType::String, 3);
+			                           writer.WriteString(predicate);
+			                           writer.WriteFieldBegin(ThriftType::I16, 4);
+			                           writer.WriteI16(-1);
+		                           },
+		                           PartitionListParser(partitions),
+		                           [&](ThriftReader &reader) {
+			                           auto parsed = ParsePartitionListResult(reader);
+			                           if (!parsed.IsOk()) {
+				                           return MetastoreResult<int>::Error(parsed.error.code, std::move(parsed.error.message),
+				                                                                 std::move(parsed.error.detail), parsed.error.retryable);
+			                           }
+			                           partitions = std::move(parsed.value);
+			                           return MetastoreResult<int>::Success(0);
+		                           });
+		if (!status.IsOk()) {
+			return MetastoreResult<std::vector<MetastorePartitionValue>>::Error(status.error.code,
+			                                                                  std::move(status.error.message),
+			                                                                  std::move(status.error.detail),
+			                                                                  status.error.retryable);
+		}
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(partitions));
+	}
+
+	auto names_result = ListPartitionNames(namespace_name, table_name);
+	if (!names_result.IsOk()) {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Error(names_result.error.code,
+		                                                                  std::move(names_result.error.message),
+		                                                                  std::move(names_result.error.detail),
+		                                                                  names_result.error.retryable);
 	}
 	std::vector<MetastorePartitionValue> result;
-	result.reserve(partition_names.size());
-	for (auto &name : partition_names) {
+	result.reserve(names_result.value.size());
+	HmsPartitionNameParser parser;
+	for (auto &name : names_result.value) {
 		MetastorePartitionValue pv;
-		pv.values = ParsePartitionNameValues(name);
+		ParseHmsPartitionName(parser, name, pv);
 		result.push_back(std::move(pv));
 	}
 	return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(result));
@@ -857,7 +871,7 @@ HmsConnector::ListPartitions(const std::string &namespace_name, const std::strin
 
 MetastoreResult<MetastoreTableProperties> HmsConnector::GetTableStats(const std::string &namespace_name,
                                                                       const std::string &table_name) {
-	auto table_result = GetTable(namespace_name, table_name);
+	auto table_result = GetTableProjected(namespace_name, table_name, MetastoreTableFields::Properties);
 	if (!table_result.IsOk()) {
 		return MetastoreResult<MetastoreTableProperties>::Error(table_result.error.code,
 		                                                       std::move(table_result.error.message),
@@ -892,39 +906,36 @@ static bool ParsePort(const std::string &port_str, uint16_t &port_out) {
 	return true;
 }
 
-HmsConfig ParseHmsEndpoint(const std::string &endpoint) {
+//! Parse one "[scheme://]host[:port]" item; `has_scheme` reports whether the scheme was explicit
+static HmsEndpoint ParseHmsEndpointItem(const std::string &item, const std::string &uri, HmsTransport &transport,
+                                        bool &has_scheme) {
 	MetastoreErrorTag tag {"hms", "ParseHmsEndpoint", false};
 
-	if (endpoint.empty()) {
-		throw MetastoreException(MetastoreErrorCode::InvalidConfig, tag,
-		                         "HMS endpoint URI is empty");
-	}
-
-	HmsConfig config;
 	std::string remainder;
 
 	// Detect and strip scheme
 	const std::string thrift_ssl_scheme = "thrift+ssl://";
 	const std::string thrift_scheme = "thrift://";
 
-	if (endpoint.size() >= thrift_ssl_scheme.size() &&
-	    endpoint.substr(0, thrift_ssl_scheme.size()) == thrift_ssl_scheme) {
-		config.transport = HmsTransport::ThriftTLS;
-		remainder = endpoint.substr(thrift_ssl_scheme.size());
-	} else if (endpoint.size() >= thrift_scheme.size() &&
-	           endpoint.substr(0, thrift_scheme.size()) == thrift_scheme) {
-		config.transport = HmsTransport::Thrift;
-		remainder = endpoint.substr(thrift_scheme.size());
+	has_scheme = true;
+	if (item.size() >= thrift_ssl_scheme.size() && item.substr(0, thrift_ssl_scheme.size()) == thrift_ssl_scheme) {
+		transport = HmsTransport::ThriftTLS;
+		remainder = item.substr(thrift_ssl_scheme.size());
+	} else if (item.size() >= thrift_scheme.size() && item.substr(0, thrift_scheme.size()) == thrift_scheme) {
+		transport = HmsTransport::Thrift;
+		remainder = item.substr(thrift_scheme.size());
 	} else {
-		config.transport = HmsTransport::Thrift;
-		remainder = endpoint;
+		transport = HmsTransport::Thrift;
+		remainder = item;
+		has_scheme = false;
 	}
 
 	if (remainder.empty()) {
 		throw MetastoreException(MetastoreErrorCode::InvalidConfig, tag,
-		                         "HMS endpoint URI has no host: '" + endpoint + "'");
+		                         "HMS endpoint URI has no host: '" + uri + "'");
 	}
 
+	HmsEndpoint result;
 	// Split host:port
 	auto colon_pos = remainder.rfind(':');
 	if (colon_pos != std::string::npos && colon_pos > 0) {
@@ -933,22 +944,59 @@ HmsConfig ParseHmsEndpoint(const std::string &endpoint) {
 
 		uint16_t parsed_port;
 		if (ParsePort(port_part, parsed_port)) {
-			config.endpoint = host_part;
-			config.port = parsed_port;
+			result.host = host_part;
+			result.port = parsed_port;
 		} else {
 			throw MetastoreException(MetastoreErrorCode::InvalidConfig, tag,
-			                         "Invalid port in HMS endpoint URI: '" + endpoint + "'");
+			                         "Invalid port in HMS endpoint URI: '" + uri + "'");
 		}
 	} else {
-		config.endpoint = remainder;
-		config.port = 9083;
+		result.host = remainder;
+		result.port = 9083;
 	}
 
-	if (config.endpoint.empty()) {
+	if (result.host.empty()) {
 		throw MetastoreException(MetastoreErrorCode::InvalidConfig, tag,
-		                         "HMS endpoint URI has empty host: '" + endpoint + "'");
+		                         "HMS endpoint URI has empty host: '" + uri + "'");
+	}
+	return result;
+}
+
+HmsConfig ParseHmsEndpoint(const std::string &endpoint) {
+	MetastoreErrorTag tag {"hms", "ParseHmsEndpoint", false};
+
+	if (endpoint.empty()) {
+		throw MetastoreException(MetastoreErrorCode::InvalidConfig, tag,
+		                         "HMS endpoint URI is empty");
+	}
+
+	HmsConfig config;
+	bool transport_explicit = false;
+	size_t start = 0;
+	while (start <= endpoint.size()) {
+		auto comma = endpoint.find(',', start);
+		auto end = comma == std::string::npos ? endpoint.size() : comma;
+		auto item = endpoint.substr(start, end - start);
+		HmsTransport transport;
+		bool has_scheme;
+		auto address = ParseHmsEndpointItem(item, endpoint, transport, has_scheme);
+		if (has_scheme) {
+			if (transport_explicit && transport != config.transport) {
+				throw MetastoreException(MetastoreErrorCode::InvalidConfig, tag,
+				                         "HMS endpoint URI mixes transports: '" + endpoint + "'");
+			}
+			config.transport = transport;
+			transport_explicit = true;
+		}
+		config.endpoints.push_back(std::move(address));
+		if (comma == std::string::npos) {
+			break;
+		}
+		start = comma + 1;
 	}
 
+	config.endpoint = config.endpoints[0].host;
+	config.port = config.endpoints[0].port;
 	return config;
 }
 
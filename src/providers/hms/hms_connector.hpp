@@ -1,8 +1,12 @@
 #pragma once
 
 #include "hms/hms_config.hpp"
+#include "hms/hms_endpoint_set.hpp"
 #include "metastore_connector.hpp"
 
+#include <atomic>
+#include <memory>
+
 namespace duckdb {
 
 class HmsConnector : public IMetastoreConnector {
@@ -12,17 +16,62 @@ public:
 
 	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespaces() override;
 	MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) override;
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespacesMatching(const std::string &pattern) override;
+	MetastoreResult<std::vector<std::string>> ListTablesMatching(const std::string &namespace_name,
+	                                                             const std::string &pattern,
+	                                                             const std::string &table_type = "") override;
+	MetastoreResult<std::vector<MetastoreTableSummary>>
+	ListTableSummaries(const std::string &namespace_pattern, const std::string &table_pattern,
+	                   const std::vector<std::string> &table_types) override;
 	MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
 	                                         const std::string &table_name) override;
+	MetastoreResult<MetastoreTable> GetTableProjected(const std::string &namespace_name, const std::string &table_name,
+	                                                  MetastoreTableFields fields) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTables(const std::string &namespace_name,
+	                                                       const std::vector<std::string> &table_names) override;
+	std::vector<MetastoreResult<MetastoreTable>> GetTablesProjected(const std::string &namespace_name,
+	                                                                const std::vector<std::string> &table_names,
+	                                                                MetastoreTableFields fields) override;
 	MetastoreResult<std::vector<MetastorePartitionValue>>
 	ListPartitions(const std::string &namespace_name, const std::string &table_name,
 	               const std::string &predicate = "") override;
+	MetastoreResult<std::vector<std::string>> ListPartitionNames(const std::string &namespace_name,
+	                                                             const std::string &table_name) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                     const std::vector<std::string> &partition_names) override;
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+	                              const std::vector<std::string> &partition_names,
+	                              MetastorePartitionFields fields) override;
 	MetastoreResult<MetastoreTableProperties> GetTableStats(const std::string &namespace_name,
 	                                                        const std::string &table_name) override;
 
+	//! Maximum number of partition names sent in one get_partitions_by_names call
+	static constexpr size_t HMS_PARTITION_BATCH_SIZE = 2048;
+
 private:
+	//! Fetch the partitions in batches of HMS_PARTITION_BATCH_SIZE over concurrent connections, with
+	//! get_partitions_with_specs or with get_partitions_by_names
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	FetchPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                       const std::vector<std::string> &partition_names, MetastorePartitionFields fields,
+	                       bool with_specs);
+
+	//! get_table_meta over the patterns; fails with the unknown-method error once the metastore turned out
+	//! not to implement it (before Hive 2.1)
+	MetastoreResult<std::vector<MetastoreTableSummary>> FetchTableMeta(const std::string &namespace_pattern,
+	                                                                   const std::string &table_pattern,
+	                                                                   const std::vector<std::string> &table_types);
+
 	HmsConfig config_;
-	std::vector<std::string> namespaces_cache;
+	std::shared_ptr<HmsEndpointSet> endpoints_;
+	//! Cleared once the metastore turns out not to implement get_partitions_with_specs (before HMS 4.0);
+	//! partitions are then listed with the older calls, which cannot project
+	std::atomic<bool> partition_specs_supported_ {true};
+	//! Cleared once the metastore turns out not to implement get_tables_by_type (before Hive 2.3)
+	std::atomic<bool> tables_by_type_supported_ {true};
+	std::atomic<bool> table_meta_supported_ {true};
 };
 
 } // namespace duckdb
@@ -0,0 +1,282 @@
+#include "hms/hms_decode.hpp"
+#include "hms/hms_partition_name.hpp"
+#include "hms/hms_thrift_codec.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// HmsDecodeArena
+//===--------------------------------------------------------------------===//
+HmsDecodeArena::HmsDecodeArena(size_t initial_chunk_size) : next_chunk_size(initial_chunk_size) {
+}
+
+void *HmsDecodeArena::Allocate(size_t size, size_t alignment) {
+	auto address = reinterpret_cast<uintptr_t>(position);
+	auto padding = (alignment - address % alignment) % alignment;
+	if (!position || static_cast<size_t>(end - position) < size + padding) {
+		auto chunk_size = std::max(next_chunk_size, size + alignment);
+		next_chunk_size = chunk_size * 2;
+		chunks.push_back(Chunk {std::unique_ptr<char[]>(new char[chunk_size]), chunk_size});
+		reserved += chunk_size;
+		position = chunks.back().data.get();
+		end = position + chunk_size;
+		address = reinterpret_cast<uintptr_t>(position);
+		padding = (alignment - address % alignment) % alignment;
+	}
+	auto *result = position + padding;
+	position = result + size;
+	return result;
+}
+
+void HmsDecodeArena::Reset(size_t retain_bytes) {
+	if (chunks.empty()) {
+		return;
+	}
+	// The last chunk is the largest; it alone usually fits the next reply of the same shape
+	auto last = std::move(chunks.back());
+	chunks.clear();
+	reserved = 0;
+	position = nullptr;
+	end = nullptr;
+	if (last.size > retain_bytes) {
+		next_chunk_size = std::min(next_chunk_size, retain_bytes);
+		return;
+	}
+	position = last.data.get();
+	end = position + last.size;
+	reserved = last.size;
+	next_chunk_size = last.size * 2;
+	chunks.push_back(std::move(last));
+}
+
+//===--------------------------------------------------------------------===//
+// Struct codecs, following hive_metastore.thrift
+//===--------------------------------------------------------------------===//
+namespace {
+
+using SdView = HmsStorageDescriptorView;
+
+//! Table and partition fields are grouped by the MetastoreTableFields / MetastorePartitionFields part they fill
+constexpr uint32_t FieldGroup(MetastoreTableFields fields) {
+	return static_cast<uint32_t>(fields);
+}
+constexpr uint32_t FieldGroup(MetastorePartitionFields fields) {
+	return static_cast<uint32_t>(fields);
+}
+
+constexpr HmsThriftField<HmsFieldSchemaView> FIELD_SCHEMA_FIELDS[] = {
+    {1, ThriftType::String, HmsDecodeStringField<HmsFieldSchemaView, &HmsFieldSchemaView::name>},
+    {2, ThriftType::String, HmsDecodeStringField<HmsFieldSchemaView, &HmsFieldSchemaView::type>},
+};
+constexpr HmsThriftStructCodec<HmsFieldSchemaView, HmsMaxFieldId(FIELD_SCHEMA_FIELDS)>
+    FIELD_SCHEMA_CODEC(FIELD_SCHEMA_FIELDS);
+
+//! SerDeInfo fields land in the storage descriptor view that holds the SerDeInfo
+constexpr HmsThriftField<SdView> SERDE_INFO_FIELDS[] = {
+    {2, ThriftType::String, HmsDecodeOptionalStringField<SdView, &SdView::serde_class>},
+    {3, ThriftType::Map, HmsDecodeStringMapField<SdView, &SdView::serde_parameters>,
+     FieldGroup(MetastoreTableFields::SerdeParameters)},
+};
+constexpr HmsThriftStructCodec<SdView, HmsMaxFieldId(SERDE_INFO_FIELDS)> SERDE_INFO_CODEC(SERDE_INFO_FIELDS);
+
+constexpr HmsThriftField<SdView> STORAGE_DESCRIPTOR_FIELDS[] = {
+    {1, ThriftType::List, HmsDecodeStructListField<SdView, HmsFieldSchemaView, &SdView::columns, &FIELD_SCHEMA_CODEC>,
+     FieldGroup(MetastoreTableFields::Columns)},
+    {2, ThriftType::String, HmsDecodeStringField<SdView, &SdView::location>},
+    {3, ThriftType::String, HmsDecodeOptionalStringField<SdView, &SdView::input_format>},
+    {4, ThriftType::String, HmsDecodeOptionalStringField<SdView, &SdView::output_format>},
+    {7, ThriftType::Struct, HmsDecodeInlineStruct<SdView, &SERDE_INFO_CODEC>},
+};
+constexpr HmsThriftStructCodec<SdView, HmsMaxFieldId(STORAGE_DESCRIPTOR_FIELDS)>
+    STORAGE_DESCRIPTOR_CODEC(STORAGE_DESCRIPTOR_FIELDS);
+
+constexpr HmsThriftField<HmsTableView> TABLE_FIELDS[] = {
+    {1, ThriftType::String, HmsDecodeStringField<HmsTableView, &HmsTableView::name>},
+    {2, ThriftType::String, HmsDecodeStringField<HmsTableView, &HmsTableView::db_name>},
+    {3, ThriftType::String, HmsDecodeOptionalStringField<HmsTableView, &HmsTableView::owner>,
+     FieldGroup(MetastoreTableFields::Owner)},
+    {7, ThriftType::Struct,
+     HmsDecodeStructField<HmsTableView, SdView, &HmsTableView::storage_descriptor, &STORAGE_DESCRIPTOR_CODEC>},
+    {8, ThriftType::List,
+     HmsDecodeStructListField<HmsTableView, HmsFieldSchemaView, &HmsTableView::partition_keys, &FIELD_SCHEMA_CODEC>,
+     FieldGroup(MetastoreTableFields::PartitionKeys)},
+    {9, ThriftType::Map, HmsDecodeStringMapField<HmsTableView, &HmsTableView::parameters>,
+     FieldGroup(MetastoreTableFields::Properties)},
+};
+constexpr HmsThriftStructCodec<HmsTableView, HmsMaxFieldId(TABLE_FIELDS)> TABLE_CODEC(TABLE_FIELDS);
+
+//! A partition's storage descriptor, reduced to its location
+constexpr HmsThriftField<HmsPartitionView> PARTITION_LOCATION_FIELDS[] = {
+    {2, ThriftType::String, HmsDecodeStringField<HmsPartitionView, &HmsPartitionView::location>},
+};
+constexpr HmsThriftStructCodec<HmsPartitionView, HmsMaxFieldId(PARTITION_LOCATION_FIELDS)>
+    PARTITION_LOCATION_CODEC(PARTITION_LOCATION_FIELDS);
+
+constexpr HmsThriftField<HmsPartitionView> PARTITION_FIELDS[] = {
+    {1, ThriftType::List, HmsDecodeStringListField<HmsPartitionView, &HmsPartitionView::values>},
+    {6, ThriftType::Struct, HmsDecodeInlineStruct<HmsPartitionView, &PARTITION_LOCATION_CODEC>},
+    {7, ThriftType::Map, HmsDecodeStringMapField<HmsPartitionView, &HmsPartitionView::parameters>,
+     FieldGroup(MetastorePartitionFields::Parameters)},
+};
+constexpr HmsThriftStructCodec<HmsPartitionView, HmsMaxFieldId(PARTITION_FIELDS)> PARTITION_CODEC(PARTITION_FIELDS);
+
+using SpecView = HmsPartitionSpecView;
+using PartitionWithoutSdView = HmsPartitionWithoutSdView;
+
+constexpr HmsThriftField<PartitionWithoutSdView> PARTITION_WITHOUT_SD_FIELDS[] = {
+    {1, ThriftType::List, HmsDecodeStringListField<PartitionWithoutSdView, &PartitionWithoutSdView::values>},
+    {4, ThriftType::String, HmsDecodeStringField<PartitionWithoutSdView, &PartitionWithoutSdView::relative_path>},
+    {5, ThriftType::Map, HmsDecodeStringMapField<PartitionWithoutSdView, &PartitionWithoutSdView::parameters>,
+     FieldGroup(MetastorePartitionFields::Parameters)},
+};
+constexpr HmsThriftStructCodec<PartitionWithoutSdView, HmsMaxFieldId(PARTITION_WITHOUT_SD_FIELDS)>
+    PARTITION_WITHOUT_SD_CODEC(PARTITION_WITHOUT_SD_FIELDS);
+
+//! The shared storage descriptor, reduced to its location
+constexpr HmsThriftField<SpecView> SHARED_SD_LOCATION_FIELDS[] = {
+    {2, ThriftType::String, HmsDecodeStringField<SpecView, &SpecView::shared_location>},
+};
+constexpr HmsThriftStructCodec<SpecView, HmsMaxFieldId(SHARED_SD_LOCATION_FIELDS)>
+    SHARED_SD_LOCATION_CODEC(SHARED_SD_LOCATION_FIELDS);
+
+//! PartitionSpecWithSharedSD
+constexpr HmsThriftField<SpecView> SHARED_SD_SPEC_FIELDS[] = {
+    {1, ThriftType::List,
+     HmsDecodeStructListField<SpecView, PartitionWithoutSdView, &SpecView::shared_partitions,
+                              &PARTITION_WITHOUT_SD_CODEC>},
+    {2, ThriftType::Struct, HmsDecodeInlineStruct<SpecView, &SHARED_SD_LOCATION_CODEC>},
+};
+constexpr HmsThriftStructCodec<SpecView, HmsMaxFieldId(SHARED_SD_SPEC_FIELDS)>
+    SHARED_SD_SPEC_CODEC(SHARED_SD_SPEC_FIELDS);
+
+//! PartitionListComposingSpec
+constexpr HmsThriftField<SpecView> PARTITION_LIST_SPEC_FIELDS[] = {
+    {1, ThriftType::List,
+     HmsDecodeStructListField<SpecView, HmsPartitionView, &SpecView::partitions, &PARTITION_CODEC>},
+};
+constexpr HmsThriftStructCodec<SpecView, HmsMaxFieldId(PARTITION_LIST_SPEC_FIELDS)>
+    PARTITION_LIST_SPEC_CODEC(PARTITION_LIST_SPEC_FIELDS);
+
+constexpr HmsThriftField<SpecView> PARTITION_SPEC_FIELDS[] = {
+    {4, ThriftType::Struct, HmsDecodeInlineStruct<SpecView, &SHARED_SD_SPEC_CODEC>},
+    {5, ThriftType::Struct, HmsDecodeInlineStruct<SpecView, &PARTITION_LIST_SPEC_CODEC>},
+};
+constexpr HmsThriftStructCodec<SpecView, HmsMaxFieldId(PARTITION_SPEC_FIELDS)>
+    PARTITION_SPEC_CODEC(PARTITION_SPEC_FIELDS);
+
+constexpr HmsThriftField<HmsTableMetaView> TABLE_META_FIELDS[] = {
+    {1, ThriftType::String, HmsDecodeStringField<HmsTableMetaView, &HmsTableMetaView::db_name>},
+    {2, ThriftType::String, HmsDecodeStringField<HmsTableMetaView, &HmsTableMetaView::table_name>},
+    {3, ThriftType::String, HmsDecodeStringField<HmsTableMetaView, &HmsTableMetaView::table_type>},
+    {4, ThriftType::String, HmsDecodeOptionalStringField<HmsTableMetaView, &HmsTableMetaView::comments>},
+};
+constexpr HmsThriftStructCodec<HmsTableMetaView, HmsMaxFieldId(TABLE_META_FIELDS)> TABLE_META_CODEC(TABLE_META_FIELDS);
+
+} // namespace
+
+bool DecodeHmsTable(ThriftReader &reader, HmsDecodeArena &arena, HmsTableView &out, MetastoreTableFields fields) {
+	return TABLE_CODEC.Decode(reader, arena, out, FieldGroup(fields));
+}
+
+bool DecodeHmsPartition(ThriftReader &reader, HmsDecodeArena &arena, HmsPartitionView &out,
+                        MetastorePartitionFields fields) {
+	return PARTITION_CODEC.Decode(reader, arena, out, FieldGroup(fields));
+}
+
+bool DecodeHmsPartitionSpec(ThriftReader &reader, HmsDecodeArena &arena, HmsPartitionSpecView &out,
+                            MetastorePartitionFields fields) {
+	return PARTITION_SPEC_CODEC.Decode(reader, arena, out, FieldGroup(fields));
+}
+
+bool DecodeHmsTableMeta(ThriftReader &reader, HmsDecodeArena &arena, HmsTableMetaView &out) {
+	return TABLE_META_CODEC.Decode(reader, arena, out);
+}
+
+//===--------------------------------------------------------------------===//
+// Materialization
+//===--------------------------------------------------------------------===//
+static std::optional<std::string> ToOptionalString(const std::optional<std::string_view> &view) {
+	if (!view.has_value()) {
+		return std::nullopt;
+	}
+	return std::string(*view);
+}
+
+MetastoreTableProperties MaterializeHmsProperties(const HmsArenaArray<HmsStringPairView> &pairs) {
+	MetastoreTableProperties properties;
+	properties.reserve(pairs.size);
+	for (auto &pair : pairs) {
+		// Like a Thrift map decoded into a HashMap, a repeated key keeps its last value
+		properties.insert_or_assign(std::string(pair.key), std::string(pair.value));
+	}
+	return properties;
+}
+
+MetastoreStorageDescriptor MaterializeHmsStorageDescriptor(const HmsStorageDescriptorView &view) {
+	MetastoreStorageDescriptor sd;
+	sd.location = std::string(view.location);
+	sd.columns.reserve(view.columns.size);
+	for (auto &column : view.columns) {
+		sd.columns.push_back(MetastoreColumn {std::string(column.name), std::string(column.type)});
+	}
+	sd.serde_parameters = MaterializeHmsProperties(view.serde_parameters);
+	sd.serde_class = ToOptionalString(view.serde_class);
+	sd.input_format = ToOptionalString(view.input_format);
+	sd.output_format = ToOptionalString(view.output_format);
+	return sd;
+}
+
+MetastorePartitionSpec MaterializeHmsPartitionKeys(const HmsArenaArray<HmsFieldSchemaView> &keys) {
+	MetastorePartitionSpec spec;
+	spec.columns.reserve(keys.size);
+	for (auto &key : keys) {
+		spec.columns.push_back(MetastorePartitionColumn {std::string(key.name), std::string(key.type)});
+	}
+	return spec;
+}
+
+static void MaterializeHmsPartitionValues(const HmsArenaArray<std::string_view> &values,
+                                          MetastorePartitionValue &partition) {
+	partition.values.reserve(values.size);
+	partition.null_values.assign(values.size, false);
+	for (size_t i = 0; i < values.size; i++) {
+		if (values[i] == HIVE_DEFAULT_PARTITION_NAME) {
+			partition.values.emplace_back();
+			partition.null_values[i] = true;
+		} else {
+			partition.values.emplace_back(values[i]);
+		}
+	}
+}
+
+MetastorePartitionValue MaterializeHmsPartition(const HmsPartitionView &view) {
+	MetastorePartitionValue partition;
+	MaterializeHmsPartitionValues(view.values, partition);
+	partition.location = std::string(view.location);
+	partition.parameters = MaterializeHmsProperties(view.parameters);
+	return partition;
+}
+
+MetastorePartitionValue MaterializeHmsPartition(const HmsPartitionWithoutSdView &view,
+                                                std::string_view shared_location) {
+	MetastorePartitionValue partition;
+	MaterializeHmsPartitionValues(view.values, partition);
+	partition.location.reserve(shared_location.size() + view.relative_path.size());
+	partition.location.append(shared_location);
+	partition.location.append(view.relative_path);
+	partition.parameters = MaterializeHmsProperties(view.parameters);
+	return partition;
+}
+
+MetastoreTableSummary MaterializeHmsTableSummary(const HmsTableMetaView &view) {
+	MetastoreTableSummary summary;
+	summary.namespace_name = std::string(view.db_name);
+	summary.name = std::string(view.table_name);
+	summary.table_type = std::string(view.table_type);
+	summary.comment = ToOptionalString(view.comments);
+	return summary;
+}
+
+} // namespace duckdb
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "hms/hms_thrift.hpp"
+#include "metastore_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// HmsDecodeArena — bump allocator for decoding one HMS reply
+//
+// Decoded views and the arrays behind them are carved out of large chunks
+// and released all at once by Reset(), so decoding a reply costs a handful
+// of chunk allocations instead of one malloc per string and map node. Only
+// trivially destructible types may live in the arena.
+//===--------------------------------------------------------------------===//
+class HmsDecodeArena {
+public:
+	explicit HmsDecodeArena(size_t initial_chunk_size = 4096);
+
+	template <typename T>
+	T *AllocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destructed");
+		auto *data = static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+		for (size_t i = 0; i < count; i++) {
+			new (data + i) T();
+		}
+		return data;
+	}
+
+	//! Release everything allocated so far. Keeps the most recent chunk unless it exceeds `retain_bytes`.
+	void Reset(size_t retain_bytes = SIZE_MAX);
+
+	//! Bytes of chunk memory currently held
+	size_t BytesReserved() const {
+		return reserved;
+	}
+
+private:
+	void *Allocate(size_t size, size_t alignment);
+
+	struct Chunk {
+		std::unique_ptr<char[]> data;
+		size_t size;
+	};
+
+	size_t next_chunk_size;
+	std::vector<Chunk> chunks;
+	size_t reserved = 0;
+	char *position = nullptr;
+	char *end = nullptr;
+};
+
+//! Array allocated in an HmsDecodeArena
+template <typename T>
+struct HmsArenaArray {
+	T *data = nullptr;
+	size_t size = 0;
+
+	const T *begin() const {
+		return data;
+	}
+	const T *end() const {
+		return data + size;
+	}
+	const T &operator[](size_t idx) const {
+		return data[idx];
+	}
+	bool empty() const {
+		return size == 0;
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// Decoded views of HMS structs
+//
+// Strings point into the reply buffer and arrays into the arena, so a view
+// is only valid while both are. Callers copy what they keep with the
+// Materialize* functions before either goes away.
+//===--------------------------------------------------------------------===//
+struct HmsStringPairView {
+	std::string_view key;
+	std::string_view value;
+};
+
+struct HmsFieldSchemaView {
+	std::string_view name;
+	std::string_view type;
+};
+
+struct HmsStorageDescriptorView {
+	HmsArenaArray<HmsFieldSchemaView> columns;
+	std::string_view location;
+	std::optional<std::string_view> input_format;
+	std::optional<std::string_view> output_format;
+	std::optional<std::string_view> serde_class;
+	HmsArenaArray<HmsStringPairView> serde_parameters;
+};
+
+struct HmsTableView {
+	std::string_view name;
+	std::string_view db_name;
+	std::optional<std::string_view> owner;
+	HmsStorageDescriptorView storage_descriptor;
+	HmsArenaArray<HmsFieldSchemaView> partition_keys;
+	HmsArenaArray<HmsStringPairView> parameters;
+};
+
+//! Only the partition fields the connector uses; the partition's storage descriptor is reduced to
+//! its location and everything else in it is skipped
+struct HmsPartitionView {
+	HmsArenaArray<std::string_view> values;
+	std::string_view location;
+	HmsArenaArray<HmsStringPairView> parameters;
+};
+
+//! A partition inside a PartitionSpecWithSharedSD: its location is the shared one plus `relative_path`
+struct HmsPartitionWithoutSdView {
+	HmsArenaArray<std::string_view> values;
+	std::string_view relative_path;
+	HmsArenaArray<HmsStringPairView> parameters;
+};
+
+//! A PartitionSpec from get_partitions_with_specs. The server groups partitions stored under the table
+//! location into `shared_partitions`; the others come whole in `partitions`.
+struct HmsPartitionSpecView {
+	std::string_view shared_location;
+	HmsArenaArray<HmsPartitionWithoutSdView> shared_partitions;
+	HmsArenaArray<HmsPartitionView> partitions;
+};
+
+//! A TableMeta from get_table_meta
+struct HmsTableMetaView {
+	std::string_view db_name;
+	std::string_view table_name;
+	std::string_view table_type;
+	std::optional<std::string_view> comments;
+};
+
+//! Decode a Table struct (the reader is positioned after the field header). Parts not in `fields` are
+//! skipped without being decoded.
+bool DecodeHmsTable(ThriftReader &reader, HmsDecodeArena &arena, HmsTableView &out,
+                    MetastoreTableFields fields = MetastoreTableFields::All);
+//! Decode a Partition struct (the reader is positioned after the field header)
+bool DecodeHmsPartition(ThriftReader &reader, HmsDecodeArena &arena, HmsPartitionView &out,
+                        MetastorePartitionFields fields = MetastorePartitionFields::All);
+//! Decode a PartitionSpec struct (the reader is positioned after the field header)
+bool DecodeHmsPartitionSpec(ThriftReader &reader, HmsDecodeArena &arena, HmsPartitionSpecView &out,
+                            MetastorePartitionFields fields = MetastorePartitionFields::All);
+//! Decode a TableMeta struct (the reader is positioned after the field header)
+bool DecodeHmsTableMeta(ThriftReader &reader, HmsDecodeArena &arena, HmsTableMetaView &out);
+
+//! Owned copies of decoded views, sized exactly for the decoded data
+MetastoreStorageDescriptor MaterializeHmsStorageDescriptor(const HmsStorageDescriptorView &view);
+MetastorePartitionSpec MaterializeHmsPartitionKeys(const HmsArenaArray<HmsFieldSchemaView> &keys);
+MetastoreTableProperties MaterializeHmsProperties(const HmsArenaArray<HmsStringPairView> &pairs);
+//! Maps __HIVE_DEFAULT_PARTITION__ values to NULL
+MetastorePartitionValue MaterializeHmsPartition(const HmsPartitionView &view);
+MetastorePartitionValue MaterializeHmsPartition(const HmsPartitionWithoutSdView &view,
+                                                std::string_view shared_location);
+MetastoreTableSummary MaterializeHmsTableSummary(const HmsTableMetaView &view);
+
+} // namespace duckdb
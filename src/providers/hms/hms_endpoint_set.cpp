@@ -0,0 +1,198 @@
+#include "hms/hms_endpoint_set.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace duckdb {
+
+namespace {
+
+//! Weight of a new sample in the latency estimate
+static constexpr double HMS_EWMA_ALPHA = 0.3;
+//! Time constant with which an unused instance's estimate decays towards zero
+static constexpr double HMS_EWMA_DECAY_US = 10.0 * 1000 * 1000;
+//! Latency charged for a failed call
+static constexpr int64_t HMS_FAILURE_PENALTY_US = 1000 * 1000;
+//! Recent successful calls kept for percentile estimates
+static constexpr size_t HMS_LATENCY_WINDOW = 256;
+//! Samples needed before percentiles are reported
+static constexpr size_t HMS_MIN_LATENCY_SAMPLES = 20;
+
+int64_t NowMicros() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	           std::chrono::steady_clock::now().time_since_epoch())
+	    .count();
+}
+
+size_t RandomIndex(size_t bound) {
+	thread_local std::mt19937_64 generator(std::random_device {}());
+	return std::uniform_int_distribution<size_t>(0, bound - 1)(generator);
+}
+
+} // namespace
+
+HmsEndpointSet::HmsEndpointSet(const HmsConfig &config)
+    : breaker_failure_threshold(config.breaker_failure_threshold),
+      breaker_open_us(static_cast<int64_t>(config.breaker_open_ms) * 1000) {
+	auto addresses = config.endpoints;
+	if (addresses.empty()) {
+		addresses.push_back(HmsEndpoint {config.endpoint, config.port});
+	}
+	for (auto &address : addresses) {
+		auto state = std::unique_ptr<EndpointState>(new EndpointState());
+		state->address = address;
+		state->pool = HmsConnectionPool::ForEndpoint(address.host, address.port);
+		endpoints.push_back(std::move(state));
+	}
+	samples.reserve(HMS_LATENCY_WINDOW);
+}
+
+double HmsEndpointSet::Score(size_t idx, int64_t now_us) {
+	auto &state = *endpoints[idx];
+	auto idle_us = static_cast<double>(std::max<int64_t>(0, now_us - state.updated_at_us.load()));
+	auto decayed = static_cast<double>(state.ewma_us.load()) * std::exp(-idle_us / HMS_EWMA_DECAY_US);
+	return decayed * static_cast<double>(state.inflight.load() + 1);
+}
+
+size_t HmsEndpointSet::ClaimProbe(size_t exclude, int64_t now_us) {
+	for (size_t idx = 0; idx < endpoints.size(); idx++) {
+		auto &state = *endpoints[idx];
+		auto open_until = state.open_until_us.load();
+		if (idx == exclude || open_until == 0 || now_us < open_until) {
+			continue;
+		}
+		bool expected = false;
+		if (state.probing.compare_exchange_strong(expected, true)) {
+			return idx;
+		}
+	}
+	return NO_ENDPOINT;
+}
+
+size_t HmsEndpointSet::Pick(size_t exclude) {
+	auto now_us = NowMicros();
+	// An instance whose open period is over gets the next call as its probe, so recovery is noticed
+	auto probe = ClaimProbe(exclude, now_us);
+	if (probe != NO_ENDPOINT) {
+		return probe;
+	}
+	std::vector<size_t> candidates;
+	candidates.reserve(endpoints.size());
+	for (size_t idx = 0; idx < endpoints.size(); idx++) {
+		if (endpoints[idx]->open_until_us.load() == 0) {
+			candidates.push_back(idx);
+		}
+	}
+	if (candidates.size() > 1) {
+		candidates.erase(std::remove(candidates.begin(), candidates.end(), exclude), candidates.end());
+	}
+	if (candidates.empty()) {
+		return NO_ENDPOINT;
+	}
+	if (candidates.size() == 1) {
+		return candidates[0];
+	}
+	// Two distinct candidates
+	auto first = RandomIndex(candidates.size());
+	auto second = RandomIndex(candidates.size() - 1);
+	if (second >= first) {
+		second++;
+	}
+	first = candidates[first];
+	second = candidates[second];
+	return Score(second, now_us) < Score(first, now_us) ? second : first;
+}
+
+void HmsEndpointSet::OnCallStarted(size_t idx) {
+	endpoints[idx]->inflight++;
+}
+
+void HmsEndpointSet::OnCallCancelled(size_t idx) {
+	auto &state = *endpoints[idx];
+	state.inflight--;
+	// Nothing was learned, so let the next call probe again
+	state.probing = false;
+}
+
+void HmsEndpointSet::UpdateBreaker(EndpointState &state, bool success, int64_t now_us) {
+	if (breaker_failure_threshold == 0) {
+		return;
+	}
+	if (success) {
+		state.consecutive_failures = 0;
+		state.open_until_us = 0;
+		state.probing = false;
+		return;
+	}
+	auto failures = ++state.consecutive_failures;
+	bool expected = true;
+	if (state.probing.compare_exchange_strong(expected, false)) {
+		// The half-open probe failed: stay open for another period
+		state.open_until_us = now_us + breaker_open_us;
+		HmsRpcStats::Global().breaker_opens++;
+		return;
+	}
+	int64_t closed = 0;
+	if (failures >= breaker_failure_threshold &&
+	    state.open_until_us.compare_exchange_strong(closed, now_us + breaker_open_us)) {
+		HmsRpcStats::Global().breaker_opens++;
+	}
+}
+
+bool HmsEndpointSet::IsOpen(size_t idx) {
+	return endpoints[idx]->open_until_us.load() != 0;
+}
+
+void HmsEndpointSet::OnCallFinished(size_t idx, bool success, std::chrono::microseconds latency) {
+	auto &state = *endpoints[idx];
+	state.inflight--;
+	auto now_us = NowMicros();
+	auto idle_us = static_cast<double>(std::max<int64_t>(0, now_us - state.updated_at_us.load()));
+	auto decayed = static_cast<double>(state.ewma_us.load()) * std::exp(-idle_us / HMS_EWMA_DECAY_US);
+	double updated;
+	if (success) {
+		updated = decayed == 0 ? static_cast<double>(latency.count())
+		                       : decayed + HMS_EWMA_ALPHA * (static_cast<double>(latency.count()) - decayed);
+	} else {
+		updated = std::max(decayed, static_cast<double>(HMS_FAILURE_PENALTY_US));
+	}
+	// Concurrent updates may overwrite each other; the estimate only needs to be roughly right
+	state.ewma_us = static_cast<int64_t>(updated);
+	state.updated_at_us = now_us;
+	UpdateBreaker(state, success, now_us);
+
+	if (success) {
+		std::lock_guard<std::mutex> guard(samples_lock);
+		if (samples.size() < HMS_LATENCY_WINDOW) {
+			samples.push_back(latency.count());
+		} else {
+			samples[next_sample] = latency.count();
+			next_sample = (next_sample + 1) % HMS_LATENCY_WINDOW;
+		}
+	}
+}
+
+std::chrono::microseconds HmsEndpointSet::LatencyPercentile(uint32_t percentile) {
+	std::vector<int64_t> sorted;
+	{
+		std::lock_guard<std::mutex> guard(samples_lock);
+		if (samples.size() < HMS_MIN_LATENCY_SAMPLES) {
+			return std::chrono::microseconds(0);
+		}
+		sorted = samples;
+	}
+	auto rank = std::min(sorted.size() - 1, sorted.size() * std::min<uint32_t>(percentile, 100) / 100);
+	std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank), sorted.end());
+	return std::chrono::microseconds(sorted[rank]);
+}
+
+std::chrono::microseconds HmsEndpointSet::LatencyEstimate(size_t idx) {
+	auto now_us = NowMicros();
+	auto &state = *endpoints[idx];
+	auto idle_us = static_cast<double>(std::max<int64_t>(0, now_us - state.updated_at_us.load()));
+	return std::chrono::microseconds(
+	    static_cast<int64_t>(static_cast<double>(state.ewma_us.load()) * std::exp(-idle_us / HMS_EWMA_DECAY_US)));
+}
+
+} // namespace duckdb
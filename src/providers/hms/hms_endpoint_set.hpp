@@ -0,0 +1,100 @@
+#pragma once
+
+#include "hms/hms_config.hpp"
+#include "hms/hms_connection_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// HmsEndpointSet — the metastore instances of one catalog and their health
+//
+// Every call is routed by power-of-two-choices: two distinct instances are
+// sampled and the one with the lower EWMA latency × (calls in flight + 1)
+// wins. The latency estimate decays towards zero while an instance is not
+// used, so an instance that was penalised for failing gets probed again
+// after a while instead of being starved forever. The set also keeps a
+// window of recent call latencies from which hedging delays are derived.
+//
+// Each instance also has a circuit breaker: after
+// config.breaker_failure_threshold consecutive failures it opens and the
+// instance gets no calls for config.breaker_open_ms. After that, a single
+// probe call is let through (half-open); its success closes the breaker and
+// its failure opens it again. Calls fail fast while every instance's breaker
+// is open, rather than each waiting out its own connect timeout.
+//
+// All methods are thread-safe; a set is shared by every query against the
+// catalog.
+//===--------------------------------------------------------------------===//
+class HmsEndpointSet {
+public:
+	explicit HmsEndpointSet(const HmsConfig &config);
+
+	static constexpr size_t NO_ENDPOINT = static_cast<size_t>(-1);
+
+	size_t Size() const {
+		return endpoints.size();
+	}
+	const HmsEndpoint &Endpoint(size_t idx) const {
+		return endpoints[idx]->address;
+	}
+	HmsConnectionPool &Pool(size_t idx) {
+		return *endpoints[idx]->pool;
+	}
+
+	//! Choose the instance for the next call, avoiding `exclude` when another one exists. Returns
+	//! NO_ENDPOINT when every instance's circuit breaker is open.
+	size_t Pick(size_t exclude = NO_ENDPOINT);
+	//! A call was sent to `idx`
+	void OnCallStarted(size_t idx);
+	//! A call on `idx` finished; failures count as a slow call so traffic shifts elsewhere
+	void OnCallFinished(size_t idx, bool success, std::chrono::microseconds latency);
+	//! A call on `idx` was abandoned (its hedged sibling answered first); nothing is learned from it
+	void OnCallCancelled(size_t idx);
+
+	//! Latency that `percentile` percent of recent successful calls stayed under; 0 while there are
+	//! too few samples to tell
+	std::chrono::microseconds LatencyPercentile(uint32_t percentile);
+	//! Current (decayed) latency estimate of `idx`
+	std::chrono::microseconds LatencyEstimate(size_t idx);
+	//! Whether `idx`'s circuit breaker currently rejects calls
+	bool IsOpen(size_t idx);
+
+private:
+	struct EndpointState {
+		HmsEndpoint address;
+		std::shared_ptr<HmsConnectionPool> pool;
+		std::atomic<int64_t> ewma_us {0};
+		std::atomic<int64_t> updated_at_us {0};
+		std::atomic<uint32_t> inflight {0};
+		std::atomic<uint32_t> consecutive_failures {0};
+		//! When the open breaker lets a probe through; 0 while the breaker is closed
+		std::atomic<int64_t> open_until_us {0};
+		//! A half-open probe call is in flight
+		std::atomic<bool> probing {false};
+	};
+
+	double Score(size_t idx, int64_t now_us);
+	//! Claim the half-open probe of an instance whose open period elapsed; NO_ENDPOINT if there is none
+	size_t ClaimProbe(size_t exclude, int64_t now_us);
+	//! Record the outcome of a call for the breaker
+	void UpdateBreaker(EndpointState &state, bool success, int64_t now_us);
+
+	uint32_t breaker_failure_threshold;
+	int64_t breaker_open_us;
+
+	std::vector<std::unique_ptr<EndpointState>> endpoints;
+
+	std::mutex samples_lock;
+	//! Ring buffer of recent successful call latencies in microseconds
+	std::vector<int64_t> samples;
+	size_t next_sample = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,101 @@
+#include "hms/hms_partition_name.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+namespace {
+
+int HexDigitValue(char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+} // namespace
+
+void HmsPartitionNameParser::Unescape(std::string_view input, std::string &out) {
+	size_t i = 0;
+	while (i < input.size()) {
+		char c = input[i];
+		if (c == '%' && i + 2 < input.size()) {
+			int hi = HexDigitValue(input[i + 1]);
+			int lo = HexDigitValue(input[i + 2]);
+			if (hi >= 0 && lo >= 0) {
+				out.push_back(static_cast<char>((hi << 4) | lo));
+				i += 3;
+				continue;
+			}
+		}
+		// Like Hive's unescapePathName, a '%' without two hex digits is kept as-is
+		out.push_back(c);
+		i++;
+	}
+}
+
+std::string_view HmsPartitionNameParser::Decode(std::string_view input) {
+	if (input.empty() || std::memchr(input.data(), '%', input.size()) == nullptr) {
+		return input;
+	}
+	// scratch was reserved to the full name length in Parse() and decoding never grows
+	// the input, so appending here cannot reallocate and invalidate earlier views.
+	auto start = scratch.size();
+	Unescape(input, scratch);
+	return std::string_view(scratch.data() + start, scratch.size() - start);
+}
+
+void HmsPartitionNameParser::Parse(std::string_view name) {
+	segments.clear();
+	scratch.clear();
+	if (scratch.capacity() < name.size()) {
+		scratch.reserve(name.size());
+	}
+
+	size_t pos = 0;
+	while (pos < name.size()) {
+		auto slash = name.find('/', pos);
+		auto end = slash == std::string_view::npos ? name.size() : slash;
+		auto segment = name.substr(pos, end - pos);
+
+		HmsPartitionNameSegment parsed;
+		auto eq_pos = segment.find('=');
+		std::string_view raw_value;
+		if (eq_pos == std::string_view::npos) {
+			raw_value = segment;
+		} else {
+			parsed.key = Decode(segment.substr(0, eq_pos));
+			raw_value = segment.substr(eq_pos + 1);
+		}
+		if (raw_value == HIVE_DEFAULT_PARTITION_NAME) {
+			parsed.is_default = true;
+		} else {
+			parsed.value = Decode(raw_value);
+		}
+		segments.push_back(parsed);
+
+		if (slash == std::string_view::npos) {
+			break;
+		}
+		pos = slash + 1;
+	}
+}
+
+void ParseHmsPartitionName(HmsPartitionNameParser &parser, std::string_view name, MetastorePartitionValue &out) {
+	parser.Parse(name);
+	auto &segments = parser.Segments();
+	out.values.reserve(out.values.size() + segments.size());
+	out.null_values.reserve(out.null_values.size() + segments.size());
+	for (auto &segment : segments) {
+		out.values.emplace_back(segment.value);
+		out.null_values.push_back(segment.is_default);
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "metastore_types.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace duckdb {
+
+//! Value Hive stores in partition names for NULL (and empty) partition values.
+static constexpr const char *HIVE_DEFAULT_PARTITION_NAME = "__HIVE_DEFAULT_PARTITION__";
+
+//===--------------------------------------------------------------------===//
+// HmsPartitionNameSegment — one `key=value` component of a partition name
+//===--------------------------------------------------------------------===//
+struct HmsPartitionNameSegment {
+	//! Unescaped partition key (empty if the segment had no '=')
+	std::string_view key;
+	//! Unescaped partition value (empty when is_default is set)
+	std::string_view value;
+	//! True if the value was __HIVE_DEFAULT_PARTITION__, i.e. NULL
+	bool is_default = false;
+};
+
+//===--------------------------------------------------------------------===//
+// HmsPartitionNameParser — single-pass parser for HMS partition names
+//
+// HMS partition names look like `k1=v1/k2=v2`, where keys and values are
+// escaped with Hive's FileUtils.escapePathName (`%XX` hex escapes, so a
+// literal '/' or '=' never appears unescaped). Segments without escapes are
+// returned as views into the input; escaped segments are decoded into a
+// scratch buffer owned by the parser.
+//
+// Views stay valid until the next Parse() call and as long as the input is
+// alive. Reusing one parser across many names is allocation-free once the
+// internal buffers have grown to the longest name.
+//===--------------------------------------------------------------------===//
+class HmsPartitionNameParser {
+public:
+	//! Parse a partition name. Segments without '=' are kept as bare values.
+	void Parse(std::string_view name);
+
+	const std::vector<HmsPartitionNameSegment> &Segments() const {
+		return segments;
+	}
+
+	//! Decode `%XX` escapes in `input`, appending the result to `out`.
+	static void Unescape(std::string_view input, std::string &out);
+
+private:
+	std::string_view Decode(std::string_view input);
+
+	std::string scratch;
+	std::vector<HmsPartitionNameSegment> segments;
+};
+
+//! Parse `name` with `parser` and append owned values to `out.values` / `out.null_values`.
+void ParseHmsPartitionName(HmsPartitionNameParser &parser, std::string_view name, MetastorePartitionValue &out);
+
+} // namespace duckdb
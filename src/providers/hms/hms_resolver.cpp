@@ -0,0 +1,215 @@
+#include "hms/hms_resolver.hpp"
+#include "hms/hms_retry.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <netdb.h>
+#include <system_error>
+#include <thread>
+
+namespace duckdb {
+
+HmsResolver::HmsResolver(std::chrono::milliseconds ttl_p, std::chrono::milliseconds negative_ttl_p)
+    : ttl(ttl_p), negative_ttl(negative_ttl_p) {
+}
+
+HmsResolver::~HmsResolver() {
+	{
+		std::lock_guard<std::mutex> guard(queue_lock);
+		stopping = true;
+	}
+	queue_ready.notify_one();
+	if (background.joinable()) {
+		background.join();
+	}
+}
+
+HmsResolver &HmsResolver::Global() {
+	// Never destroyed: its background thread may be blocked in getaddrinfo when the process exits, and
+	// joining it would hold up the exit for as long as the lookup takes
+	static auto resolver = new HmsResolver();
+	return *resolver;
+}
+
+std::vector<HmsSocketAddress> HmsResolver::InterleaveFamilies(std::vector<HmsSocketAddress> addresses) {
+	if (addresses.empty()) {
+		return addresses;
+	}
+	auto first_family = addresses[0].family;
+	std::vector<HmsSocketAddress> preferred;
+	std::vector<HmsSocketAddress> other;
+	for (auto &address : addresses) {
+		(address.family == first_family ? preferred : other).push_back(address);
+	}
+	std::vector<HmsSocketAddress> result;
+	result.reserve(addresses.size());
+	for (size_t i = 0; i < preferred.size() || i < other.size(); i++) {
+		if (i < preferred.size()) {
+			result.push_back(preferred[i]);
+		}
+		if (i < other.size()) {
+			result.push_back(other[i]);
+		}
+	}
+	return result;
+}
+
+MetastoreResult<HmsAddressList> HmsResolver::Lookup(const std::string &host, uint16_t port) {
+	HmsRpcStats::Global().dns_lookups++;
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo *results = nullptr;
+	auto port_string = std::to_string(port);
+	int gai_result = getaddrinfo(host.c_str(), port_string.c_str(), &hints, &results);
+	if (gai_result != 0) {
+		return MetastoreResult<HmsAddressList>::Error(MetastoreErrorCode::Transient, "HMS DNS resolution failed",
+		                                             gai_strerror(gai_result), true);
+	}
+	std::vector<HmsSocketAddress> addresses;
+	for (addrinfo *addr = results; addr != nullptr; addr = addr->ai_next) {
+		HmsSocketAddress address;
+		address.family = addr->ai_family;
+		address.socktype = addr->ai_socktype;
+		address.protocol = addr->ai_protocol;
+		memset(&address.address, 0, sizeof(address.address));
+		memcpy(&address.address, addr->ai_addr, addr->ai_addrlen);
+		address.length = static_cast<socklen_t>(addr->ai_addrlen);
+		addresses.push_back(address);
+	}
+	freeaddrinfo(results);
+	if (addresses.empty()) {
+		return MetastoreResult<HmsAddressList>::Error(MetastoreErrorCode::Transient, "HMS DNS resolution failed",
+		                                             "no addresses", true);
+	}
+	return MetastoreResult<HmsAddressList>::Success(
+	    std::make_shared<const std::vector<HmsSocketAddress>>(InterleaveFamilies(std::move(addresses))));
+}
+
+MetastoreResult<HmsAddressList> HmsResolver::Resolve(const std::string &host, uint16_t port) {
+	auto key = host + ":" + std::to_string(port);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = entries.find(key);
+		if (it != entries.end() && std::chrono::steady_clock::now() < it->second.expires_at) {
+			HmsRpcStats::Global().dns_cache_hits++;
+			if (it->second.addresses) {
+				return MetastoreResult<HmsAddressList>::Success(it->second.addresses);
+			}
+			auto &error = it->second.error;
+			return MetastoreResult<HmsAddressList>::Error(error.code, error.message, error.detail, error.retryable);
+		}
+	}
+
+	return lookups.Do<MetastoreResult<HmsAddressList>>(key, [&]() {
+		auto result = Lookup(host, port);
+		std::lock_guard<std::mutex> guard(lock);
+		auto &entry = entries[key];
+		auto now = std::chrono::steady_clock::now();
+		entry.refreshing = false;
+		if (result.IsOk()) {
+			entry.addresses = result.value;
+			entry.error = MetastoreError();
+			entry.expires_at = now + ttl;
+			return result;
+		}
+		entry.expires_at = now + negative_ttl;
+		if (entry.addresses) {
+			// Keep using the last known addresses while the resolver is failing
+			return MetastoreResult<HmsAddressList>::Success(entry.addresses);
+		}
+		entry.error = result.error;
+		return result;
+	});
+}
+
+bool HmsResolver::TryResolveCached(const std::string &host, uint16_t port, MetastoreResult<HmsAddressList> &result) {
+	auto key = host + ":" + std::to_string(port);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = entries.find(key);
+		if (it == entries.end()) {
+			return false;
+		}
+		auto &entry = it->second;
+		if (std::chrono::steady_clock::now() < entry.expires_at) {
+			HmsRpcStats::Global().dns_cache_hits++;
+			if (entry.addresses) {
+				result = MetastoreResult<HmsAddressList>::Success(entry.addresses);
+			} else {
+				result = MetastoreResult<HmsAddressList>::Error(entry.error.code, entry.error.message,
+				                                                entry.error.detail, entry.error.retryable);
+			}
+			return true;
+		}
+		if (!entry.addresses) {
+			return false;
+		}
+		// A host rarely moves, so its last addresses keep serving connects while they are looked up again
+		HmsRpcStats::Global().dns_cache_hits++;
+		result = MetastoreResult<HmsAddressList>::Success(entry.addresses);
+		if (entry.refreshing) {
+			return true;
+		}
+		entry.refreshing = true;
+	}
+	ResolveInBackground(host, port, nullptr);
+	return true;
+}
+
+void HmsResolver::ResolveInBackground(const std::string &host, uint16_t port, std::function<void()> done) {
+	std::unique_lock<std::mutex> guard(queue_lock);
+	if (!background.joinable()) {
+		try {
+			background = std::thread([this]() { RunBackgroundLookups(); });
+		} catch (std::system_error &) {
+			// Out of threads: resolving here is slower for the caller, but still correct
+			guard.unlock();
+			Resolve(host, port);
+			if (done) {
+				done();
+			}
+			return;
+		}
+	}
+	auto queued = std::find_if(queue.begin(), queue.end(), [&](const BackgroundLookup &lookup) {
+		return lookup.port == port && lookup.host == host;
+	});
+	if (queued == queue.end()) {
+		BackgroundLookup lookup;
+		lookup.host = host;
+		lookup.port = port;
+		queued = queue.insert(queue.end(), std::move(lookup));
+	}
+	if (done) {
+		queued->done.push_back(std::move(done));
+	}
+	guard.unlock();
+	queue_ready.notify_one();
+}
+
+void HmsResolver::RunBackgroundLookups() {
+	std::unique_lock<std::mutex> guard(queue_lock);
+	while (true) {
+		queue_ready.wait(guard, [this]() { return stopping || !queue.empty(); });
+		if (stopping) {
+			return;
+		}
+		auto lookup = std::move(queue.front());
+		queue.pop_front();
+		guard.unlock();
+		Resolve(lookup.host, lookup.port);
+		for (auto &done : lookup.done) {
+			done();
+		}
+		guard.lock();
+	}
+}
+
+void HmsResolver::Invalidate(const std::string &host, uint16_t port) {
+	std::lock_guard<std::mutex> guard(lock);
+	entries.erase(host + ":" + std::to_string(port));
+}
+
+} // namespace duckdb
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+#include "metastore_single_flight.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+//! One resolved address of an HMS host, ready for socket() / connect()
+struct HmsSocketAddress {
+	int family;
+	int socktype;
+	int protocol;
+	sockaddr_storage address;
+	socklen_t length;
+};
+
+using HmsAddressList = std::shared_ptr<const std::vector<HmsSocketAddress>>;
+
+//===--------------------------------------------------------------------===//
+// HmsResolver — process-wide cache of resolved HMS hosts
+//
+// getaddrinfo blocks, and a slow resolver would otherwise stall every
+// connect. Successful lookups are kept for ttl, failed ones for
+// negative_ttl so a broken resolver fails calls fast instead of making
+// each wait again. When a refresh fails, the previous addresses are kept
+// for another negative_ttl: a host that stops resolving for a moment
+// usually still runs at the same address. Concurrent lookups of one host
+// share a single getaddrinfo call.
+//
+// Event loops never call getaddrinfo themselves: TryResolveCached answers
+// from the cache only, serving expired addresses while they are refreshed
+// in the background, and ResolveInBackground queues the lookups it cannot
+// answer. Background lookups run one at a time on a single thread owned
+// by the resolver, started on first use and joined when it is destroyed,
+// so a burst of cold hosts never turns into a burst of threads.
+//
+// Addresses are returned with IPv6 and IPv4 entries interleaved, starting
+// with the family getaddrinfo preferred, which is the order Happy Eyeballs
+// (RFC 8305) tries them in.
+//===--------------------------------------------------------------------===//
+class HmsResolver {
+public:
+	explicit HmsResolver(std::chrono::milliseconds ttl = std::chrono::seconds(60),
+	                     std::chrono::milliseconds negative_ttl = std::chrono::seconds(5));
+	~HmsResolver();
+
+	static HmsResolver &Global();
+
+	//! Addresses of host:port, from the cache when possible; blocks while a lookup runs
+	MetastoreResult<HmsAddressList> Resolve(const std::string &host, uint16_t port);
+	//! Answer for host:port without waiting: the cached one, or the expired addresses while a background
+	//! refresh runs. False if nothing usable is cached and a lookup has to run first.
+	bool TryResolveCached(const std::string &host, uint16_t port, MetastoreResult<HmsAddressList> &result);
+	//! Resolve host:port on the resolver's background thread, then call `done` (if set) on that thread.
+	//! Requests for a host that is already queued share its lookup.
+	void ResolveInBackground(const std::string &host, uint16_t port, std::function<void()> done);
+	//! Forget host:port, e.g. after none of its addresses accepted a connection
+	void Invalidate(const std::string &host, uint16_t port);
+
+	//! Reorder addresses so families alternate, keeping the relative order within each family
+	static std::vector<HmsSocketAddress> InterleaveFamilies(std::vector<HmsSocketAddress> addresses);
+
+private:
+	struct Entry {
+		HmsAddressList addresses;
+		//! Error of the last lookup when it failed and nothing older was known
+		MetastoreError error;
+		std::chrono::steady_clock::time_point expires_at;
+		//! A background refresh of the expired addresses is under way
+		bool refreshing = false;
+	};
+
+	struct BackgroundLookup {
+		std::string host;
+		uint16_t port;
+		std::vector<std::function<void()>> done;
+	};
+
+	//! Run getaddrinfo for host:port
+	static MetastoreResult<HmsAddressList> Lookup(const std::string &host, uint16_t port);
+	//! Body of the background thread: run queued lookups until the resolver is destroyed
+	void RunBackgroundLookups();
+
+	std::chrono::milliseconds ttl;
+	std::chrono::milliseconds negative_ttl;
+	std::mutex lock;
+	std::unordered_map<std::string, Entry> entries;
+	MetastoreSingleFlight lookups;
+
+	std::mutex queue_lock;
+	std::condition_variable queue_ready;
+	std::deque<BackgroundLookup> queue;
+	bool stopping = false;
+	std::thread background;
+};
+
+} // namespace duckdb
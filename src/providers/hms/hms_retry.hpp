@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 
@@ -31,10 +32,103 @@ struct HmsRetryPolicy {
 		return static_cast<uint32_t>(bounded_delay);
 	}
 
+	//! ComputeDelay with "equal jitter": half the delay is kept, the other half is scaled by
+	//! `unit_random` in [0, 1). Clients that failed together therefore retry spread out, but
+	//! never sooner than half the backoff.
+	uint32_t ComputeJitteredDelay(uint32_t attempt, double unit_random) const {
+		auto delay = ComputeDelay(attempt);
+		auto half = delay / 2;
+		return half + static_cast<uint32_t>(static_cast<double>(delay - half) * unit_random);
+	}
+
 	//! Returns true if another attempt should be made.
 	bool ShouldRetry(uint32_t attempts_made) const {
 		return attempts_made < max_attempts;
 	}
 };
 
+//===--------------------------------------------------------------------===//
+// HmsRetryBudget — process-wide cap on the share of calls that are retries
+//
+// Token bucket: every first attempt deposits `deposit_per_call` tokens and
+// every retry withdraws one. Once the bucket is empty, retryable failures
+// are returned to the caller instead of retried, so a degraded metastore
+// sees at most roughly deposit_per_call extra load from retries (after the
+// initial `capacity` burst) rather than a retry storm.
+//===--------------------------------------------------------------------===//
+class HmsRetryBudget {
+public:
+	explicit HmsRetryBudget(uint32_t capacity = 100, double deposit_per_call = 0.1)
+	    : capacity_milli(static_cast<int64_t>(capacity) * 1000),
+	      deposit_milli(static_cast<int64_t>(deposit_per_call * 1000)), tokens_milli(capacity_milli) {
+	}
+
+	static HmsRetryBudget &Global() {
+		static HmsRetryBudget budget;
+		return budget;
+	}
+
+	void RecordCall() {
+		auto current = tokens_milli.load(std::memory_order_relaxed);
+		while (current < capacity_milli &&
+		       !tokens_milli.compare_exchange_weak(current, std::min(capacity_milli, current + deposit_milli),
+		                                           std::memory_order_relaxed)) {
+		}
+	}
+
+	//! Take one retry token; false if the budget is exhausted
+	bool TryAcquireRetry() {
+		auto current = tokens_milli.load(std::memory_order_relaxed);
+		while (current >= 1000) {
+			if (tokens_milli.compare_exchange_weak(current, current - 1000, std::memory_order_relaxed)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	//! Whole retry tokens currently available
+	int64_t AvailableRetries() const {
+		return tokens_milli.load(std::memory_order_relaxed) / 1000;
+	}
+
+private:
+	const int64_t capacity_milli;
+	const int64_t deposit_milli;
+	std::atomic<int64_t> tokens_milli;
+};
+
+//===--------------------------------------------------------------------===//
+// HmsRpcStats — process-wide HMS call counters for monitoring
+//===--------------------------------------------------------------------===//
+struct HmsRpcStats {
+	//! Calls submitted (first attempts only)
+	std::atomic<uint64_t> calls {0};
+	//! Retries sent after a retryable failure
+	std::atomic<uint64_t> retries {0};
+	//! Retryable failures returned without a retry because the retry budget was empty
+	std::atomic<uint64_t> retries_denied {0};
+	//! Calls that failed for good, after any retries
+	std::atomic<uint64_t> failures {0};
+	//! Total backoff waited before retries, in milliseconds
+	std::atomic<uint64_t> retry_delay_ms {0};
+	//! Hedged copies sent to a second instance because the first was slow
+	std::atomic<uint64_t> hedges {0};
+	//! Hedged copies that answered before the original
+	std::atomic<uint64_t> hedge_wins {0};
+	//! Times an instance's circuit breaker opened (including re-opening after a failed probe)
+	std::atomic<uint64_t> breaker_opens {0};
+	//! Calls failed without being sent because every usable instance had an open breaker
+	std::atomic<uint64_t> breaker_rejections {0};
+	//! getaddrinfo calls made for HMS hosts
+	std::atomic<uint64_t> dns_lookups {0};
+	//! Host resolutions answered from the resolver cache
+	std::atomic<uint64_t> dns_cache_hits {0};
+
+	static HmsRpcStats &Global() {
+		static HmsRpcStats stats;
+		return stats;
+	}
+};
+
 } // namespace duckdb
@@ -0,0 +1,442 @@
+#include "hms/hms_thrift.hpp"
+
+namespace duckdb {
+
+namespace {
+
+int32_t LoadI32(const uint8_t *p) {
+	return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+	                            (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]));
+}
+
+//! Encoded size of fixed-width types; 0 for variable-width or invalid types
+size_t FixedWidth(ThriftType type) {
+	switch (type) {
+	case ThriftType::Bool:
+	case ThriftType::Byte:
+		return 1;
+	case ThriftType::I16:
+		return 2;
+	case ThriftType::I32:
+		return 4;
+	case ThriftType::I64:
+	case ThriftType::Double:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+} // namespace
+
+bool ThriftReader::Skip(ThriftType type, int depth) {
+	if (depth > THRIFT_MAX_DEPTH) {
+		return false;
+	}
+	auto width = FixedWidth(type);
+	if (width > 0) {
+		return SkipBytes(width);
+	}
+	switch (type) {
+	case ThriftType::Stop:
+	case ThriftType::Void:
+		return true;
+	case ThriftType::String:
+		return SkipString();
+	case ThriftType::Struct: {
+		while (true) {
+			ThriftType field_type;
+			int16_t field_id;
+			if (!ReadFieldBegin(field_type, field_id)) {
+				return false;
+			}
+			if (field_type == ThriftType::Stop) {
+				return true;
+			}
+			// Most fields of HMS structs are strings; skip those without recursing
+			bool ok = field_type == ThriftType::String ? SkipString() : Skip(field_type, depth + 1);
+			if (!ok) {
+				return false;
+			}
+		}
+	}
+	case ThriftType::Map: {
+		uint8_t key_type_raw, val_type_raw;
+		int32_t count;
+		if (!ReadByte(key_type_raw) || !ReadByte(val_type_raw) || !ReadI32(count) || count < 0) {
+			return false;
+		}
+		auto key_type = static_cast<ThriftType>(key_type_raw);
+		auto val_type = static_cast<ThriftType>(val_type_raw);
+		auto key_width = FixedWidth(key_type);
+		auto val_width = FixedWidth(val_type);
+		if (key_width > 0 && val_width > 0) {
+			return SkipBytes((key_width + val_width) * static_cast<size_t>(count));
+		}
+		if (key_type == ThriftType::String && val_type == ThriftType::String) {
+			for (int32_t i = 0; i < count; i++) {
+				if (!SkipString() || !SkipString()) {
+					return false;
+				}
+			}
+			return true;
+		}
+		for (int32_t i = 0; i < count; i++) {
+			if (!Skip(key_type, depth + 1) || !Skip(val_type, depth + 1)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	case ThriftType::Set:
+	case ThriftType::List: {
+		uint8_t elem_type_raw;
+		int32_t count;
+		if (!ReadByte(elem_type_raw) || !ReadI32(count) || count < 0) {
+			return false;
+		}
+		auto elem_type = static_cast<ThriftType>(elem_type_raw);
+		// Lists of numbers (e.g. column statistics, bucket ids) are skipped in one step
+		auto elem_width = FixedWidth(elem_type);
+		if (elem_width > 0) {
+			return SkipBytes(elem_width * static_cast<size_t>(count));
+		}
+		if (elem_type == ThriftType::String) {
+			for (int32_t i = 0; i < count; i++) {
+				if (!SkipString()) {
+					return false;
+				}
+			}
+			return true;
+		}
+		for (int32_t i = 0; i < count; i++) {
+			if (!Skip(elem_type, depth + 1)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// ThriftStructScanner
+//===--------------------------------------------------------------------===//
+void ThriftStructScanner::Start(size_t offset_p) {
+	offset = offset_p;
+	stack.clear();
+	stack.push_back(Frame {ThriftType::Struct, ThriftType::Stop, ThriftType::Stop, 0, ThriftType::Stop});
+}
+
+ThriftStructScanner::Status ThriftStructScanner::ConsumeValue(ThriftType type, const uint8_t *buffer, size_t size) {
+	auto available = size - offset;
+	auto width = FixedWidth(type);
+	if (width > 0) {
+		if (available < width) {
+			return Status::NeedMore;
+		}
+		offset += width;
+		return Status::Complete;
+	}
+	switch (type) {
+	case ThriftType::String: {
+		if (available < 4) {
+			return Status::NeedMore;
+		}
+		auto len = LoadI32(buffer + offset);
+		if (len < 0) {
+			return Status::Malformed;
+		}
+		if (available - 4 < static_cast<size_t>(len)) {
+			return Status::NeedMore;
+		}
+		offset += 4 + static_cast<size_t>(len);
+		return Status::Complete;
+	}
+	case ThriftType::Struct:
+		stack.push_back(Frame {ThriftType::Struct, ThriftType::Stop, ThriftType::Stop, 0, ThriftType::Stop});
+		return Status::Complete;
+	case ThriftType::Set:
+	case ThriftType::List: {
+		if (available < 5) {
+			return Status::NeedMore;
+		}
+		auto elem_type = static_cast<ThriftType>(buffer[offset]);
+		auto count = LoadI32(buffer + offset + 1);
+		if (count < 0) {
+			return Status::Malformed;
+		}
+		offset += 5;
+		stack.push_back(Frame {ThriftType::List, elem_type, elem_type, count, ThriftType::Stop});
+		return Status::Complete;
+	}
+	case ThriftType::Map: {
+		if (available < 6) {
+			return Status::NeedMore;
+		}
+		auto key_type = static_cast<ThriftType>(buffer[offset]);
+		auto value_type = static_cast<ThriftType>(buffer[offset + 1]);
+		auto count = LoadI32(buffer + offset + 2);
+		if (count < 0) {
+			return Status::Malformed;
+		}
+		offset += 6;
+		stack.push_back(Frame {ThriftType::Map, key_type, value_type, int64_t(count) * 2, ThriftType::Stop});
+		return Status::Complete;
+	}
+	default:
+		return Status::Malformed;
+	}
+}
+
+ThriftStructScanner::Status ThriftStructScanner::Feed(const uint8_t *buffer, size_t size) {
+	while (!stack.empty()) {
+		if (stack.size() > THRIFT_MAX_DEPTH) {
+			return Status::Malformed;
+		}
+		// ConsumeValue may push a frame, so the current frame is addressed by index afterwards
+		auto frame_idx = stack.size() - 1;
+		auto &frame = stack[frame_idx];
+		if (frame.type == ThriftType::Struct) {
+			if (frame.pending == ThriftType::Stop) {
+				if (offset >= size) {
+					return Status::NeedMore;
+				}
+				auto field_type = static_cast<ThriftType>(buffer[offset]);
+				if (field_type == ThriftType::Stop) {
+					offset++;
+					stack.pop_back();
+					continue;
+				}
+				// field type (1) + field id (2)
+				if (size - offset < 3) {
+					return Status::NeedMore;
+				}
+				offset += 3;
+				frame.pending = field_type;
+			}
+			auto status = ConsumeValue(frame.pending, buffer, size);
+			if (status != Status::Complete) {
+				return status;
+			}
+			stack[frame_idx].pending = ThriftType::Stop;
+			continue;
+		}
+
+		if (frame.remaining == 0) {
+			stack.pop_back();
+			continue;
+		}
+		// Map frames alternate key, value, key, ... starting from an even count
+		auto type = frame.type == ThriftType::Map && frame.remaining % 2 == 1 ? frame.value_type : frame.key_type;
+		auto status = ConsumeValue(type, buffer, size);
+		if (status != Status::Complete) {
+			return status;
+		}
+		stack[frame_idx].remaining--;
+	}
+	return Status::Complete;
+}
+
+//===--------------------------------------------------------------------===//
+// ThriftMessageScanner
+//===--------------------------------------------------------------------===//
+namespace {
+
+//! Check the message header at the start of `buffer`: version (4) + method name length (4) +
+//! method name + seqid (4)
+ThriftStructScanner::Status ScanMessageHeader(const uint8_t *buffer, size_t size, size_t &header_size) {
+	if (size < 8) {
+		return ThriftStructScanner::Status::NeedMore;
+	}
+	if (static_cast<int32_t>(LoadI32(buffer) & 0xFFFF0000) != THRIFT_VERSION_1) {
+		return ThriftStructScanner::Status::Malformed;
+	}
+	auto name_len = LoadI32(buffer + 4);
+	if (name_len < 0) {
+		return ThriftStructScanner::Status::Malformed;
+	}
+	header_size = 12 + static_cast<size_t>(name_len);
+	if (size < header_size) {
+		return ThriftStructScanner::Status::NeedMore;
+	}
+	return ThriftStructScanner::Status::Complete;
+}
+
+} // namespace
+
+void ThriftMessageScanner::Reset() {
+	header_done = false;
+}
+
+ThriftMessageScanner::Status ThriftMessageScanner::Feed(const uint8_t *buffer, size_t size) {
+	if (!header_done) {
+		size_t header_size;
+		auto status = ScanMessageHeader(buffer, size, header_size);
+		if (status != Status::Complete) {
+			return status;
+		}
+		body.Start(header_size);
+		header_done = true;
+	}
+	return body.Feed(buffer, size);
+}
+
+//===--------------------------------------------------------------------===//
+// ThriftListReplyStream
+//===--------------------------------------------------------------------===//
+void ThriftListReplyStream::Reset() {
+	state = State::Header;
+	element_count = 0;
+	elements_left = 0;
+	element_begin = 0;
+	consumed = 0;
+	scanning = false;
+}
+
+void ThriftListReplyStream::Discard(size_t bytes) {
+	consumed -= bytes;
+	element_begin = element_begin > bytes ? element_begin - bytes : 0;
+	if (scanning) {
+		scanner.Discard(bytes);
+	}
+}
+
+ThriftListReplyStream::Event ThriftListReplyStream::Next(const uint8_t *buffer, size_t size) {
+	using Status = ThriftStructScanner::Status;
+	switch (state) {
+	case State::Header: {
+		size_t header_size;
+		auto status = ScanMessageHeader(buffer, size, header_size);
+		if (status != Status::Complete) {
+			return status == Status::NeedMore ? Event::NeedMore : Event::Malformed;
+		}
+		if (static_cast<ThriftMessageType>(LoadI32(buffer) & 0xFF) != ThriftMessageType::Reply) {
+			state = State::NotStreamable;
+			return Event::NotStreamable;
+		}
+		// field header (type, id) + list header (element type, count)
+		if (size - header_size < 1) {
+			return Event::NeedMore;
+		}
+		if (static_cast<ThriftType>(buffer[header_size]) != ThriftType::List) {
+			state = State::NotStreamable;
+			return Event::NotStreamable;
+		}
+		if (size - header_size < 8) {
+			return Event::NeedMore;
+		}
+		auto field_id = static_cast<int16_t>((buffer[header_size + 1] << 8) | buffer[header_size + 2]);
+		auto elem_type = static_cast<ThriftType>(buffer[header_size + 3]);
+		auto count = LoadI32(buffer + header_size + 4);
+		if (field_id != 0 || elem_type != ThriftType::Struct) {
+			state = State::NotStreamable;
+			return Event::NotStreamable;
+		}
+		if (count < 0) {
+			return Event::Malformed;
+		}
+		element_count = static_cast<size_t>(count);
+		elements_left = element_count;
+		consumed = header_size + 8;
+		state = State::Elements;
+		return Event::ListBegin;
+	}
+	case State::Elements:
+		if (elements_left > 0) {
+			if (!scanning) {
+				element_begin = consumed;
+				scanner.Start(consumed);
+				scanning = true;
+			}
+			auto status = scanner.Feed(buffer, size);
+			if (status != Status::Complete) {
+				return status == Status::NeedMore ? Event::NeedMore : Event::Malformed;
+			}
+			scanning = false;
+			consumed = scanner.Offset();
+			elements_left--;
+			return Event::Element;
+		}
+		// The rest of the result struct: normally just its stop byte
+		scanner.Start(consumed);
+		scanning = true;
+		state = State::Tail;
+		// fall through
+	case State::Tail: {
+		auto status = scanner.Feed(buffer, size);
+		if (status != Status::Complete) {
+			return status == Status::NeedMore ? Event::NeedMore : Event::Malformed;
+		}
+		scanning = false;
+		consumed = scanner.Offset();
+		state = State::Done;
+		return Event::End;
+	}
+	case State::Done:
+		return Event::End;
+	default:
+		return Event::NotStreamable;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Message-level helpers
+//===--------------------------------------------------------------------===//
+MetastoreResult<int32_t> ReadThriftMessageHeader(ThriftReader &reader, std::string &method_name,
+                                                 ThriftMessageType &message_type, int32_t &seqid) {
+	int32_t version_and_type;
+	if (!reader.ReadI32(version_and_type)) {
+		return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "HMS response read failed", "", true);
+	}
+	if (static_cast<int32_t>(version_and_type & 0xFFFF0000) != THRIFT_VERSION_1) {
+		return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Unsupported, "Unsupported Thrift version", "", false);
+	}
+	message_type = static_cast<ThriftMessageType>(version_and_type & 0x000000FF);
+	if (!reader.ReadString(method_name) || !reader.ReadI32(seqid)) {
+		return MetastoreResult<int32_t>::Error(MetastoreErrorCode::Transient, "HMS response header parse failed", "",
+		                                       true);
+	}
+	return MetastoreResult<int32_t>::Success(0);
+}
+
+MetastoreResult<int> ParseApplicationException(ThriftReader &reader) {
+	std::string message;
+	int32_t ex_type = 0;
+	while (true) {
+		uint8_t field_type_raw;
+		if (!reader.ReadByte(field_type_raw)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
+		}
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			break;
+		}
+		int16_t field_id;
+		if (!reader.ReadI16(field_id)) {
+			return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
+		}
+		if (field_id == 1 && field_type == ThriftType::String) {
+			if (!reader.ReadString(message)) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
+			}
+		} else if (field_id == 2 && field_type == ThriftType::I32) {
+			if (!reader.ReadI32(ex_type)) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
+			}
+		} else {
+			if (!reader.Skip(field_type)) {
+				return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "Failed reading exception", "", true);
+			}
+		}
+	}
+	// The server not knowing the method will not change on a retry
+	if (ex_type == THRIFT_APPLICATION_EXCEPTION_UNKNOWN_METHOD) {
+		return MetastoreResult<int>::Error(MetastoreErrorCode::Unsupported, HMS_UNKNOWN_METHOD_MESSAGE, message, false);
+	}
+	return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS remote exception", message, true);
+}
+
+} // namespace duckdb
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "metastore_connector.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Thrift binary protocol primitives used by the HMS client
+//===--------------------------------------------------------------------===//
+enum class ThriftType : uint8_t {
+	Stop = 0,
+	Void = 1,
+	Bool = 2,
+	Byte = 3,
+	Double = 4,
+	I16 = 6,
+	I32 = 8,
+	I64 = 10,
+	String = 11,
+	Struct = 12,
+	Map = 13,
+	Set = 14,
+	List = 15
+};
+
+enum class ThriftMessageType : uint8_t {
+	Call = 1,
+	Reply = 2,
+	Exception = 3
+};
+
+static constexpr int32_t THRIFT_VERSION_1 = static_cast<int32_t>(0x80010000);
+
+class ThriftWriter {
+public:
+	void WriteByte(uint8_t v) {
+		buffer.push_back(v);
+	}
+
+	void WriteI16(int16_t v) {
+		buffer.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+		buffer.push_back(static_cast<uint8_t>(v & 0xFF));
+	}
+
+	void WriteI32(int32_t v) {
+		buffer.push_back(static_cast<uint8_t>((v >> 24) & 0xFF));
+		buffer.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
+		buffer.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+		buffer.push_back(static_cast<uint8_t>(v & 0xFF));
+	}
+
+	void WriteString(const std::string &s) {
+		WriteI32(static_cast<int32_t>(s.size()));
+		buffer.insert(buffer.end(), s.begin(), s.end());
+	}
+
+	void WriteMessageBegin(const std::string &name, ThriftMessageType message_type, int32_t seqid) {
+		WriteI32(THRIFT_VERSION_1 | static_cast<int32_t>(message_type));
+		WriteString(name);
+		WriteI32(seqid);
+	}
+
+	void WriteFieldBegin(ThriftType type, int16_t field_id) {
+		WriteByte(static_cast<uint8_t>(type));
+		WriteI16(field_id);
+	}
+
+	void WriteFieldStop() {
+		WriteByte(static_cast<uint8_t>(ThriftType::Stop));
+	}
+
+	void WriteListBegin(ThriftType elem_type, int32_t size) {
+		WriteByte(static_cast<uint8_t>(elem_type));
+		WriteI32(size);
+	}
+
+	void WriteStructBegin() {
+	}
+
+	void WriteStructEnd() {
+	}
+
+	const std::vector<uint8_t> &Data() const {
+		return buffer;
+	}
+
+	std::vector<uint8_t> Release() {
+		return std::move(buffer);
+	}
+
+private:
+	std::vector<uint8_t> buffer;
+};
+
+//===--------------------------------------------------------------------===//
+// ThriftReader — decodes a complete, buffered Thrift message
+//
+// Replies are only handed to a reader once ThriftMessageScanner has seen
+// the whole message (or, for streamed list replies, ThriftListReplyStream
+// the whole element), so running out of input means the message is corrupt.
+//===--------------------------------------------------------------------===//
+class ThriftReader {
+public:
+	ThriftReader(const uint8_t *data_p, size_t size_p) : data(data_p), size(size_p) {
+	}
+
+	bool ReadExact(uint8_t *dst, size_t n) {
+		if (size - offset < n) {
+			return false;
+		}
+		memcpy(dst, data + offset, n);
+		offset += n;
+		return true;
+	}
+
+	bool SkipBytes(size_t n) {
+		if (size - offset < n) {
+			return false;
+		}
+		offset += n;
+		return true;
+	}
+
+	bool ReadByte(uint8_t &out) {
+		return ReadExact(&out, 1);
+	}
+
+	bool ReadI16(int16_t &out) {
+		uint8_t b[2];
+		if (!ReadExact(b, sizeof(b))) {
+			return false;
+		}
+		out = static_cast<int16_t>((static_cast<int16_t>(b[0]) << 8) | static_cast<int16_t>(b[1]));
+		return true;
+	}
+
+	bool ReadI32(int32_t &out) {
+		uint8_t b[4];
+		if (!ReadExact(b, sizeof(b))) {
+			return false;
+		}
+		out = static_cast<int32_t>((static_cast<uint32_t>(b[0]) << 24) | (static_cast<uint32_t>(b[1]) << 16) |
+		                           (static_cast<uint32_t>(b[2]) << 8) | static_cast<uint32_t>(b[3]));
+		return true;
+	}
+
+	bool ReadI64(int64_t &out) {
+		uint8_t b[8];
+		if (!ReadExact(b, sizeof(b))) {
+			return false;
+		}
+		uint64_t v = 0;
+		for (auto byte : b) {
+			v = (v << 8) | byte;
+		}
+		out = static_cast<int64_t>(v);
+		return true;
+	}
+
+	bool ReadString(std::string &out) {
+		int32_t len;
+		if (!ReadI32(len) || len < 0 || size - offset < static_cast<size_t>(len)) {
+			return false;
+		}
+		out.assign(reinterpret_cast<const char *>(data + offset), static_cast<size_t>(len));
+		offset += static_cast<size_t>(len);
+		return true;
+	}
+
+	//! Read a field header with one bounds check. `type` is Stop, and `field_id` untouched, at the end
+	//! of a struct.
+	bool ReadFieldBegin(ThriftType &type, int16_t &field_id) {
+		if (offset >= size) {
+			return false;
+		}
+		type = static_cast<ThriftType>(data[offset]);
+		if (type == ThriftType::Stop) {
+			offset++;
+			return true;
+		}
+		if (size - offset < 3) {
+			return false;
+		}
+		field_id = static_cast<int16_t>((data[offset + 1] << 8) | data[offset + 2]);
+		offset += 3;
+		return true;
+	}
+
+	//! Like ReadString, but returns a view into the reader's buffer instead of a copy
+	bool ReadStringView(std::string_view &out) {
+		int32_t len;
+		if (!ReadI32(len) || len < 0 || size - offset < static_cast<size_t>(len)) {
+			return false;
+		}
+		out = std::string_view(reinterpret_cast<const char *>(data + offset), static_cast<size_t>(len));
+		offset += static_cast<size_t>(len);
+		return true;
+	}
+
+	//! Skip one string; inline because strings dominate the values we skip
+	bool SkipString() {
+		int32_t len;
+		return ReadI32(len) && len >= 0 && SkipBytes(static_cast<size_t>(len));
+	}
+
+	//! Skip a value of the given type. Defined out of line (recursive over containers).
+	bool Skip(ThriftType type, int depth = 0);
+
+	size_t Offset() const {
+		return offset;
+	}
+
+	size_t Remaining() const {
+		return size - offset;
+	}
+
+private:
+	const uint8_t *data;
+	size_t size;
+	size_t offset = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// ThriftStructScanner — finds the end of a Thrift struct in a byte stream
+//
+// Unframed Thrift carries no length prefix, so the only way to know a value
+// is complete is to walk its structure. The scanner does that incrementally:
+// every Feed() resumes where the previous one stopped (it keeps an explicit
+// stack of open structs and containers), so a struct that arrives in many
+// segments is walked exactly once.
+//===--------------------------------------------------------------------===//
+class ThriftStructScanner {
+public:
+	enum class Status : uint8_t { NeedMore, Complete, Malformed };
+
+	//! Start scanning a struct whose first field header is at `offset`
+	void Start(size_t offset);
+
+	//! Continue scanning `buffer`, which holds all bytes received so far (bytes from the scan
+	//! position on unchanged). Returns Complete once the struct ends at Offset().
+	Status Feed(const uint8_t *buffer, size_t size);
+
+	size_t Offset() const {
+		return offset;
+	}
+
+	//! The caller dropped the first `bytes` of its buffer, all of them before Offset()
+	void Discard(size_t bytes) {
+		offset -= bytes;
+	}
+
+private:
+	struct Frame {
+		ThriftType type;
+		ThriftType key_type;
+		ThriftType value_type;
+		//! Elements left (lists/sets) or keys plus values left (maps)
+		int64_t remaining;
+		//! Struct frames: type of the field whose header was read but whose value was not
+		ThriftType pending;
+	};
+
+	//! Try to consume one value of `type`; containers push a frame. Returns NeedMore without
+	//! consuming anything when the value's fixed-size prefix is not fully available.
+	Status ConsumeValue(ThriftType type, const uint8_t *buffer, size_t size);
+
+	size_t offset = 0;
+	std::vector<Frame> stack;
+};
+
+//===--------------------------------------------------------------------===//
+// ThriftMessageScanner — finds the end of a Thrift message in a byte stream
+//===--------------------------------------------------------------------===//
+class ThriftMessageScanner {
+public:
+	using Status = ThriftStructScanner::Status;
+
+	//! Continue scanning `buffer`, which holds all bytes received so far for this message
+	//! (earlier bytes unchanged). Returns Complete once the message ends at MessageSize().
+	Status Feed(const uint8_t *buffer, size_t size);
+
+	size_t MessageSize() const {
+		return body.Offset();
+	}
+
+	void Reset();
+
+private:
+	bool header_done = false;
+	ThriftStructScanner body;
+};
+
+//===--------------------------------------------------------------------===//
+// ThriftListReplyStream — pull-based decoding of a list<struct> reply
+//
+// The large HMS replies (get_partitions_by_names, get_partitions_by_filter)
+// are a result struct whose success field holds a list of structs. Rather
+// than waiting for the whole message, the owner of the receive buffer calls
+// Next() whenever bytes arrive and gets the list's elements one at a time,
+// each as soon as its last byte is in. Bytes before Consumed() are never
+// looked at again and may be dropped with Discard(), so the buffer only
+// ever holds the element still being received.
+//
+// Replies of any other shape (exceptions, an empty result, lists of
+// non-structs) are reported as NotStreamable before anything is consumed,
+// and the owner falls back to buffering the whole message.
+//===--------------------------------------------------------------------===//
+class ThriftListReplyStream {
+public:
+	enum class Event : uint8_t {
+		//! Nothing more can be decoded until more bytes arrive
+		NeedMore,
+		//! The reply is not a list<struct> reply; nothing was consumed
+		NotStreamable,
+		//! The message header and list header were read; ElementCount() is known. The header is
+		//! still at the start of the buffer for the owner to check.
+		ListBegin,
+		//! One complete element is at [ElementBegin(), Consumed())
+		Element,
+		//! The message ended at Consumed()
+		End,
+		Malformed
+	};
+
+	Event Next(const uint8_t *buffer, size_t size);
+
+	size_t ElementCount() const {
+		return element_count;
+	}
+	size_t ElementBegin() const {
+		return element_begin;
+	}
+	//! End of the last value handed out; earlier bytes are no longer needed
+	size_t Consumed() const {
+		return consumed;
+	}
+
+	//! The owner dropped the first `bytes` of its buffer, at most Consumed()
+	void Discard(size_t bytes);
+
+	void Reset();
+
+private:
+	enum class State : uint8_t { Header, Elements, Tail, Done, NotStreamable };
+
+	State state = State::Header;
+	size_t element_count = 0;
+	size_t elements_left = 0;
+	size_t element_begin = 0;
+	size_t consumed = 0;
+	//! Scanning the current element (or, in Tail, the rest of the result struct) is under way
+	bool scanning = false;
+	ThriftStructScanner scanner;
+};
+
+//! Maximum nesting of structs and containers accepted in an HMS reply
+static constexpr int THRIFT_MAX_DEPTH = 64;
+
+//! Read a message header. Errors are Transient (truncated) or Unsupported (not binary protocol v1).
+MetastoreResult<int32_t> ReadThriftMessageHeader(ThriftReader &reader, std::string &method_name,
+                                                 ThriftMessageType &message_type, int32_t &seqid);
+
+//! TApplicationException type sent by servers that do not implement the called method
+static constexpr int32_t THRIFT_APPLICATION_EXCEPTION_UNKNOWN_METHOD = 1;
+
+//! Convert a TApplicationException body into an error. Unknown methods are Unsupported and not
+//! retryable; other application exceptions are Transient.
+MetastoreResult<int> ParseApplicationException(ThriftReader &reader);
+
+//! Message of the error a call to a method the server does not implement fails with
+static constexpr const char *HMS_UNKNOWN_METHOD_MESSAGE = "HMS method not implemented by the server";
+
+//! Whether `error` means the server does not implement the called method, so an older one must be used
+inline bool IsHmsUnknownMethodError(const MetastoreError &error) {
+	return error.code == MetastoreErrorCode::Unsupported && error.message == HMS_UNKNOWN_METHOD_MESSAGE;
+}
+
+} // namespace duckdb
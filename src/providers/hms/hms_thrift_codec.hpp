@@ -0,0 +1,218 @@
+#pragma once
+
+#include "hms/hms_decode.hpp"
+#include "hms/hms_thrift.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Table-driven decoding of Thrift structs
+//
+// A struct is described once by a constexpr list of the fields we read,
+// each with its Thrift id, wire type and decoder, in the shape of the HMS
+// IDL (hive_metastore.thrift). HmsThriftStructCodec turns that list into
+// a dispatch table indexed by field id at compile time, so decoding a
+// field is one bounds check and one indirect call; fields not in the list,
+// or sent with a different wire type, are skipped. Adding a struct means
+// writing its field list, not another decode loop.
+//
+// A field can be tagged with a group bit. Decoding takes the set of groups
+// the caller wants, and fields of other groups are skipped at the byte
+// level like unknown ones; untagged fields are always decoded.
+//===--------------------------------------------------------------------===//
+static constexpr uint32_t HMS_ALL_FIELD_GROUPS = UINT32_MAX;
+
+template <typename Out>
+using HmsFieldDecoder = bool (*)(ThriftReader &reader, HmsDecodeArena &arena, uint32_t groups, Out &out);
+
+template <typename Out>
+struct HmsThriftField {
+	int16_t id;
+	ThriftType type;
+	HmsFieldDecoder<Out> decode;
+	//! Group bit the field belongs to; 0 for fields that are always decoded
+	uint32_t group = 0;
+};
+
+template <typename Out, size_t N>
+constexpr int16_t HmsMaxFieldId(const HmsThriftField<Out> (&fields)[N]) {
+	int16_t max_id = 0;
+	for (auto &field : fields) {
+		max_id = field.id > max_id ? field.id : max_id;
+	}
+	return max_id;
+}
+
+template <typename Out, int16_t MAX_ID>
+class HmsThriftStructCodec {
+public:
+	//! Field ids must be in [0, MAX_ID]; an id outside that range fails to compile
+	template <size_t N>
+	constexpr explicit HmsThriftStructCodec(const HmsThriftField<Out> (&fields)[N])
+	    : types(), decoders(), field_groups() {
+		for (auto &field : fields) {
+			types[static_cast<size_t>(field.id)] = field.type;
+			decoders[static_cast<size_t>(field.id)] = field.decode;
+			field_groups[static_cast<size_t>(field.id)] = field.group;
+		}
+	}
+
+	//! Decode one struct, the reader positioned at its first field header. Fields whose group is not
+	//! in `groups` are skipped, here and in nested structs.
+	bool Decode(ThriftReader &reader, HmsDecodeArena &arena, Out &out, uint32_t groups = HMS_ALL_FIELD_GROUPS) const {
+		while (true) {
+			ThriftType type;
+			int16_t field_id;
+			if (!reader.ReadFieldBegin(type, field_id)) {
+				return false;
+			}
+			if (type == ThriftType::Stop) {
+				return true;
+			}
+			auto idx = static_cast<uint16_t>(field_id);
+			bool wanted = idx <= MAX_ID && types[idx] == type && (field_groups[idx] & groups) == field_groups[idx];
+			bool ok = wanted ? decoders[idx](reader, arena, groups, out) : reader.Skip(type);
+			if (!ok) {
+				return false;
+			}
+		}
+	}
+
+private:
+	//! Stop marks ids without a decoder
+	std::array<ThriftType, MAX_ID + 1> types;
+	std::array<HmsFieldDecoder<Out>, MAX_ID + 1> decoders;
+	std::array<uint32_t, MAX_ID + 1> field_groups;
+};
+
+//===--------------------------------------------------------------------===//
+// Field decoders
+//===--------------------------------------------------------------------===//
+//! Every element takes at least one byte, so a count beyond the remaining input is corrupt; checking
+//! it keeps a bad count from turning into a huge arena allocation
+inline bool HmsReadElementCount(ThriftReader &reader, size_t &count) {
+	int32_t count_raw;
+	if (!reader.ReadI32(count_raw) || count_raw < 0 || static_cast<size_t>(count_raw) > reader.Remaining()) {
+		return false;
+	}
+	count = static_cast<size_t>(count_raw);
+	return true;
+}
+
+//! Skip `count` elements that are not of the type we decode
+inline bool HmsSkipElements(ThriftReader &reader, ThriftType type, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		if (!reader.Skip(type)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename Out, std::string_view Out::*MEMBER>
+bool HmsDecodeStringField(ThriftReader &reader, HmsDecodeArena &, uint32_t, Out &out) {
+	return reader.ReadStringView(out.*MEMBER);
+}
+
+template <typename Out, std::optional<std::string_view> Out::*MEMBER>
+bool HmsDecodeOptionalStringField(ThriftReader &reader, HmsDecodeArena &, uint32_t, Out &out) {
+	std::string_view value;
+	if (!reader.ReadStringView(value)) {
+		return false;
+	}
+	out.*MEMBER = value;
+	return true;
+}
+
+template <typename Out, HmsArenaArray<std::string_view> Out::*MEMBER>
+bool HmsDecodeStringListField(ThriftReader &reader, HmsDecodeArena &arena, uint32_t, Out &out) {
+	uint8_t elem_type;
+	size_t count;
+	if (!reader.ReadByte(elem_type) || !HmsReadElementCount(reader, count)) {
+		return false;
+	}
+	auto &list = out.*MEMBER;
+	list = HmsArenaArray<std::string_view>();
+	if (static_cast<ThriftType>(elem_type) != ThriftType::String) {
+		return HmsSkipElements(reader, static_cast<ThriftType>(elem_type), count);
+	}
+	list.data = arena.AllocateArray<std::string_view>(count);
+	list.size = count;
+	for (size_t i = 0; i < count; i++) {
+		if (!reader.ReadStringView(list.data[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename Out, HmsArenaArray<HmsStringPairView> Out::*MEMBER>
+bool HmsDecodeStringMapField(ThriftReader &reader, HmsDecodeArena &arena, uint32_t, Out &out) {
+	uint8_t key_type, value_type;
+	size_t count;
+	if (!reader.ReadByte(key_type) || !reader.ReadByte(value_type) || !HmsReadElementCount(reader, count)) {
+		return false;
+	}
+	auto &map = out.*MEMBER;
+	map = HmsArenaArray<HmsStringPairView>();
+	if (static_cast<ThriftType>(key_type) != ThriftType::String ||
+	    static_cast<ThriftType>(value_type) != ThriftType::String) {
+		for (size_t i = 0; i < count; i++) {
+			if (!reader.Skip(static_cast<ThriftType>(key_type)) || !reader.Skip(static_cast<ThriftType>(value_type))) {
+				return false;
+			}
+		}
+		return true;
+	}
+	map.data = arena.AllocateArray<HmsStringPairView>(count);
+	map.size = count;
+	for (size_t i = 0; i < count; i++) {
+		if (!reader.ReadStringView(map.data[i].key) || !reader.ReadStringView(map.data[i].value)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! A nested struct decoded into member `MEMBER` with `CODEC`
+template <typename Out, typename Nested, Nested Out::*MEMBER, const auto *CODEC>
+bool HmsDecodeStructField(ThriftReader &reader, HmsDecodeArena &arena, uint32_t groups, Out &out) {
+	return CODEC->Decode(reader, arena, out.*MEMBER, groups);
+}
+
+//! A nested struct whose fields are decoded into the enclosing view itself (e.g. SerDeInfo)
+template <typename Out, const auto *CODEC>
+bool HmsDecodeInlineStruct(ThriftReader &reader, HmsDecodeArena &arena, uint32_t groups, Out &out) {
+	return CODEC->Decode(reader, arena, out, groups);
+}
+
+//! A list of structs decoded with `CODEC` into an arena array
+template <typename Out, typename Elem, HmsArenaArray<Elem> Out::*MEMBER, const auto *CODEC>
+bool HmsDecodeStructListField(ThriftReader &reader, HmsDecodeArena &arena, uint32_t groups, Out &out) {
+	uint8_t elem_type;
+	size_t count;
+	if (!reader.ReadByte(elem_type) || !HmsReadElementCount(reader, count)) {
+		return false;
+	}
+	auto &list = out.*MEMBER;
+	list = HmsArenaArray<Elem>();
+	if (static_cast<ThriftType>(elem_type) != ThriftType::Struct) {
+		return HmsSkipElements(reader, static_cast<ThriftType>(elem_type), count);
+	}
+	list.data = arena.AllocateArray<Elem>(count);
+	list.size = count;
+	for (size_t i = 0; i < count; i++) {
+		if (!CODEC->Decode(reader, arena, list.data[i], groups)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace duckdb
@@ -0,0 +1,89 @@
+// Microbenchmark: HMS partition name parsing.
+//
+// Compares the previous std::stringstream/std::getline splitter with
+// HmsPartitionNameParser, both view-only and when producing owned values.
+//
+// Build and run from the repository root (one command, wrapped here):
+//   g++ -O2 -std=c++17 -Isrc/include -Isrc -Isrc/providers -Iduckdb/src/include
+//       test/benchmark/hms/partition_name_benchmark.cpp src/providers/hms/hms_partition_name.cpp
+//       -o /tmp/partition_name_benchmark && /tmp/partition_name_benchmark [name_count]
+
+#include "hms/hms_partition_name.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace duckdb;
+
+std::vector<std::string> LegacyParsePartitionNameValues(const std::string &partition_name) {
+	std::vector<std::string> values;
+	std::stringstream ss(partition_name);
+	std::string segment;
+	while (std::getline(ss, segment, '/')) {
+		auto eq_pos = segment.find('=');
+		if (eq_pos == std::string::npos || eq_pos + 1 >= segment.size()) {
+			values.push_back(segment);
+		} else {
+			values.push_back(segment.substr(eq_pos + 1));
+		}
+	}
+	return values;
+}
+
+std::vector<std::string> GenerateNames(size_t count) {
+	static const char *countries[] = {"US", "DE", "US%2FCA", "BR", "__HIVE_DEFAULT_PARTITION__"};
+	std::vector<std::string> names;
+	names.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		std::string name = "dt=2024-" + std::to_string(1 + (i / 28) % 12) + "-" + std::to_string(1 + i % 28);
+		name += "/hour=" + std::to_string(i % 24);
+		name += "/country=" + std::string(countries[i % 5]);
+		name += "/source=event%20stream%3Aingest";
+		names.push_back(std::move(name));
+	}
+	return names;
+}
+
+template <typename Fn>
+void Run(const char *label, const std::vector<std::string> &names, Fn &&fn) {
+	size_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (auto &name : names) {
+		checksum += fn(name);
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << label << ": " << elapsed << " ms (" << (elapsed * 1e6 / names.size()) << " ns/name, checksum "
+	          << checksum << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	size_t count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+	auto names = GenerateNames(count);
+
+	Run("legacy stringstream", names, [](const std::string &name) {
+		auto values = LegacyParsePartitionNameValues(name);
+		return values.size() + values.back().size();
+	});
+
+	HmsPartitionNameParser parser;
+	Run("parser (views)", names, [&](const std::string &name) {
+		parser.Parse(name);
+		auto &segments = parser.Segments();
+		return segments.size() + segments.back().value.size();
+	});
+
+	Run("parser (owned values)", names, [&](const std::string &name) {
+		MetastorePartitionValue pv;
+		ParseHmsPartitionName(parser, name, pv);
+		return pv.values.size() + pv.values.back().size();
+	});
+	return 0;
+}
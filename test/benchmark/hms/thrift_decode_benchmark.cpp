@@ -0,0 +1,704 @@
+// Microbenchmark: decoding HMS Table and Partition structs.
+//
+// Compares the previous decoders, which built std::string / unordered_map
+// values field by field, with arena-backed view decoding, both view-only
+// and when materializing owned results, and the hand-written view decoders
+// with the field-table codecs that replaced them. Heap allocations and peak
+// live heap bytes are counted by replacing the global operator new.
+//
+// Build and run from the repository root (one command, wrapped here):
+//   g++ -O2 -std=c++17 -Isrc/include -Isrc -Isrc/providers -Iduckdb/src/include
+//       test/benchmark/hms/thrift_decode_benchmark.cpp src/providers/hms/hms_decode.cpp
+//       src/providers/hms/hms_thrift.cpp -o /tmp/thrift_decode_benchmark && /tmp/thrift_decode_benchmark [iterations]
+
+#include "hms/hms_decode.hpp"
+#include "hms/hms_partition_name.hpp"
+#include "hms/hms_thrift.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+size_t allocation_count = 0;
+size_t live_bytes = 0;
+size_t peak_live_bytes = 0;
+
+//! Allocation header recording the block size, padded to keep max_align_t alignment
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+} // namespace
+
+void *operator new(size_t size) {
+	auto *block = static_cast<char *>(std::malloc(size + HEADER_SIZE));
+	if (!block) {
+		throw std::bad_alloc();
+	}
+	*reinterpret_cast<size_t *>(block) = size;
+	allocation_count++;
+	live_bytes += size;
+	peak_live_bytes = std::max(peak_live_bytes, live_bytes);
+	return block + HEADER_SIZE;
+}
+
+void operator delete(void *ptr) noexcept {
+	if (!ptr) {
+		return;
+	}
+	auto *block = static_cast<char *>(ptr) - HEADER_SIZE;
+	live_bytes -= *reinterpret_cast<size_t *>(block);
+	std::free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	operator delete(ptr);
+}
+
+namespace {
+
+using namespace duckdb;
+
+//===--------------------------------------------------------------------===//
+// Previous decoders
+//===--------------------------------------------------------------------===//
+bool LegacyParseStringMap(ThriftReader &reader, std::unordered_map<std::string, std::string> &out) {
+	uint8_t key_type_raw, val_type_raw;
+	int32_t count;
+	if (!reader.ReadByte(key_type_raw) || !reader.ReadByte(val_type_raw) || !reader.ReadI32(count) || count < 0) {
+		return false;
+	}
+	for (int32_t i = 0; i < count; i++) {
+		std::string key;
+		std::string val;
+		if (!reader.ReadString(key) || !reader.ReadString(val)) {
+			return false;
+		}
+		out[std::move(key)] = std::move(val);
+	}
+	return true;
+}
+
+bool LegacyParseFieldSchema(ThriftReader &reader, MetastoreColumn &col) {
+	while (true) {
+		uint8_t field_type_raw;
+		int16_t field_id;
+		if (!reader.ReadByte(field_type_raw)) {
+			return false;
+		}
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		if (!reader.ReadI16(field_id)) {
+			return false;
+		}
+		bool ok = field_id == 1   ? reader.ReadString(col.name)
+		          : field_id == 2 ? reader.ReadString(col.type)
+		                          : reader.Skip(field_type);
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool LegacyParseStorageDescriptor(ThriftReader &reader, MetastoreStorageDescriptor &sd) {
+	while (true) {
+		uint8_t field_type_raw;
+		int16_t field_id;
+		if (!reader.ReadByte(field_type_raw)) {
+			return false;
+		}
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		if (!reader.ReadI16(field_id)) {
+			return false;
+		}
+		bool ok = true;
+		if (field_id == 1 && field_type == ThriftType::List) {
+			uint8_t elem_type;
+			int32_t count;
+			ok = reader.ReadByte(elem_type) && reader.ReadI32(count);
+			for (int32_t i = 0; ok && i < count; i++) {
+				MetastoreColumn col;
+				ok = LegacyParseFieldSchema(reader, col);
+				sd.columns.push_back(std::move(col));
+			}
+		} else if (field_id == 2 && field_type == ThriftType::String) {
+			ok = reader.ReadString(sd.location);
+		} else if ((field_id == 3 || field_id == 4) && field_type == ThriftType::String) {
+			std::string format;
+			ok = reader.ReadString(format);
+			(field_id == 3 ? sd.input_format : sd.output_format) = std::move(format);
+		} else if (field_id == 7 && field_type == ThriftType::Struct) {
+			while (ok) {
+				uint8_t serde_type_raw;
+				int16_t serde_id;
+				if (!reader.ReadByte(serde_type_raw)) {
+					return false;
+				}
+				auto serde_type = static_cast<ThriftType>(serde_type_raw);
+				if (serde_type == ThriftType::Stop) {
+					break;
+				}
+				if (!reader.ReadI16(serde_id)) {
+					return false;
+				}
+				if (serde_id == 2 && serde_type == ThriftType::String) {
+					std::string serde;
+					ok = reader.ReadString(serde);
+					sd.serde_class = std::move(serde);
+				} else if (serde_id == 3 && serde_type == ThriftType::Map) {
+					ok = LegacyParseStringMap(reader, sd.serde_parameters);
+				} else {
+					ok = reader.Skip(serde_type);
+				}
+			}
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool LegacyParseTable(ThriftReader &reader, MetastoreTable &table) {
+	while (true) {
+		uint8_t field_type_raw;
+		int16_t field_id;
+		if (!reader.ReadByte(field_type_raw)) {
+			return false;
+		}
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		if (!reader.ReadI16(field_id)) {
+			return false;
+		}
+		bool ok;
+		if (field_id == 1 && field_type == ThriftType::String) {
+			ok = reader.ReadString(table.name);
+		} else if (field_id == 2 && field_type == ThriftType::String) {
+			ok = reader.ReadString(table.namespace_name);
+		} else if (field_id == 7 && field_type == ThriftType::Struct) {
+			ok = LegacyParseStorageDescriptor(reader, table.storage_descriptor);
+		} else if (field_id == 9 && field_type == ThriftType::Map) {
+			ok = LegacyParseStringMap(reader, table.properties);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool LegacyParsePartition(ThriftReader &reader, MetastorePartitionValue &partition) {
+	while (true) {
+		uint8_t field_type_raw;
+		int16_t field_id;
+		if (!reader.ReadByte(field_type_raw)) {
+			return false;
+		}
+		auto field_type = static_cast<ThriftType>(field_type_raw);
+		if (field_type == ThriftType::Stop) {
+			break;
+		}
+		if (!reader.ReadI16(field_id)) {
+			return false;
+		}
+		bool ok;
+		if (field_id == 1 && field_type == ThriftType::List) {
+			uint8_t elem_type;
+			int32_t count;
+			ok = reader.ReadByte(elem_type) && reader.ReadI32(count);
+			for (int32_t i = 0; ok && i < count; i++) {
+				std::string value;
+				ok = reader.ReadString(value);
+				partition.values.push_back(std::move(value));
+			}
+		} else if (field_id == 6 && field_type == ThriftType::Struct) {
+			// The whole descriptor was decoded to keep its location
+			MetastoreStorageDescriptor sd;
+			ok = LegacyParseStorageDescriptor(reader, sd);
+			partition.location = std::move(sd.location);
+		} else if (field_id == 7 && field_type == ThriftType::Map) {
+			ok = LegacyParseStringMap(reader, partition.parameters);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+	partition.null_values.assign(partition.values.size(), false);
+	for (size_t i = 0; i < partition.values.size(); i++) {
+		if (partition.values[i] == HIVE_DEFAULT_PARTITION_NAME) {
+			partition.values[i].clear();
+			partition.null_values[i] = true;
+		}
+	}
+	return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Hand-written view decoders, replaced by the field-table codecs
+//===--------------------------------------------------------------------===//
+//! Read the next field header; `type` is Stop at the end of the struct
+bool HandWrittenReadFieldHeader(ThriftReader &reader, ThriftType &type, int16_t &field_id) {
+	uint8_t type_raw;
+	if (!reader.ReadByte(type_raw)) {
+		return false;
+	}
+	type = static_cast<ThriftType>(type_raw);
+	return type == ThriftType::Stop || reader.ReadI16(field_id);
+}
+
+//! Every element takes at least one byte, so a count beyond the remaining input is corrupt; checking
+//! it keeps a bad count from turning into a huge arena allocation
+bool HandWrittenReadListHeader(ThriftReader &reader, ThriftType &elem_type, size_t &count) {
+	uint8_t elem_type_raw;
+	int32_t count_raw;
+	if (!reader.ReadByte(elem_type_raw) || !reader.ReadI32(count_raw) || count_raw < 0 ||
+	    static_cast<size_t>(count_raw) > reader.Remaining()) {
+		return false;
+	}
+	elem_type = static_cast<ThriftType>(elem_type_raw);
+	count = static_cast<size_t>(count_raw);
+	return true;
+}
+
+bool HandWrittenDecodeStringList(ThriftReader &reader, HmsDecodeArena &arena, HmsArenaArray<std::string_view> &out) {
+	ThriftType elem_type;
+	size_t count;
+	if (!HandWrittenReadListHeader(reader, elem_type, count)) {
+		return false;
+	}
+	if (elem_type != ThriftType::String) {
+		for (size_t i = 0; i < count; i++) {
+			if (!reader.Skip(elem_type)) {
+				return false;
+			}
+		}
+		out = HmsArenaArray<std::string_view>();
+		return true;
+	}
+	out.data = arena.AllocateArray<std::string_view>(count);
+	out.size = count;
+	for (size_t i = 0; i < count; i++) {
+		if (!reader.ReadStringView(out.data[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool HandWrittenDecodeStringMap(ThriftReader &reader, HmsDecodeArena &arena, HmsArenaArray<HmsStringPairView> &out) {
+	uint8_t key_type_raw, val_type_raw;
+	int32_t count_raw;
+	if (!reader.ReadByte(key_type_raw) || !reader.ReadByte(val_type_raw) || !reader.ReadI32(count_raw) ||
+	    count_raw < 0 || static_cast<size_t>(count_raw) > reader.Remaining()) {
+		return false;
+	}
+	auto key_type = static_cast<ThriftType>(key_type_raw);
+	auto val_type = static_cast<ThriftType>(val_type_raw);
+	auto count = static_cast<size_t>(count_raw);
+	if (key_type != ThriftType::String || val_type != ThriftType::String) {
+		for (size_t i = 0; i < count; i++) {
+			if (!reader.Skip(key_type) || !reader.Skip(val_type)) {
+				return false;
+			}
+		}
+		out = HmsArenaArray<HmsStringPairView>();
+		return true;
+	}
+	out.data = arena.AllocateArray<HmsStringPairView>(count);
+	out.size = count;
+	for (size_t i = 0; i < count; i++) {
+		if (!reader.ReadStringView(out.data[i].key) || !reader.ReadStringView(out.data[i].value)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool HandWrittenDecodeFieldSchema(ThriftReader &reader, HmsFieldSchemaView &out) {
+	while (true) {
+		ThriftType field_type;
+		int16_t field_id;
+		if (!HandWrittenReadFieldHeader(reader, field_type, field_id)) {
+			return false;
+		}
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		bool ok;
+		if (field_id == 1 && field_type == ThriftType::String) {
+			ok = reader.ReadStringView(out.name);
+		} else if (field_id == 2 && field_type == ThriftType::String) {
+			ok = reader.ReadStringView(out.type);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool HandWrittenDecodeFieldSchemaList(ThriftReader &reader, HmsDecodeArena &arena, HmsArenaArray<HmsFieldSchemaView> &out) {
+	ThriftType elem_type;
+	size_t count;
+	if (!HandWrittenReadListHeader(reader, elem_type, count)) {
+		return false;
+	}
+	if (elem_type != ThriftType::Struct) {
+		for (size_t i = 0; i < count; i++) {
+			if (!reader.Skip(elem_type)) {
+				return false;
+			}
+		}
+		out = HmsArenaArray<HmsFieldSchemaView>();
+		return true;
+	}
+	out.data = arena.AllocateArray<HmsFieldSchemaView>(count);
+	out.size = count;
+	for (size_t i = 0; i < count; i++) {
+		if (!HandWrittenDecodeFieldSchema(reader, out.data[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool HandWrittenDecodeSerdeInfo(ThriftReader &reader, HmsDecodeArena &arena, HmsStorageDescriptorView &sd) {
+	while (true) {
+		ThriftType field_type;
+		int16_t field_id;
+		if (!HandWrittenReadFieldHeader(reader, field_type, field_id)) {
+			return false;
+		}
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		bool ok;
+		if (field_id == 2 && field_type == ThriftType::String) {
+			std::string_view serde;
+			ok = reader.ReadStringView(serde);
+			sd.serde_class = serde;
+		} else if (field_id == 3 && field_type == ThriftType::Map) {
+			ok = HandWrittenDecodeStringMap(reader, arena, sd.serde_parameters);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool HandWrittenDecodeStorageDescriptor(ThriftReader &reader, HmsDecodeArena &arena, HmsStorageDescriptorView &sd) {
+	while (true) {
+		ThriftType field_type;
+		int16_t field_id;
+		if (!HandWrittenReadFieldHeader(reader, field_type, field_id)) {
+			return false;
+		}
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		bool ok;
+		if (field_id == 1 && field_type == ThriftType::List) {
+			ok = HandWrittenDecodeFieldSchemaList(reader, arena, sd.columns);
+		} else if (field_id == 2 && field_type == ThriftType::String) {
+			ok = reader.ReadStringView(sd.location);
+		} else if (field_id == 3 && field_type == ThriftType::String) {
+			std::string_view input_format;
+			ok = reader.ReadStringView(input_format);
+			sd.input_format = input_format;
+		} else if (field_id == 4 && field_type == ThriftType::String) {
+			std::string_view output_format;
+			ok = reader.ReadStringView(output_format);
+			sd.output_format = output_format;
+		} else if (field_id == 7 && field_type == ThriftType::Struct) {
+			ok = HandWrittenDecodeSerdeInfo(reader, arena, sd);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+//! Read only the location of a partition's storage descriptor
+bool HandWrittenDecodeStorageDescriptorLocation(ThriftReader &reader, std::string_view &location) {
+	while (true) {
+		ThriftType field_type;
+		int16_t field_id;
+		if (!HandWrittenReadFieldHeader(reader, field_type, field_id)) {
+			return false;
+		}
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		bool ok = field_id == 2 && field_type == ThriftType::String ? reader.ReadStringView(location)
+		                                                            : reader.Skip(field_type);
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool HandWrittenDecodeTable(ThriftReader &reader, HmsDecodeArena &arena, HmsTableView &out) {
+	while (true) {
+		ThriftType field_type;
+		int16_t field_id;
+		if (!HandWrittenReadFieldHeader(reader, field_type, field_id)) {
+			return false;
+		}
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		bool ok;
+		if (field_id == 1 && field_type == ThriftType::String) {
+			ok = reader.ReadStringView(out.name);
+		} else if (field_id == 2 && field_type == ThriftType::String) {
+			ok = reader.ReadStringView(out.db_name);
+		} else if (field_id == 3 && field_type == ThriftType::String) {
+			std::string_view owner;
+			ok = reader.ReadStringView(owner);
+			out.owner = owner;
+		} else if (field_id == 7 && field_type == ThriftType::Struct) {
+			ok = HandWrittenDecodeStorageDescriptor(reader, arena, out.storage_descriptor);
+		} else if (field_id == 8 && field_type == ThriftType::List) {
+			ok = HandWrittenDecodeFieldSchemaList(reader, arena, out.partition_keys);
+		} else if (field_id == 9 && field_type == ThriftType::Map) {
+			ok = HandWrittenDecodeStringMap(reader, arena, out.parameters);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+bool HandWrittenDecodePartition(ThriftReader &reader, HmsDecodeArena &arena, HmsPartitionView &out) {
+	while (true) {
+		ThriftType field_type;
+		int16_t field_id;
+		if (!HandWrittenReadFieldHeader(reader, field_type, field_id)) {
+			return false;
+		}
+		if (field_type == ThriftType::Stop) {
+			return true;
+		}
+		bool ok;
+		if (field_id == 1 && field_type == ThriftType::List) {
+			ok = HandWrittenDecodeStringList(reader, arena, out.values);
+		} else if (field_id == 6 && field_type == ThriftType::Struct) {
+			ok = HandWrittenDecodeStorageDescriptorLocation(reader, out.location);
+		} else if (field_id == 7 && field_type == ThriftType::Map) {
+			ok = HandWrittenDecodeStringMap(reader, arena, out.parameters);
+		} else {
+			ok = reader.Skip(field_type);
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Payload generation
+//===--------------------------------------------------------------------===//
+void WriteStringMap(ThriftWriter &writer, size_t count, const std::string &prefix) {
+	writer.WriteByte(static_cast<uint8_t>(ThriftType::String));
+	writer.WriteByte(static_cast<uint8_t>(ThriftType::String));
+	writer.WriteI32(static_cast<int32_t>(count));
+	for (size_t i = 0; i < count; i++) {
+		writer.WriteString(prefix + ".property_" + std::to_string(i));
+		writer.WriteString("value_for_property_" + std::to_string(i * 7919));
+	}
+}
+
+void WriteStorageDescriptor(ThriftWriter &writer, size_t column_count, const std::string &location) {
+	writer.WriteFieldBegin(ThriftType::List, 1);
+	writer.WriteListBegin(ThriftType::Struct, static_cast<int32_t>(column_count));
+	for (size_t i = 0; i < column_count; i++) {
+		writer.WriteFieldBegin(ThriftType::String, 1);
+		writer.WriteString("column_with_a_longer_name_" + std::to_string(i));
+		writer.WriteFieldBegin(ThriftType::String, 2);
+		writer.WriteString(i % 3 == 0 ? "struct<a:int,b:string>" : "bigint");
+		writer.WriteFieldStop();
+	}
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString(location);
+	writer.WriteFieldBegin(ThriftType::String, 3);
+	writer.WriteString("org.apache.hadoop.hive.ql.io.parquet.MapredParquetInputFormat");
+	writer.WriteFieldBegin(ThriftType::String, 4);
+	writer.WriteString("org.apache.hadoop.hive.ql.io.parquet.MapredParquetOutputFormat");
+	writer.WriteFieldBegin(ThriftType::Struct, 7);
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("org.apache.hadoop.hive.ql.io.parquet.serde.ParquetHiveSerDe");
+	writer.WriteFieldBegin(ThriftType::Map, 3);
+	WriteStringMap(writer, 2, "serde");
+	writer.WriteFieldStop();
+	writer.WriteFieldStop();
+}
+
+std::vector<uint8_t> GenerateTable(size_t column_count, size_t property_count) {
+	ThriftWriter writer;
+	writer.WriteFieldBegin(ThriftType::String, 1);
+	writer.WriteString("wide_table");
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("analytics");
+	writer.WriteFieldBegin(ThriftType::Struct, 7);
+	WriteStorageDescriptor(writer, column_count, "s3://warehouse/analytics/wide_table");
+	writer.WriteFieldBegin(ThriftType::Map, 9);
+	WriteStringMap(writer, property_count, "table");
+	writer.WriteFieldStop();
+	return writer.Release();
+}
+
+std::vector<uint8_t> GeneratePartitions(size_t partition_count, size_t column_count) {
+	ThriftWriter writer;
+	for (size_t i = 0; i < partition_count; i++) {
+		auto dt = "2024-" + std::to_string(1 + i / 28 % 12) + "-" + std::to_string(1 + i % 28);
+		writer.WriteFieldBegin(ThriftType::List, 1);
+		writer.WriteListBegin(ThriftType::String, 2);
+		writer.WriteString(dt);
+		writer.WriteString(std::to_string(i % 24));
+		writer.WriteFieldBegin(ThriftType::Struct, 6);
+		WriteStorageDescriptor(writer, column_count,
+		                       "s3://warehouse/analytics/wide_table/dt=" + dt + "/hour=" + std::to_string(i % 24));
+		writer.WriteFieldBegin(ThriftType::Map, 7);
+		WriteStringMap(writer, 4, "partition");
+		writer.WriteFieldStop();
+	}
+	return writer.Release();
+}
+
+template <typename Fn>
+void Run(const char *label, size_t iterations, Fn &&fn) {
+	size_t checksum = 0;
+	allocation_count = 0;
+	peak_live_bytes = live_bytes;
+	auto baseline_bytes = live_bytes;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		checksum += fn();
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << label << ": " << (elapsed * 1e3 / iterations) << " us/reply, "
+	          << (allocation_count / iterations) << " allocations/reply, peak "
+	          << (peak_live_bytes - baseline_bytes) / 1024 << " KiB (checksum " << checksum << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	size_t iterations = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 200;
+	auto table = GenerateTable(500, 100);
+	constexpr size_t PARTITION_COUNT = 2048;
+	auto partitions = GeneratePartitions(PARTITION_COUNT, 50);
+	HmsDecodeArena arena;
+
+	std::cout << "wide table (500 columns, 100 properties, " << table.size() / 1024 << " KiB)" << std::endl;
+	Run("  legacy owned", iterations, [&]() {
+		ThriftReader reader(table.data(), table.size());
+		MetastoreTable result;
+		LegacyParseTable(reader, result);
+		return result.storage_descriptor.columns.size() + result.properties.size();
+	});
+	Run("  hand-written views", iterations, [&]() {
+		ThriftReader reader(table.data(), table.size());
+		HmsTableView view;
+		HandWrittenDecodeTable(reader, arena, view);
+		auto size = view.storage_descriptor.columns.size + view.parameters.size;
+		arena.Reset();
+		return size;
+	});
+	Run("  field-table views", iterations, [&]() {
+		ThriftReader reader(table.data(), table.size());
+		HmsTableView view;
+		DecodeHmsTable(reader, arena, view);
+		auto size = view.storage_descriptor.columns.size + view.parameters.size;
+		arena.Reset();
+		return size;
+	});
+	Run("  field-table views, location only", iterations, [&]() {
+		ThriftReader reader(table.data(), table.size());
+		HmsTableView view;
+		DecodeHmsTable(reader, arena, view, MetastoreTableFields::Base);
+		auto size = view.storage_descriptor.location.size();
+		arena.Reset();
+		return size;
+	});
+	Run("  field-table + materialize", iterations, [&]() {
+		ThriftReader reader(table.data(), table.size());
+		HmsTableView view;
+		DecodeHmsTable(reader, arena, view);
+		auto sd = MaterializeHmsStorageDescriptor(view.storage_descriptor);
+		auto properties = MaterializeHmsProperties(view.parameters);
+		arena.Reset();
+		return sd.columns.size() + properties.size();
+	});
+
+	std::cout << "partition batch (" << PARTITION_COUNT << " partitions, 50 columns each, "
+	          << partitions.size() / 1024 << " KiB)" << std::endl;
+	Run("  legacy owned", iterations / 10 + 1, [&]() {
+		ThriftReader reader(partitions.data(), partitions.size());
+		std::vector<MetastorePartitionValue> result;
+		for (size_t i = 0; i < PARTITION_COUNT; i++) {
+			MetastorePartitionValue partition;
+			LegacyParsePartition(reader, partition);
+			result.push_back(std::move(partition));
+		}
+		return result.size() + result.back().location.size();
+	});
+	Run("  hand-written views", iterations / 10 + 1, [&]() {
+		ThriftReader reader(partitions.data(), partitions.size());
+		size_t size = 0;
+		for (size_t i = 0; i < PARTITION_COUNT; i++) {
+			HmsPartitionView view;
+			HandWrittenDecodePartition(reader, arena, view);
+			size += view.values.size + view.location.size();
+			arena.Reset();
+		}
+		return size;
+	});
+	Run("  field-table views", iterations / 10 + 1, [&]() {
+		ThriftReader reader(partitions.data(), partitions.size());
+		size_t size = 0;
+		for (size_t i = 0; i < PARTITION_COUNT; i++) {
+			HmsPartitionView view;
+			DecodeHmsPartition(reader, arena, view);
+			size += view.values.size + view.location.size();
+			arena.Reset();
+		}
+		return size;
+	});
+	Run("  field-table + materialize", iterations / 10 + 1, [&]() {
+		ThriftReader reader(partitions.data(), partitions.size());
+		std::vector<MetastorePartitionValue> result;
+		result.reserve(PARTITION_COUNT);
+		for (size_t i = 0; i < PARTITION_COUNT; i++) {
+			HmsPartitionView view;
+			DecodeHmsPartition(reader, arena, view);
+			result.push_back(MaterializeHmsPartition(view));
+			arena.Reset();
+		}
+		return result.size() + result.back().location.size();
+	});
+	return 0;
+}
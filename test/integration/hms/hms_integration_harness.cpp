@@ -1,11 +1,35 @@
 #include "hms/hms_config.hpp"
+#include "hms/hms_connection_pool.hpp"
 #include "hms/hms_connector.hpp"
+#include "hms/hms_decode.hpp"
+#include "hms/hms_endpoint_set.hpp"
 #include "hms/hms_mapper.hpp"
+#include "hms/hms_partition_name.hpp"
+#include "hms/hms_resolver.hpp"
 #include "hms/hms_retry.hpp"
+#include "hms/hms_thrift.hpp"
+#include "metastore_caching_connector.hpp"
+#include "metastore_call_scope.hpp"
+#include "metastore_metadata_cache.hpp"
+#include "metastore_shared_cache_connector.hpp"
+#include "metastore_single_flight.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <poll.h>
 #include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -99,6 +123,1373 @@ void TestRetryPolicy() {
 	Assert(retry.ShouldRetry(1), "attempt 1 should allow retry");
 	Assert(retry.ShouldRetry(3), "attempt 3 should allow retry");
 	Assert(!retry.ShouldRetry(4), "attempt 4 should not allow retry");
+	Assert(retry.ComputeJitteredDelay(2, 0.0) == 100, "jitter should keep half the backoff");
+	Assert(retry.ComputeJitteredDelay(2, 0.999) <= 200, "jitter should not exceed the backoff");
+
+	HmsRetryBudget budget(2, 0.5);
+	Assert(budget.TryAcquireRetry() && budget.TryAcquireRetry(), "budget should allow its initial burst");
+	Assert(!budget.TryAcquireRetry(), "exhausted budget should deny retries");
+	budget.RecordCall();
+	budget.RecordCall();
+	Assert(budget.TryAcquireRetry(), "calls should refill the budget");
+	Assert(!budget.TryAcquireRetry(), "refill should be proportional to calls");
+}
+
+void TestPartitionNameParsing() {
+	HmsPartitionNameParser parser;
+	parser.Parse("dt=2024-01-01/country=US%2FCA/region=__HIVE_DEFAULT_PARTITION__");
+	auto &segments = parser.Segments();
+	Assert(segments.size() == 3, "partition name should split into three segments");
+	Assert(segments[0].key == "dt" && segments[0].value == "2024-01-01", "plain segment should parse");
+	Assert(segments[1].key == "country" && segments[1].value == "US/CA", "escaped value should be decoded");
+	Assert(segments[2].is_default && segments[2].value.empty(), "default partition should map to NULL");
+
+	parser.Parse("k%3Dx=a%zz%4");
+	Assert(parser.Segments().size() == 1, "single segment should parse");
+	Assert(parser.Segments()[0].key == "k=x", "escaped key should be decoded");
+	Assert(parser.Segments()[0].value == "a%zz%4", "invalid escapes should be kept verbatim");
+
+	MetastorePartitionValue pv;
+	ParseHmsPartitionName(parser, "a=1/b=__HIVE_DEFAULT_PARTITION__/c=", pv);
+	Assert(pv.values.size() == 3, "owned values should be produced per segment");
+	Assert(pv.values[0] == "1" && !pv.IsNull(0), "owned value should be copied");
+	Assert(pv.IsNull(1), "owned default partition should be NULL");
+	Assert(pv.values[2].empty() && !pv.IsNull(2), "empty value should stay empty and non-NULL");
+}
+
+void TestConnectionPool() {
+	HmsConnectionPool pool(1);
+	Assert(pool.TryAcquire() == -1, "empty pool should not hand out connections");
+	int fds[2];
+	Assert(pipe(fds) == 0, "pipe should be created");
+	pool.Release(fds[0]);
+	pool.Release(fds[1]);
+	Assert(pool.IdleCount() == 1, "pool should close connections beyond max_idle");
+	Assert(pool.TryAcquire() == fds[0], "pool should hand back the idle connection");
+	close(fds[0]);
+
+	auto shared = HmsConnectionPool::ForEndpoint("hms.example.com", 9083);
+	Assert(shared == HmsConnectionPool::ForEndpoint("hms.example.com", 9083), "pools should be shared per endpoint");
+	Assert(shared != HmsConnectionPool::ForEndpoint("hms.example.com", 9084), "pools should be keyed by port");
+}
+
+void TestEndpointSet() {
+	auto config = ParseHmsEndpoint("thrift+ssl://hms-a:9083,hms-b:9084,hms-c");
+	Assert(config.endpoints.size() == 3, "comma list should yield one endpoint per instance");
+	Assert(config.endpoint == "hms-a" && config.port == 9083, "first instance should stay the primary endpoint");
+	Assert(config.endpoints[1].host == "hms-b" && config.endpoints[1].port == 9084, "second instance should parse");
+	Assert(config.endpoints[2].port == 9083, "instance without port should default to 9083");
+	Assert(config.transport == HmsTransport::ThriftTLS, "scheme given once should apply to every instance");
+
+	bool mixed_error = false;
+	try {
+		(void)ParseHmsEndpoint("thrift://hms-a,thrift+ssl://hms-b");
+	} catch (const MetastoreException &ex) {
+		mixed_error = ex.GetErrorCode() == MetastoreErrorCode::InvalidConfig;
+	}
+	Assert(mixed_error, "mixed transports must raise InvalidConfig");
+
+	HmsEndpointSet endpoints(config);
+	Assert(endpoints.Size() == 3, "endpoint set should hold every instance");
+	for (int i = 0; i < 50; i++) {
+		Assert(endpoints.Pick(1) != 1, "pick must avoid the excluded instance");
+	}
+
+	// Instance 0 answers in 1ms, instance 1 in 50ms, instance 2 fails
+	for (int i = 0; i < 30; i++) {
+		endpoints.OnCallStarted(0);
+		endpoints.OnCallFinished(0, true, std::chrono::microseconds(1000));
+		endpoints.OnCallStarted(1);
+		endpoints.OnCallFinished(1, true, std::chrono::microseconds(50000));
+	}
+	endpoints.OnCallStarted(2);
+	endpoints.OnCallFinished(2, false, std::chrono::microseconds(10));
+	Assert(endpoints.LatencyEstimate(2) > endpoints.LatencyEstimate(1), "a failure should cost more than a slow call");
+	size_t fast_picks = 0;
+	for (int i = 0; i < 300; i++) {
+		fast_picks += endpoints.Pick() == 0 ? 1 : 0;
+	}
+	// Instance 0 wins every pair it is sampled into, i.e. two thirds of them
+	Assert(fast_picks > 150, "the fastest instance should get most calls");
+
+	auto p50 = endpoints.LatencyPercentile(50);
+	auto p99 = endpoints.LatencyPercentile(99);
+	Assert(p50.count() > 0 && p99 >= p50, "latency percentiles should be ordered");
+	Assert(p99 == std::chrono::microseconds(50000), "p99 should reflect the slow instance");
+
+	HmsEndpointSet fresh(ParseHmsEndpoint("hms-a"));
+	Assert(fresh.Size() == 1 && fresh.Pick(0) == 0, "a single instance is always picked");
+	Assert(fresh.LatencyPercentile(95).count() == 0, "percentiles need enough samples");
+}
+
+void TestThriftMessageScanner() {
+	ThriftWriter writer;
+	writer.WriteMessageBegin("get_table", ThriftMessageType::Reply, 7);
+	writer.WriteFieldBegin(ThriftType::Struct, 0);
+	writer.WriteFieldBegin(ThriftType::String, 1);
+	writer.WriteString("events");
+	writer.WriteFieldBegin(ThriftType::List, 2);
+	writer.WriteListBegin(ThriftType::I32, 3);
+	writer.WriteI32(1);
+	writer.WriteI32(2);
+	writer.WriteI32(3);
+	writer.WriteFieldBegin(ThriftType::Map, 3);
+	writer.WriteByte(static_cast<uint8_t>(ThriftType::String));
+	writer.WriteByte(static_cast<uint8_t>(ThriftType::String));
+	writer.WriteI32(1);
+	writer.WriteString("numRows");
+	writer.WriteString("42");
+	writer.WriteFieldStop();
+	writer.WriteFieldStop();
+	auto message = writer.Data();
+
+	// Feed the reply one byte at a time: the scanner must only report completion at the very end
+	ThriftMessageScanner scanner;
+	for (size_t size = 0; size < message.size(); size++) {
+		Assert(scanner.Feed(message.data(), size) == ThriftMessageScanner::Status::NeedMore,
+		       "scanner should wait for the rest of the message");
+	}
+	Assert(scanner.Feed(message.data(), message.size()) == ThriftMessageScanner::Status::Complete,
+	       "scanner should detect the end of the message");
+	Assert(scanner.MessageSize() == message.size(), "scanner should stop at the message boundary");
+
+	scanner.Reset();
+	message[0] = 0;
+	Assert(scanner.Feed(message.data(), message.size()) == ThriftMessageScanner::Status::Malformed,
+	       "scanner should reject non-binary-protocol messages");
+}
+
+void TestListReplyStream() {
+	ThriftWriter writer;
+	writer.WriteMessageBegin("get_partitions_by_names", ThriftMessageType::Reply, 3);
+	writer.WriteFieldBegin(ThriftType::List, 0);
+	writer.WriteListBegin(ThriftType::Struct, 3);
+	for (auto *value : {"2024-01-01", "2024-01-02", "2024-01-03"}) {
+		writer.WriteFieldBegin(ThriftType::List, 1);
+		writer.WriteListBegin(ThriftType::String, 1);
+		writer.WriteString(value);
+		writer.WriteFieldBegin(ThriftType::Struct, 6);
+		writer.WriteFieldBegin(ThriftType::String, 2);
+		writer.WriteString(std::string("s3://bucket/dt=") + value);
+		writer.WriteFieldStop();
+		writer.WriteFieldStop();
+	}
+	writer.WriteFieldStop();
+	auto message = writer.Release();
+
+	// Receive the reply one byte at a time, dropping whatever the stream no longer needs
+	ThriftListReplyStream stream;
+	std::vector<uint8_t> buffer;
+	std::vector<std::string> locations;
+	size_t peak = 0;
+	bool ended = false;
+	HmsDecodeArena arena;
+	for (auto byte : message) {
+		buffer.push_back(byte);
+		peak = std::max(peak, buffer.size());
+		while (true) {
+			auto event = stream.Next(buffer.data(), buffer.size());
+			Assert(event != ThriftListReplyStream::Event::Malformed && event != ThriftListReplyStream::Event::NotStreamable,
+			       "partition list reply should stream");
+			if (event == ThriftListReplyStream::Event::ListBegin) {
+				Assert(stream.ElementCount() == 3, "stream should report the element count");
+			} else if (event == ThriftListReplyStream::Event::Element) {
+				ThriftReader reader(buffer.data() + stream.ElementBegin(), stream.Consumed() - stream.ElementBegin());
+				HmsPartitionView partition;
+				Assert(DecodeHmsPartition(reader, arena, partition) && reader.Remaining() == 0,
+				       "element should hold exactly one partition");
+				locations.emplace_back(partition.location);
+			} else {
+				ended = event == ThriftListReplyStream::Event::End;
+				break;
+			}
+		}
+		if (stream.Consumed() > 0 && !ended) {
+			buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(stream.Consumed()));
+			stream.Discard(stream.Consumed());
+		}
+	}
+	Assert(ended && stream.Consumed() == buffer.size(), "stream should end at the message boundary");
+	Assert(locations.size() == 3 && locations[2] == "s3://bucket/dt=2024-01-03", "every element should be handed out");
+	Assert(peak < message.size() / 2, "only the element being received should be buffered");
+
+	ThriftWriter exception;
+	exception.WriteMessageBegin("get_partitions_by_names", ThriftMessageType::Reply, 4);
+	exception.WriteFieldBegin(ThriftType::Struct, 1);
+	exception.WriteFieldBegin(ThriftType::String, 1);
+	exception.WriteString("boom");
+	exception.WriteFieldStop();
+	exception.WriteFieldStop();
+	auto exception_message = exception.Release();
+	stream.Reset();
+	Assert(stream.Next(exception_message.data(), exception_message.size()) ==
+	           ThriftListReplyStream::Event::NotStreamable,
+	       "exception replies should be left to the buffered path");
+}
+
+void WriteStringMap(ThriftWriter &writer, const std::vector<std::pair<std::string, std::string>> &pairs) {
+	writer.WriteByte(static_cast<uint8_t>(ThriftType::String));
+	writer.WriteByte(static_cast<uint8_t>(ThriftType::String));
+	writer.WriteI32(static_cast<int32_t>(pairs.size()));
+	for (auto &pair : pairs) {
+		writer.WriteString(pair.first);
+		writer.WriteString(pair.second);
+	}
+}
+
+void TestReplyDecoding() {
+	ThriftWriter writer;
+	writer.WriteFieldBegin(ThriftType::String, 1);
+	writer.WriteString("events");
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("db");
+	writer.WriteFieldBegin(ThriftType::I32, 4);
+	writer.WriteI32(1700000000);
+	writer.WriteFieldBegin(ThriftType::Struct, 7);
+	writer.WriteFieldBegin(ThriftType::List, 1);
+	writer.WriteListBegin(ThriftType::Struct, 2);
+	for (auto *name : {"id", "payload"}) {
+		writer.WriteFieldBegin(ThriftType::String, 1);
+		writer.WriteString(name);
+		writer.WriteFieldBegin(ThriftType::String, 2);
+		writer.WriteString("string");
+		writer.WriteFieldStop();
+	}
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("s3://bucket/events");
+	writer.WriteFieldBegin(ThriftType::Struct, 7);
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("org.apache.hadoop.hive.ql.io.parquet.serde.ParquetHiveSerDe");
+	writer.WriteFieldBegin(ThriftType::Map, 3);
+	WriteStringMap(writer, {{"serialization.format", "1"}});
+	writer.WriteFieldStop();
+	writer.WriteFieldStop();
+	writer.WriteFieldBegin(ThriftType::Map, 9);
+	WriteStringMap(writer, {{"numRows", "1"}, {"numRows", "42"}});
+	writer.WriteFieldStop();
+	auto table_bytes = writer.Release();
+
+	HmsDecodeArena arena(64);
+	HmsTableView table;
+	ThriftReader reader(table_bytes.data(), table_bytes.size());
+	Assert(DecodeHmsTable(reader, arena, table), "table should decode");
+	Assert(reader.Remaining() == 0, "decoder should consume the whole struct");
+	Assert(table.name == "events" && table.db_name == "db" && !table.owner.has_value(), "table names should decode");
+	Assert(table.storage_descriptor.columns.size == 2 && table.storage_descriptor.columns[1].name == "payload",
+	       "columns should decode");
+	Assert(table.storage_descriptor.location == "s3://bucket/events", "location should decode");
+	Assert(table.storage_descriptor.serde_parameters.size == 1, "serde parameters should decode");
+	// Views point into the reply buffer instead of copying it
+	auto *buffer_begin = reinterpret_cast<const char *>(table_bytes.data());
+	Assert(table.name.data() > buffer_begin && table.name.data() < buffer_begin + table_bytes.size(),
+	       "decoded strings should be views into the reply");
+	auto sd = MaterializeHmsStorageDescriptor(table.storage_descriptor);
+	Assert(sd.columns.size() == 2 && sd.serde_class.has_value() && !sd.input_format.has_value(),
+	       "materialized descriptor should keep optional fields apart");
+	auto properties = MaterializeHmsProperties(table.parameters);
+	Assert(properties.size() == 1 && properties["numRows"] == "42", "a repeated key should keep its last value");
+	// A location-only projection skips columns, serde parameters and properties without decoding them
+	HmsTableView projected;
+	ThriftReader projected_reader(table_bytes.data(), table_bytes.size());
+	Assert(DecodeHmsTable(projected_reader, arena, projected, MetastoreTableFields::Base), "projection should decode");
+	Assert(projected_reader.Remaining() == 0, "skipped parts should be consumed");
+	Assert(projected.storage_descriptor.location == "s3://bucket/events" &&
+	           projected.storage_descriptor.serde_class.has_value(),
+	       "projection should keep location and format");
+	Assert(projected.storage_descriptor.columns.empty() && projected.storage_descriptor.serde_parameters.empty() &&
+	           projected.parameters.empty(),
+	       "projection should skip unrequested parts");
+	HmsTableView with_properties;
+	ThriftReader properties_reader(table_bytes.data(), table_bytes.size());
+	Assert(DecodeHmsTable(properties_reader, arena, with_properties, MetastoreTableFields::Properties),
+	       "properties projection should decode");
+	Assert(with_properties.parameters.size == 2 && with_properties.storage_descriptor.columns.empty(),
+	       "properties projection should decode properties only");
+	Assert(MetastoreTableHasFields(MetastoreTableFields::All, MetastoreTableFields::Columns) &&
+	           !MetastoreTableHasFields(MetastoreTableFields::PartitionKeys,
+	                                    MetastoreTableFields::PartitionKeys | MetastoreTableFields::Columns),
+	       "field sets should compare by inclusion");
+	Assert(arena.BytesReserved() > 64, "arena should grow past its first chunk");
+	arena.Reset();
+	Assert(arena.BytesReserved() > 0, "reset should keep the last chunk");
+	arena.Reset(0);
+	Assert(arena.BytesReserved() == 0, "reset should release chunks above the retain limit");
+
+	writer.WriteFieldBegin(ThriftType::List, 1);
+	writer.WriteListBegin(ThriftType::String, 2);
+	writer.WriteString("2024-01-01");
+	writer.WriteString(HIVE_DEFAULT_PARTITION_NAME);
+	writer.WriteFieldBegin(ThriftType::Struct, 6);
+	writer.WriteFieldBegin(ThriftType::List, 1);
+	writer.WriteListBegin(ThriftType::Struct, 0);
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("s3://bucket/events/dt=2024-01-01");
+	writer.WriteFieldStop();
+	writer.WriteFieldBegin(ThriftType::Map, 7);
+	WriteStringMap(writer, {{"numRows", "7"}});
+	// Unknown fields are skipped, as are known ids sent with another wire type
+	writer.WriteFieldBegin(ThriftType::List, 20);
+	writer.WriteListBegin(ThriftType::I64, 2);
+	writer.WriteI32(0);
+	writer.WriteI32(1);
+	writer.WriteI32(0);
+	writer.WriteI32(2);
+	writer.WriteFieldBegin(ThriftType::I32, 1);
+	writer.WriteI32(3);
+	writer.WriteFieldStop();
+	auto partition_bytes = writer.Release();
+
+	HmsPartitionView partition_view;
+	ThriftReader partition_reader(partition_bytes.data(), partition_bytes.size());
+	Assert(DecodeHmsPartition(partition_reader, arena, partition_view), "partition should decode");
+	Assert(partition_reader.Remaining() == 0, "skipped fields should be consumed");
+	auto partition = MaterializeHmsPartition(partition_view);
+	Assert(partition.values.size() == 2 && partition.values[0] == "2024-01-01", "partition values should decode");
+	Assert(!partition.IsNull(0) && partition.IsNull(1) && partition.values[1].empty(),
+	       "default partition values should become NULL");
+	Assert(partition.location == "s3://bucket/events/dt=2024-01-01", "partition location should decode");
+	Assert(partition.parameters["numRows"] == "7", "partition parameters should decode");
+
+	// A list count larger than the remaining input is rejected before anything is allocated
+	std::vector<uint8_t> corrupt {static_cast<uint8_t>(ThriftType::List), 0, 1,
+	                              static_cast<uint8_t>(ThriftType::String), 0x7F, 0xFF, 0xFF, 0xFF};
+	ThriftReader corrupt_reader(corrupt.data(), corrupt.size());
+	Assert(!DecodeHmsPartition(corrupt_reader, arena, partition_view), "corrupt list count should fail");
+}
+
+void TestPartitionSpecDecoding() {
+	// PartitionSpec with a shared storage descriptor, as get_partitions_with_specs groups partitions
+	// stored under the table location
+	ThriftWriter writer;
+	writer.WriteFieldBegin(ThriftType::String, 3);
+	writer.WriteString("s3://bucket/events");
+	writer.WriteFieldBegin(ThriftType::Struct, 4);
+	writer.WriteFieldBegin(ThriftType::List, 1);
+	writer.WriteListBegin(ThriftType::Struct, 2);
+	for (auto *value : {"2024-01-01", "__HIVE_DEFAULT_PARTITION__"}) {
+		writer.WriteFieldBegin(ThriftType::List, 1);
+		writer.WriteListBegin(ThriftType::String, 1);
+		writer.WriteString(value);
+		writer.WriteFieldBegin(ThriftType::String, 4);
+		writer.WriteString(std::string("/dt=") + value);
+		writer.WriteFieldBegin(ThriftType::Map, 5);
+		WriteStringMap(writer, {{"numRows", "10"}});
+		writer.WriteFieldStop();
+	}
+	writer.WriteFieldBegin(ThriftType::Struct, 2);
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("s3://bucket/events");
+	writer.WriteFieldStop();
+	writer.WriteFieldStop();
+	writer.WriteFieldStop();
+	auto shared_bytes = writer.Release();
+
+	HmsDecodeArena arena;
+	HmsPartitionSpecView spec;
+	ThriftReader reader(shared_bytes.data(), shared_bytes.size());
+	Assert(DecodeHmsPartitionSpec(reader, arena, spec) && reader.Remaining() == 0, "shared spec should decode");
+	Assert(spec.shared_partitions.size == 2 && spec.partitions.empty(), "shared spec should hold two partitions");
+	auto first = MaterializeHmsPartition(spec.shared_partitions[0], spec.shared_location);
+	auto second = MaterializeHmsPartition(spec.shared_partitions[1], spec.shared_location);
+	Assert(first.location == "s3://bucket/events/dt=2024-01-01", "location should be shared location plus relative path");
+	Assert(first.parameters.at("numRows") == "10", "parameters should be kept");
+	Assert(second.IsNull(0), "default partition value should map to NULL");
+
+	HmsPartitionSpecView projected;
+	ThriftReader projected_reader(shared_bytes.data(), shared_bytes.size());
+	Assert(DecodeHmsPartitionSpec(projected_reader, arena, projected, MetastorePartitionFields::Base),
+	       "projected spec should decode");
+	Assert(projected.shared_partitions[0].parameters.empty(), "unrequested parameters should be skipped");
+
+	// PartitionListComposingSpec: partitions outside the table location come whole
+	ThriftWriter list_writer;
+	list_writer.WriteFieldBegin(ThriftType::Struct, 5);
+	list_writer.WriteFieldBegin(ThriftType::List, 1);
+	list_writer.WriteListBegin(ThriftType::Struct, 1);
+	list_writer.WriteFieldBegin(ThriftType::List, 1);
+	list_writer.WriteListBegin(ThriftType::String, 1);
+	list_writer.WriteString("2023-12-31");
+	list_writer.WriteFieldBegin(ThriftType::Struct, 6);
+	list_writer.WriteFieldBegin(ThriftType::String, 2);
+	list_writer.WriteString("s3://archive/dt=2023-12-31");
+	list_writer.WriteFieldStop();
+	list_writer.WriteFieldStop();
+	list_writer.WriteFieldStop();
+	list_writer.WriteFieldStop();
+	auto list_bytes = list_writer.Release();
+	HmsPartitionSpecView list_spec;
+	ThriftReader list_reader(list_bytes.data(), list_bytes.size());
+	Assert(DecodeHmsPartitionSpec(list_reader, arena, list_spec) && list_reader.Remaining() == 0,
+	       "partition list spec should decode");
+	Assert(list_spec.partitions.size == 1 &&
+	           MaterializeHmsPartition(list_spec.partitions[0]).location == "s3://archive/dt=2023-12-31",
+	       "partitions with their own location should keep it");
+
+	MetastoreError unknown_method(MetastoreErrorCode::Unsupported, HMS_UNKNOWN_METHOD_MESSAGE);
+	MetastoreError remote(MetastoreErrorCode::Transient, "HMS remote exception");
+	Assert(IsHmsUnknownMethodError(unknown_method) && !IsHmsUnknownMethodError(remote),
+	       "only unknown-method errors should trigger the fallback to older calls");
+}
+
+void TestTableListing() {
+	Assert(MetastoreNameMatchesPattern("sales_daily", ""), "empty pattern should match everything");
+	Assert(MetastoreNameMatchesPattern("sales_daily", "SALES_*"), "patterns should ignore case");
+	Assert(MetastoreNameMatchesPattern("tmp", "sales_*|tmp"), "any alternative should match");
+	Assert(MetastoreNameMatchesPattern("a_b_c", "*b*c") && MetastoreNameMatchesPattern("abc", "a**c"),
+	       "wildcards should backtrack");
+	Assert(!MetastoreNameMatchesPattern("sales", "sales_*") && !MetastoreNameMatchesPattern("tmp2", "sales_*|tmp"),
+	       "patterns should match whole names");
+
+	// A get_table_meta element; the comment is optional
+	ThriftWriter writer;
+	writer.WriteFieldBegin(ThriftType::String, 1);
+	writer.WriteString("sales");
+	writer.WriteFieldBegin(ThriftType::String, 2);
+	writer.WriteString("orders_v");
+	writer.WriteFieldBegin(ThriftType::String, 3);
+	writer.WriteString("VIRTUAL_VIEW");
+	writer.WriteFieldBegin(ThriftType::String, 5);
+	writer.WriteString("hive");
+	writer.WriteFieldStop();
+	auto bytes = writer.Release();
+	HmsDecodeArena arena;
+	HmsTableMetaView view;
+	ThriftReader reader(bytes.data(), bytes.size());
+	Assert(DecodeHmsTableMeta(reader, arena, view) && reader.Remaining() == 0, "table meta should decode");
+	auto summary = MaterializeHmsTableSummary(view);
+	Assert(summary.namespace_name == "sales" && summary.name == "orders_v" && summary.table_type == "VIRTUAL_VIEW",
+	       "table meta should carry namespace, name and type");
+	Assert(!summary.comment.has_value(), "a missing comment should stay unset");
+}
+
+void TestSingleFlight() {
+	MetastoreSingleFlight group;
+	std::atomic<int> calls {0};
+	std::atomic<bool> release {false};
+	std::vector<std::thread> threads;
+	std::vector<int> results(8, 0);
+	for (size_t i = 0; i < results.size(); i++) {
+		threads.emplace_back([&, i]() {
+			results[i] = group.Do<int>("get_table/db/t", [&]() {
+				calls++;
+				while (!release) {
+					std::this_thread::yield();
+				}
+				return 42;
+			});
+		});
+	}
+	// Hold the leader until the other callers had a chance to join its flight
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	release = true;
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	Assert(calls == 1, "concurrent identical calls should run once");
+	for (auto result : results) {
+		Assert(result == 42, "every caller should receive the shared result");
+	}
+	Assert(group.InFlightCount() == 0, "finished flights should not be retained");
+	Assert(group.Do<int>("get_table/db/t", [] { return 7; }) == 7, "later calls should start a new flight");
+
+	// A follower leaves on its own interrupt or deadline; the leader runs on and still delivers its result
+	release = false;
+	int leader_result = 0;
+	std::thread leader([&]() {
+		leader_result = group.Do<int>("get_table/db/t", [&]() {
+			while (!release) {
+				std::this_thread::yield();
+			}
+			return 42;
+		});
+	});
+	while (group.InFlightCount() == 0) {
+		std::this_thread::yield();
+	}
+	std::function<int()> stopped = []() { return -1; };
+	auto interrupted = std::make_shared<MetastoreCallControl>();
+	interrupted->is_cancelled = []() { return true; };
+	{
+		MetastoreCallScope scope(interrupted);
+		Assert(group.Do<int>("get_table/db/t", [] { return 7; }, stopped) == -1,
+		       "an interrupted follower should stop waiting");
+	}
+	auto deadline = std::make_shared<MetastoreCallControl>();
+	deadline->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+	auto started = std::chrono::steady_clock::now();
+	{
+		MetastoreCallScope scope(deadline);
+		Assert(group.Do<int>("get_table/db/t", [] { return 7; }, stopped) == -1,
+		       "a follower past its deadline should stop waiting");
+	}
+	Assert(std::chrono::steady_clock::now() - started < std::chrono::seconds(1),
+	       "a follower should notice its deadline without waiting for the leader");
+	Assert(group.InFlightCount() == 1, "stopped followers should leave the leader's flight running");
+	release = true;
+	leader.join();
+	Assert(leader_result == 42, "the leader should finish after its followers stopped");
+}
+
+void TestMetadataCache() {
+	MetastoreCacheOptions options;
+	options.ttl_ms = 200;
+	options.max_stale_ms = 200;
+	auto cache = std::make_shared<MetastoreTtlCache<int>>(options);
+	int loads = 0;
+	auto loader = [&loads]() { return MetastoreResult<int>::Success(++loads); };
+	std::vector<std::function<void()>> scheduled;
+	MetastoreRefreshScheduler schedule = [&scheduled](std::function<void()> job) { scheduled.push_back(job); };
+
+	Assert(cache->Get("t", loader, schedule).value == 1, "miss should load synchronously");
+	Assert(cache->Get("t", loader, schedule).value == 1, "fresh entry should be served from cache");
+	Assert(loads == 1 && scheduled.empty(), "fresh entry should not be refreshed");
+
+	// Past its TTL a hot entry is still served while a background refresh runs
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	Assert(cache->Get("t", loader, schedule).value == 1, "hot entry should be served stale");
+	Assert(cache->Get("t", loader, schedule).value == 1, "stale entry should not schedule a second refresh");
+	Assert(scheduled.size() == 1 && loads == 1, "stale hot entry should schedule exactly one refresh");
+	scheduled[0]();
+	Assert(cache->Get("t", loader, schedule).value == 2, "refreshed value should replace the stale one");
+
+	// A cold entry is not kept past its TTL
+	cache->Get("cold", loader, schedule);
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	auto before = loads;
+	cache->Get("cold", loader, schedule);
+	Assert(loads == before + 1, "expired cold entry should load synchronously");
+
+	// With stale-if-error, an expired entry is served only when its reload fails transiently
+	options.max_stale_ms = 0;
+	options.stale_if_error_ms = 10000;
+	auto resilient = std::make_shared<MetastoreTtlCache<int>>(options);
+	resilient->Get("t", loader, schedule);
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	auto unreachable = []() {
+		return MetastoreResult<int>::Error(MetastoreErrorCode::Transient, "HMS circuit breaker open", "", false);
+	};
+	auto stale = resilient->Get("t", unreachable, schedule);
+	Assert(stale.IsOk() && stale.value == loads, "expired entry should be served when the metastore is down");
+	auto gone = []() { return MetastoreResult<int>::Error(MetastoreErrorCode::NotFound, "dropped"); };
+	Assert(!resilient->Get("t", gone, schedule).IsOk(), "a definitive error should not be masked by a stale entry");
+
+	auto failing = []() { return MetastoreResult<int>::Error(MetastoreErrorCode::NotFound, "missing"); };
+	Assert(!cache->Get("missing", failing, schedule).IsOk(), "errors should be returned");
+	int value;
+	Assert(!cache->Lookup("missing", failing, schedule, value), "errors should not be cached");
+}
+
+void TestCompactTableCache() {
+	MetastoreCacheOptions options;
+	options.ttl_ms = 60000;
+	MetastoreCatalogCache cache(options);
+	auto make_table = [](const std::string &name) {
+		MetastoreTable table;
+		table.catalog = "hms";
+		table.namespace_name = "sales";
+		table.name = name;
+		table.storage_descriptor.location = "s3://warehouse/sales/" + name;
+		table.storage_descriptor.format = MetastoreFormat::Parquet;
+		table.storage_descriptor.serde_class = "org.apache.hadoop.hive.ql.io.parquet.serde.ParquetHiveSerDe";
+		table.storage_descriptor.input_format = "org.apache.hadoop.hive.ql.io.parquet.MapredParquetInputFormat";
+		table.storage_descriptor.serde_parameters = {{"serialization.format", "1"}};
+		for (int i = 0; i < 20; i++) {
+			table.storage_descriptor.columns.push_back({"column_" + std::to_string(i), "decimal(18,2)"});
+		}
+		table.partition_spec.columns.push_back({"dt", "string"});
+		table.properties = {{"transient_lastDdlTime", name}, {"comment", ""}, {"numFiles", "12"}};
+		return table;
+	};
+	auto original = make_table("orders");
+	MetastoreCompactTable compact(original, cache.strings);
+	auto expanded = compact.Expand();
+	Assert(expanded.catalog == "hms" && expanded.namespace_name == "sales" && expanded.name == "orders",
+	       "compact table should keep its identity");
+	Assert(expanded.storage_descriptor.location == original.storage_descriptor.location &&
+	           expanded.storage_descriptor.format == MetastoreFormat::Parquet,
+	       "compact table should keep its location and format");
+	Assert(expanded.storage_descriptor.serde_class == original.storage_descriptor.serde_class &&
+	           expanded.storage_descriptor.input_format == original.storage_descriptor.input_format &&
+	           !expanded.storage_descriptor.output_format && !expanded.owner,
+	       "compact table should keep present and absent optional strings apart");
+	Assert(expanded.storage_descriptor.columns.size() == 20 &&
+	           expanded.storage_descriptor.columns[7].name == "column_7" &&
+	           expanded.storage_descriptor.columns[7].type == "decimal(18,2)",
+	       "compact table should keep its columns in order");
+	Assert(expanded.partition_spec.columns.size() == 1 && expanded.partition_spec.columns[0].name == "dt",
+	       "compact table should keep its partition keys");
+	Assert(expanded.properties == original.properties &&
+	           expanded.storage_descriptor.serde_parameters == original.storage_descriptor.serde_parameters,
+	       "compact table should keep its properties");
+	Assert(compact.FindProperty("numFiles") == std::string_view("12") && compact.FindProperty("comment") == "" &&
+	           !compact.FindProperty("numRows"),
+	       "properties should be found without expanding the table");
+
+	// Strings shared by tables are pooled once; a table's own strings are not
+	auto pooled = cache.strings->Size();
+	MetastoreCompactTable sibling(make_table("returns"), cache.strings);
+	Assert(cache.strings->Size() == pooled, "a similar table should add no pooled strings");
+	Assert(sibling.MemoryUsage() < 1024, "a compacted 20-column table should take well under a kilobyte");
+
+	// Invalidating a cached table uncharges it and drops only its own references to pooled strings
+	MetastoreRefreshScheduler schedule = [](std::function<void()> job) { job(); };
+	cache.tables->Put("sales.orders", original);
+	MetastoreTable cached;
+	Assert(cache.tables->Lookup("sales.orders", nullptr, schedule, cached) && cached.properties == original.properties,
+	       "cached tables should be served expanded");
+	Assert(cache.tables->MemoryUsage() > compact.MemoryUsage(), "cache should account for its entries");
+	cache.tables->Invalidate("sales.orders");
+	Assert(cache.tables->MemoryUsage() < compact.MemoryUsage(), "invalidated entries should be uncharged");
+	Assert(cache.strings->Size() == pooled, "strings still used by other tables should stay pooled");
+}
+
+void TestCacheBudget() {
+	MetastoreCacheOptions options;
+	options.ttl_ms = 60000;
+	auto budget = std::make_shared<MetastoreCacheBudget>();
+	size_t reported = 0;
+	budget->SetReporter([&reported](size_t used_bytes) { reported = used_bytes; });
+	auto cache = std::make_shared<MetastoreCatalogCache>(options, budget);
+	MetastoreRefreshScheduler schedule = [](std::function<void()> job) { job(); };
+	auto key = [](int idx) { return "sales.t" + std::to_string(idx); };
+	for (int idx = 0; idx < 10; idx++) {
+		MetastoreTable table;
+		table.catalog = "hms";
+		table.namespace_name = "sales";
+		table.name = "t" + std::to_string(idx);
+		table.storage_descriptor.location = "s3://warehouse/sales/t" + std::to_string(idx);
+		for (int i = 0; i < 10; i++) {
+			table.storage_descriptor.columns.push_back({"c" + std::to_string(i), "bigint"});
+		}
+		cache->tables->Put(key(idx), table);
+	}
+	std::vector<MetastorePartitionValue> partitions(100);
+	for (auto &partition : partitions) {
+		partition.values = {"2024-01-01"};
+		partition.null_values = {false};
+		partition.location = "s3://warehouse/sales/t9/dt=2024-01-01/a-path-too-long-for-inline-strings";
+	}
+	cache->partitions->Put(key(9), partitions);
+	Assert(budget->Used() > 0 && reported == budget->Used(), "cached entries should be charged and reported");
+	Assert(cache->partitions->MemoryUsage() > 100 * partitions[0].location.size(),
+	       "partition lists should be charged for their strings");
+
+	// Over the limit, the least recently used entries go first, across tables and partition lists
+	MetastoreTable table;
+	Assert(cache->tables->Lookup(key(0), nullptr, schedule, table), "t0 should be cached");
+	budget->SetLimit(budget->Used() / 2);
+	Assert(budget->Used() <= budget->Limit() && budget->Evictions() > 0, "lowering the limit should evict");
+	Assert(cache->tables->Lookup(key(0), nullptr, schedule, table), "recently read t0 should survive");
+	Assert(!cache->tables->Lookup(key(1), nullptr, schedule, table), "least recently used t1 should be evicted");
+	Assert(cache->tables->Evictions() > 0, "evictions should be counted per cache");
+	Assert(reported == budget->Used(), "evictions should be reported");
+
+	// Nothing stays charged for a dropped cache
+	cache.reset();
+	Assert(budget->Used() == 0 && reported == 0, "a dropped cache should give back all its bytes");
+}
+
+void TestSharedCache() {
+	std::string path = "/tmp/metastore_shared_cache_test_" + std::to_string(getpid());
+	std::remove(path.c_str());
+	// Two mappings of one file stand in for two processes
+	auto first = MetastoreSharedCache::Open(path, 1 << 20);
+	auto second = MetastoreSharedCache::Open(path, 64 << 20);
+	Assert(first.IsOk() && second.IsOk(), "shared cache file should open twice");
+	auto &writer = *first.value;
+	auto &reader = *second.value;
+
+	MetastoreTable table;
+	table.catalog = "hive";
+	table.namespace_name = "sales";
+	table.name = "orders";
+	table.storage_descriptor.location = "s3://warehouse/sales/orders";
+	table.storage_descriptor.format = MetastoreFormat::Parquet;
+	table.storage_descriptor.columns = {{"id", "bigint"}, {"note", "string"}};
+	table.storage_descriptor.serde_class = "org.apache.hadoop.hive.ql.io.parquet.serde.ParquetHiveSerDe";
+	table.partition_spec.columns = {{"dt", "string"}};
+	table.properties = {{"numRows", "42"}};
+	table.owner = "etl";
+	MetastoreTable shared;
+	Assert(!reader.GetTable("sales.orders", 60000, shared), "empty segment should miss");
+	writer.PutTable("sales.orders", table);
+	Assert(reader.GetTable("sales.orders", 60000, shared), "another mapping should see a stored table");
+	Assert(shared.name == "orders" && shared.storage_descriptor.columns.size() == 2 &&
+	           shared.storage_descriptor.columns[1].type == "string" && shared.properties.at("numRows") == "42" &&
+	           shared.owner && *shared.owner == "etl" && !shared.storage_descriptor.input_format,
+	       "shared table should round-trip");
+	Assert(!reader.GetTable("sales.other", 60000, shared), "other keys should miss");
+	std::vector<MetastorePartitionValue> shared_partitions;
+	Assert(!reader.GetPartitions("sales.orders", 60000, shared_partitions), "a table is not a partition list");
+
+	std::vector<MetastorePartitionValue> partitions(2);
+	partitions[0].values = {"2024-01-01"};
+	partitions[0].null_values = {false};
+	partitions[0].location = "s3://warehouse/sales/orders/dt=2024-01-01";
+	partitions[1].values = {""};
+	partitions[1].null_values = {true};
+	partitions[1].parameters = {{"numRows", "7"}};
+	writer.PutPartitions("sales.orders/", partitions);
+	Assert(reader.GetPartitions("sales.orders/", 60000, shared_partitions) && shared_partitions.size() == 2 &&
+	           shared_partitions[1].IsNull(0) && shared_partitions[1].parameters.at("numRows") == "7" &&
+	           shared_partitions[0].location == partitions[0].location,
+	       "shared partitions should round-trip");
+
+	// Readers pass the age they accept
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	Assert(!reader.GetTable("sales.orders", 5, shared), "an entry older than the accepted age should miss");
+
+	// The file keeps the size it was created with; once the ring laps a record, it is gone
+	std::string big(100 << 10, 'x');
+	table.properties["blob"] = big;
+	writer.PutTable("sales.lapped", table);
+	Assert(reader.GetTable("sales.lapped", 60000, shared), "a large record should be shared");
+	for (int i = 0; i < 12; i++) {
+		writer.PutTable("sales.filler" + std::to_string(i), table);
+	}
+	Assert(!reader.GetTable("sales.lapped", 60000, shared), "a lapped record should miss");
+	Assert(reader.GetTable("sales.filler11", 60000, shared), "the newest record should survive");
+	table.properties["blob"] = std::string(200 << 10, 'x');
+	auto stores = writer.Stores();
+	writer.PutTable("sales.huge", table);
+	Assert(writer.Stores() == stores, "records over an eighth of the ring should not be shared");
+	Assert(reader.Hits() == 4 && writer.Stores() == 15, "hits and stores should be counted per mapping");
+
+	// Through the connector: successes are shared per endpoint, errors are not
+	HmsConfig config;
+	config.endpoint = "127.0.0.1";
+	config.port = 1;
+	auto hms = std::make_shared<HmsConnector>(config);
+	SharedCacheMetastoreConnector connector(hms, first.value, "thrift://a:9083", 60000);
+	SharedCacheMetastoreConnector other_endpoint(hms, second.value, "thrift://b:9083", 60000);
+	stores = writer.Stores();
+	Assert(!connector.GetTable("db", "t").IsOk() && writer.Stores() == stores, "errors should not be shared");
+	table.properties.clear();
+	table.name = "t";
+	SharedCacheMetastoreConnector same_endpoint(hms, second.value, "thrift://a:9083", 60000);
+	std::string key;
+	MetastoreSingleFlight::AppendKeyPart(key, "thrift://a:9083");
+	key += "table/";
+	MetastoreSingleFlight::AppendKeyPart(key, "db");
+	MetastoreSingleFlight::AppendKeyPart(key, "t");
+	writer.PutTable(key, table);
+	auto served = same_endpoint.GetTableProjected("db", "t", MetastoreTableFields::Base);
+	Assert(served.IsOk() && served.value.name == "t", "a shared full table should serve projections");
+	auto bulk = same_endpoint.GetTables("db", {"t", "u"});
+	Assert(bulk[0].IsOk() && !bulk[1].IsOk(), "bulk lookups should mix shared hits and fetches");
+	Assert(!other_endpoint.GetTable("db", "t").IsOk(), "another endpoint should not see the entry");
+
+	// A file that is not a cache segment is refused rather than overwritten
+	first.value.reset();
+	second.value.reset();
+	std::remove(path.c_str());
+	auto file = fopen(path.c_str(), "w");
+	fputs("not a cache", file);
+	fclose(file);
+	auto refused = MetastoreSharedCache::Open(path, 1 << 20);
+	Assert(!refused.IsOk() && refused.error.code == MetastoreErrorCode::InvalidConfig,
+	       "a foreign file should be refused");
+	std::remove(path.c_str());
+}
+
+//! Connector with a fixed partitioned table that counts the partition calls reaching it
+class PartitionCountingConnector : public IMetastoreConnector {
+public:
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespaces() override {
+		return MetastoreResult<std::vector<MetastoreNamespace>>::Success({});
+	}
+	MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) override {
+		return MetastoreResult<std::vector<std::string>>::Success({});
+	}
+	MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
+	                                         const std::string &table_name) override {
+		return MetastoreResult<MetastoreTable>::Error(MetastoreErrorCode::NotFound, "no tables");
+	}
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	ListPartitions(const std::string &namespace_name, const std::string &table_name,
+	               const std::string &predicate) override {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success({});
+	}
+	MetastoreResult<std::vector<std::string>> ListPartitionNames(const std::string &namespace_name,
+	                                                             const std::string &table_name) override {
+		name_calls++;
+		return MetastoreResult<std::vector<std::string>>::Success(names);
+	}
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNames(const std::string &namespace_name, const std::string &table_name,
+	                     const std::vector<std::string> &partition_names) override {
+		return GetPartitionsByNamesProjected(namespace_name, table_name, partition_names,
+		                                     MetastorePartitionFields::All);
+	}
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	GetPartitionsByNamesProjected(const std::string &namespace_name, const std::string &table_name,
+	                              const std::vector<std::string> &partition_names,
+	                              MetastorePartitionFields fields) override {
+		descriptor_calls++;
+		std::vector<MetastorePartitionValue> partitions;
+		for (auto &name : partition_names) {
+			// Like HMS, names of dropped partitions are left out of the reply
+			if (std::find(dropped.begin(), dropped.end(), name) != dropped.end()) {
+				continue;
+			}
+			MetastorePartitionValue partition;
+			partition.values = {name.substr(3)};
+			partition.null_values = {false};
+			partition.location = "s3://custom/" + name.substr(3);
+			partitions.push_back(std::move(partition));
+		}
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success(std::move(partitions));
+	}
+
+	std::vector<std::string> names = {"dt=2024", "dt=2025"};
+	std::vector<std::string> dropped;
+	int name_calls = 0;
+	int descriptor_calls = 0;
+};
+
+void TestPartitionCaching() {
+	// Scan planning lists a table's partition names and fetches their descriptors; both are cached
+	MetastoreCacheOptions options;
+	options.ttl_ms = 60000;
+	auto counting = std::make_shared<PartitionCountingConnector>();
+	auto cache = std::make_shared<MetastoreCatalogCache>(options);
+	MetastoreRefreshScheduler schedule = [](std::function<void()> job) { job(); };
+	CachingMetastoreConnector caching(counting, cache, schedule);
+	for (int i = 0; i < 2; i++) {
+		auto names = caching.ListPartitionNames("db", "t");
+		Assert(names.IsOk() && names.value.size() == 2, "partition names should be listed");
+		auto partitions =
+		    caching.GetPartitionsByNamesProjected("db", "t", names.value, MetastorePartitionFields::Base);
+		Assert(partitions.IsOk() && partitions.value.size() == 2 && partitions.value[1].location == "s3://custom/2025",
+		       "partition descriptors should be fetched");
+	}
+	Assert(counting->name_calls == 1 && counting->descriptor_calls == 1,
+	       "repeated partition lookups should be served from the cache");
+	Assert(cache->partition_names->Size() == 1 && cache->partitions->Size() == 1,
+	       "name lists and descriptors should be cached per table");
+	// Another name list is another entry, and so is another projection
+	Assert(caching.GetPartitionsByNamesProjected("db", "t", {"dt=2024"}, MetastorePartitionFields::Base).IsOk() &&
+	           caching.GetPartitionsByNames("db", "t", {"dt=2024"}).IsOk() && counting->descriptor_calls == 3,
+	       "descriptors should be cached per name list and projection");
+
+	// The shared cache hands both to other processes
+	std::string path = "/tmp/metastore_shared_partitions_" + std::to_string(getpid());
+	std::remove(path.c_str());
+	auto first = MetastoreSharedCache::Open(path, 1 << 20);
+	auto second = MetastoreSharedCache::Open(path, 1 << 20);
+	Assert(first.IsOk() && second.IsOk(), "shared cache file should open twice");
+	auto fetching = std::make_shared<PartitionCountingConnector>();
+	auto sharing = std::make_shared<PartitionCountingConnector>();
+	SharedCacheMetastoreConnector fetcher(fetching, first.value, "thrift://a:9083", 60000);
+	SharedCacheMetastoreConnector sharer(sharing, second.value, "thrift://a:9083", 60000);
+	auto names = fetcher.ListPartitionNames("db", "t");
+	Assert(fetcher.GetPartitionsByNamesProjected("db", "t", names.value, MetastorePartitionFields::Base).IsOk(),
+	       "partition descriptors should be fetched");
+	names = sharer.ListPartitionNames("db", "t");
+	auto partitions = sharer.GetPartitionsByNamesProjected("db", "t", names.value, MetastorePartitionFields::Base);
+	Assert(names.IsOk() && names.value.size() == 2 && partitions.IsOk() &&
+	           partitions.value[0].location == "s3://custom/2024",
+	       "shared partitions should round-trip");
+	Assert(sharing->name_calls == 0 && sharing->descriptor_calls == 0,
+	       "another process should be served from the shared cache");
+	first.value.reset();
+	second.value.reset();
+	std::remove(path.c_str());
+}
+
+void TestSharedCacheAbandonedSlots() {
+	std::string path = "/tmp/metastore_shared_cache_slots_" + std::to_string(getpid());
+	std::remove(path.c_str());
+	// Lock every slot the way a writer that died mid-update would. The file has a 64-byte header with the
+	// slot count at offset 12, then 48-byte slots that start with their sequence.
+	auto lock_all_slots = [&]() {
+		int fd = open(path.c_str(), O_RDWR);
+		uint32_t slot_count = 0;
+		Assert(pread(fd, &slot_count, sizeof(slot_count), 12) == sizeof(slot_count), "header should read");
+		uint64_t locked = 1;
+		for (uint32_t i = 0; i < slot_count; i++) {
+			Assert(pwrite(fd, &locked, sizeof(locked), 64 + i * 48) == sizeof(locked), "slot should write");
+		}
+		close(fd);
+	};
+	MetastoreTable table;
+	table.name = "orders";
+	MetastoreTable shared;
+
+	// While other processes map the file, a slot is taken over once it has been locked for too long
+	auto first = MetastoreSharedCache::Open(path, 1 << 20);
+	auto second = MetastoreSharedCache::Open(path, 1 << 20);
+	Assert(first.IsOk() && second.IsOk(), "shared cache file should open twice");
+	lock_all_slots();
+	first.value->PutTable("sales.orders", table);
+	Assert(first.value->Stores() == 0 && !second.value->GetTable("sales.orders", 60000, shared),
+	       "a freshly locked slot should be left to its writer");
+	std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+	first.value->PutTable("sales.orders", table);
+	Assert(first.value->Stores() == 1 && second.value->GetTable("sales.orders", 60000, shared),
+	       "a slot locked for too long should be taken over");
+
+	// A process that opens the file while nothing else maps it unlocks every slot
+	lock_all_slots();
+	first.value.reset();
+	Assert(!second.value->GetTable("sales.orders", 60000, shared), "a locked slot should miss");
+	second.value.reset();
+	auto reopened = MetastoreSharedCache::Open(path, 1 << 20);
+	Assert(reopened.IsOk(), "shared cache file should reopen");
+	Assert(reopened.value->GetTable("sales.orders", 60000, shared), "reopening alone should unlock the slots");
+	reopened.value->PutTable("sales.other", table);
+	Assert(reopened.value->Stores() == 1, "an unlocked slot should take stores right away");
+	reopened.value.reset();
+	std::remove(path.c_str());
+}
+
+void TestPartitionBatches() {
+	// Every partition of the middle batch was dropped after the listing; paging skips it rather than stopping
+	PartitionCountingConnector connector;
+	std::vector<std::string> names {"dt=2020", "dt=2021", "dt=2022", "dt=2023", "dt=2024", "dt=2025"};
+	connector.dropped = {"dt=2022", "dt=2023"};
+	std::atomic<uint64_t> next_batch {0};
+	uint64_t batch_index = 0;
+	std::vector<std::string> locations;
+	std::vector<uint64_t> batch_indexes;
+	while (true) {
+		auto batch = FetchPartitionBatch(connector, "db", "t", names, 2, next_batch, batch_index);
+		Assert(batch.IsOk(), "partition batches should be fetched");
+		if (batch.value.empty()) {
+			break;
+		}
+		batch_indexes.push_back(batch_index);
+		for (auto &partition : batch.value) {
+			locations.push_back(partition.location);
+		}
+	}
+	Assert(locations == std::vector<std::string>({"s3://custom/2020", "s3://custom/2021", "s3://custom/2024",
+	                                              "s3://custom/2025"}),
+	       "partitions after an empty batch should still be returned");
+	Assert(batch_indexes == std::vector<uint64_t>({0, 2}), "batches should report their own index");
+	Assert(connector.descriptor_calls == 3, "each batch should be fetched once");
+}
+
+//! Connector that records the projection each bulk table lookup asks for
+class ProjectionRecordingConnector : public IMetastoreConnector {
+public:
+	MetastoreResult<std::vector<MetastoreNamespace>> ListNamespaces() override {
+		return MetastoreResult<std::vector<MetastoreNamespace>>::Success({});
+	}
+	MetastoreResult<std::vector<std::string>> ListTables(const std::string &namespace_name) override {
+		return MetastoreResult<std::vector<std::string>>::Success({});
+	}
+	MetastoreResult<MetastoreTable> GetTable(const std::string &namespace_name,
+	                                         const std::string &table_name) override {
+		return GetTableProjected(namespace_name, table_name, MetastoreTableFields::All);
+	}
+	MetastoreResult<MetastoreTable> GetTableProjected(const std::string &namespace_name,
+	                                                  const std::string &table_name,
+	                                                  MetastoreTableFields fields) override {
+		single_calls++;
+		return MakeTable(namespace_name, table_name, fields);
+	}
+	std::vector<MetastoreResult<MetastoreTable>> GetTablesProjected(const std::string &namespace_name,
+	                                                                const std::vector<std::string> &table_names,
+	                                                                MetastoreTableFields fields) override {
+		bulk_fields.push_back(fields);
+		std::vector<MetastoreResult<MetastoreTable>> results;
+		for (auto &table_name : table_names) {
+			results.push_back(MakeTable(namespace_name, table_name, fields));
+		}
+		return results;
+	}
+	MetastoreResult<std::vector<MetastorePartitionValue>>
+	ListPartitions(const std::string &namespace_name, const std::string &table_name,
+	               const std::string &predicate) override {
+		return MetastoreResult<std::vector<MetastorePartitionValue>>::Success({});
+	}
+
+	std::vector<MetastoreTableFields> bulk_fields;
+	int single_calls = 0;
+
+private:
+	static MetastoreResult<MetastoreTable> MakeTable(const std::string &namespace_name, const std::string &table_name,
+	                                                 MetastoreTableFields fields) {
+		MetastoreTable table;
+		table.namespace_name = namespace_name;
+		table.name = table_name;
+		table.fields = fields;
+		return MetastoreResult<MetastoreTable>::Success(std::move(table));
+	}
+};
+
+void TestProjectedBulkLookup() {
+	// The query-wide lookup asks for the fields the scan binds from, and the scan's own lookup then hits
+	// the entries it cached
+	auto scan_fields =
+	    MetastoreTableFields::Columns | MetastoreTableFields::PartitionKeys | MetastoreTableFields::SerdeParameters;
+	MetastoreCacheOptions options;
+	options.ttl_ms = 60000;
+	auto recording = std::make_shared<ProjectionRecordingConnector>();
+	auto cache = std::make_shared<MetastoreCatalogCache>(options);
+	MetastoreRefreshScheduler schedule = [](std::function<void()> job) { job(); };
+	CachingMetastoreConnector caching(recording, cache, schedule);
+
+	auto tables = caching.GetTablesProjected("db", {"t", "u"}, scan_fields);
+	Assert(tables.size() == 2 && tables[0].IsOk() && tables[1].value.name == "u", "bulk lookup should succeed");
+	Assert(recording->bulk_fields.size() == 1 && recording->bulk_fields[0] == scan_fields,
+	       "the projection should reach the metastore");
+	Assert(tables[0].value.fields == scan_fields, "only the projected fields should be decoded");
+	auto scanned = caching.GetTableProjected("db", "t", scan_fields);
+	Assert(scanned.IsOk() && recording->single_calls == 0, "the scan should be served by the bulk lookup");
+	caching.GetTablesProjected("db", {"t", "u"}, scan_fields);
+	Assert(recording->bulk_fields.size() == 1, "projected bulk lookups should be cached");
+
+	// A cached full table serves every projection
+	caching.GetTables("db", {"v"});
+	caching.GetTablesProjected("db", {"v"}, scan_fields);
+	Assert(recording->bulk_fields.size() == 2 && recording->bulk_fields[1] == MetastoreTableFields::All,
+	       "a full table should serve a projected bulk lookup");
+}
+
+void TestBulkGetTable() {
+	HmsConfig config;
+	config.endpoint = "127.0.0.1";
+	config.port = 1;
+	HmsConnector connector(config);
+
+	config.retry.max_attempts = 2;
+	config.retry.initial_delay_ms = 10;
+	HmsConnector retrying_connector(config);
+	auto retries_before = HmsRpcStats::Global().retries.load();
+	Assert(!retrying_connector.GetTable("db", "a").IsOk(), "unreachable endpoint should fail");
+	Assert(HmsRpcStats::Global().retries.load() == retries_before + 1, "connect failure should be retried once");
+
+	// Nothing listens on port 1, so every call fails fast; results must still line up with the inputs
+	auto results = connector.GetTables("db", {"a", "b", "c"});
+	Assert(results.size() == 3, "bulk GetTable should return one result per table");
+	for (auto &result : results) {
+		Assert(!result.IsOk(), "unreachable endpoint should fail");
+		Assert(result.error.code == MetastoreErrorCode::Transient, "connect failures should be transient");
+	}
+}
+
+void TestCircuitBreaker() {
+	HmsConfig config;
+	config.endpoint = "127.0.0.1";
+	config.port = 1;
+	config.retry.max_attempts = 1;
+	config.breaker_failure_threshold = 2;
+	config.breaker_open_ms = 100;
+	HmsConnector connector(config);
+
+	auto opens_before = HmsRpcStats::Global().breaker_opens.load();
+	auto rejections_before = HmsRpcStats::Global().breaker_rejections.load();
+	Assert(connector.GetTable("db", "a").error.message == "HMS socket connect failed", "first failure is sent");
+	Assert(connector.GetTable("db", "a").error.message == "HMS socket connect failed", "second failure is sent");
+	Assert(HmsRpcStats::Global().breaker_opens.load() == opens_before + 1, "breaker should open at the threshold");
+
+	auto rejected = connector.GetTable("db", "a");
+	Assert(rejected.error.message == "HMS circuit breaker open", "open breaker should fail fast");
+	Assert(!rejected.error.retryable, "open breaker rejections should not be retried");
+	Assert(HmsRpcStats::Global().breaker_rejections.load() == rejections_before + 1, "rejection should be counted");
+
+	// After the open period one probe is sent; its failure opens the breaker again
+	std::this_thread::sleep_for(std::chrono::milliseconds(150));
+	Assert(connector.GetTable("db", "a").error.message == "HMS socket connect failed", "probe should be sent");
+	Assert(connector.GetTable("db", "a").error.message == "HMS circuit breaker open", "failed probe should reopen");
+	Assert(HmsRpcStats::Global().breaker_opens.load() == opens_before + 2, "reopening should be counted");
+}
+
+// A metastore that answers every call with an empty reply, which get_table reads as "table not found". Replies
+// are held until `batch` calls are waiting, so a bulk lookup keeps that many connections open at once.
+class FakeMetastore {
+public:
+	explicit FakeMetastore(size_t batch_p) : batch(batch_p) {
+		listener = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in address {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		Assert(bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0, "bind should succeed");
+		Assert(listen(listener, 64) == 0, "listen should succeed");
+		socklen_t length = sizeof(address);
+		getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length);
+		port = ntohs(address.sin_port);
+		server = std::thread([this]() { Serve(); });
+	}
+
+	~FakeMetastore() {
+		stop = true;
+		server.join();
+		close(listener);
+	}
+
+	//! Close every accepted connection, as a restarted server would
+	void DropConnections() {
+		drop = true;
+		while (drop) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	uint16_t port = 0;
+	std::atomic<size_t> batch;
+
+private:
+	struct Client {
+		int fd;
+		std::vector<uint8_t> buffer;
+		ThriftMessageScanner scanner;
+		bool waiting = false;
+		int32_t seqid = 0;
+	};
+
+	static int32_t ReadI32At(const std::vector<uint8_t> &buffer, size_t offset) {
+		return static_cast<int32_t>(static_cast<uint32_t>(buffer[offset]) << 24 |
+		                            static_cast<uint32_t>(buffer[offset + 1]) << 16 |
+		                            static_cast<uint32_t>(buffer[offset + 2]) << 8 | buffer[offset + 3]);
+	}
+
+	void Serve() {
+		std::vector<Client> clients;
+		while (!stop) {
+			if (drop) {
+				for (auto &client : clients) {
+					close(client.fd);
+				}
+				clients.clear();
+				drop = false;
+			}
+			std::vector<pollfd> fds {{listener, POLLIN, 0}};
+			for (auto &client : clients) {
+				fds.push_back({client.fd, POLLIN, 0});
+			}
+			if (poll(fds.data(), fds.size(), 10) <= 0) {
+				continue;
+			}
+			if (fds[0].revents & POLLIN) {
+				int fd = accept(listener, nullptr, nullptr);
+				if (fd >= 0) {
+					clients.push_back(Client {fd});
+				}
+			}
+			for (size_t i = 1; i < fds.size(); i++) {
+				auto &client = clients[i - 1];
+				if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+					continue;
+				}
+				uint8_t chunk[4096];
+				auto n = read(client.fd, chunk, sizeof(chunk));
+				if (n <= 0) {
+					close(client.fd);
+					client.fd = -1;
+					continue;
+				}
+				client.buffer.insert(client.buffer.end(), chunk, chunk + n);
+				if (client.scanner.Feed(client.buffer.data(), client.buffer.size()) ==
+				    ThriftMessageScanner::Status::Complete) {
+					// Strict header: version and type, name, then the sequence id
+					client.seqid = ReadI32At(client.buffer, 8 + static_cast<size_t>(ReadI32At(client.buffer, 4)));
+					client.waiting = true;
+					client.buffer.clear();
+					client.scanner.Reset();
+				}
+			}
+			clients.erase(std::remove_if(clients.begin(), clients.end(),
+			                             [](const Client &client) { return client.fd < 0; }),
+			              clients.end());
+			auto waiting = std::count_if(clients.begin(), clients.end(),
+			                             [](const Client &client) { return client.waiting; });
+			if (waiting == 0 || static_cast<size_t>(waiting) < batch) {
+				continue;
+			}
+			for (auto &client : clients) {
+				if (client.waiting) {
+					ThriftWriter writer;
+					writer.WriteMessageBegin("get_table", ThriftMessageType::Reply, client.seqid);
+					writer.WriteFieldStop();
+					auto &reply = writer.Data();
+					Assert(send(client.fd, reply.data(), reply.size(), MSG_NOSIGNAL) ==
+					           static_cast<ssize_t>(reply.size()),
+					       "fake metastore reply should be sent");
+					client.waiting = false;
+				}
+			}
+		}
+		for (auto &client : clients) {
+			close(client.fd);
+		}
+	}
+
+	int listener;
+	std::thread server;
+	std::atomic<bool> stop {false};
+	std::atomic<bool> drop {false};
+};
+
+void TestStalePooledConnections() {
+	std::vector<std::string> names {"a", "b", "c", "d", "e", "f", "g", "h"};
+	FakeMetastore metastore(names.size());
+	HmsConfig config;
+	config.endpoint = "127.0.0.1";
+	config.port = metastore.port;
+	config.retry.max_attempts = 1;
+	HmsConnector connector(config);
+
+	for (auto &result : connector.GetTables("db", names)) {
+		Assert(result.error.code == MetastoreErrorCode::NotFound, "fake metastore should answer every lookup");
+	}
+	Assert(HmsConnectionPool::ForEndpoint(config.endpoint, config.port)->IdleCount() == names.size(),
+	       "every concurrent lookup should leave its connection in the pool");
+
+	// A server restart leaves more stale pooled connections than the breaker threshold; the calls sent over
+	// them are replayed on fresh connections and must neither fail nor open the breaker
+	metastore.DropConnections();
+	metastore.batch = 1;
+	auto opens_before = HmsRpcStats::Global().breaker_opens.load();
+	for (auto &result : connector.GetTables("db", names)) {
+		Assert(result.error.code == MetastoreErrorCode::NotFound, "stale pooled connections should be replayed");
+	}
+	Assert(HmsRpcStats::Global().breaker_opens.load() == opens_before,
+	       "stale pooled connections should not open the circuit breaker");
+}
+
+void TestCallCancellation() {
+	// A listener that never accepts: connects succeed (backlog) but no reply ever arrives
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	Assert(bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0, "bind should succeed");
+	Assert(listen(listener, 16) == 0, "listen should succeed");
+	socklen_t length = sizeof(address);
+	getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length);
+
+	HmsConfig config;
+	config.endpoint = "127.0.0.1";
+	config.port = ntohs(address.sin_port);
+	HmsConnector connector(config);
+
+	std::atomic<bool> interrupted {false};
+	auto control = std::make_shared<MetastoreCallControl>();
+	control->is_cancelled = [&interrupted]() { return interrupted.load(); };
+	std::thread interrupter([&interrupted]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		interrupted = true;
+	});
+	auto started = std::chrono::steady_clock::now();
+	MetastoreResult<MetastoreTable> result;
+	{
+		MetastoreCallScope scope(control);
+		result = connector.GetTable("db", "a");
+	}
+	auto elapsed = std::chrono::steady_clock::now() - started;
+	interrupter.join();
+	Assert(result.error.code == MetastoreErrorCode::Cancelled, "interrupted call should report Cancelled");
+	Assert(elapsed < std::chrono::seconds(2), "interrupt should not wait for the read timeout");
+	Assert(HmsConnectionPool::ForEndpoint(config.endpoint, config.port)->IdleCount() == 0,
+	       "an interrupted connection must not be pooled");
+
+	auto deadline = std::make_shared<MetastoreCallControl>();
+	deadline->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+	started = std::chrono::steady_clock::now();
+	{
+		MetastoreCallScope scope(deadline);
+		result = connector.GetTable("db", "a");
+	}
+	elapsed = std::chrono::steady_clock::now() - started;
+	Assert(result.error.message == "Metastore call deadline exceeded", "call should stop at the query deadline");
+	Assert(!result.error.retryable, "deadline failures should not be retried");
+	Assert(elapsed < std::chrono::seconds(2), "deadline should not wait for the read timeout");
+	Assert(!MetastoreCallScope::Current(), "scopes should restore the previous control");
+	close(listener);
+}
+
+void TestRpcTimeout() {
+	// metastore_rpc_timeout becomes the deadline of the query's calls. Against a server that accepts
+	// connections (backlog) but never replies, it ends a call well before the read timeout would.
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	Assert(bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0, "bind should succeed");
+	Assert(listen(listener, 16) == 0, "listen should succeed");
+	socklen_t length = sizeof(address);
+	getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length);
+
+	HmsConfig config;
+	config.endpoint = "127.0.0.1";
+	config.port = ntohs(address.sin_port);
+	config.read_timeout_ms = 1000;
+	config.retry.max_attempts = 1;
+	HmsConnector connector(config);
+
+	auto started = std::chrono::steady_clock::now();
+	auto unlimited = connector.GetTable("db", "a");
+	auto unlimited_elapsed = std::chrono::steady_clock::now() - started;
+	Assert(unlimited.error.message == "HMS request timed out", "without a deadline the read timeout ends the call");
+
+	auto control = std::make_shared<MetastoreCallControl>();
+	control->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+	started = std::chrono::steady_clock::now();
+	MetastoreResult<MetastoreTable> limited;
+	{
+		MetastoreCallScope scope(control);
+		limited = connector.GetTable("db", "a");
+	}
+	auto limited_elapsed = std::chrono::steady_clock::now() - started;
+	Assert(limited.error.message == "Metastore call deadline exceeded" &&
+	           limited.error.detail == "metastore_rpc_timeout elapsed",
+	       "a short timeout should fail with the deadline error");
+	Assert(limited_elapsed * 2 < unlimited_elapsed, "a short timeout should fail faster than the default");
+	close(listener);
+}
+
+void TestResolver() {
+	HmsResolver resolver;
+	auto lookups_before = HmsRpcStats::Global().dns_lookups.load();
+	auto hits_before = HmsRpcStats::Global().dns_cache_hits.load();
+	auto first = resolver.Resolve("localhost", 9083);
+	Assert(first.IsOk() && !first.value->empty(), "localhost should resolve");
+	auto second = resolver.Resolve("localhost", 9083);
+	Assert(second.IsOk() && second.value == first.value, "second lookup should reuse the cached addresses");
+	Assert(HmsRpcStats::Global().dns_lookups.load() == lookups_before + 1, "cache hit should not call getaddrinfo");
+	Assert(HmsRpcStats::Global().dns_cache_hits.load() == hits_before + 1, "cache hit should be counted");
+
+	auto failed = resolver.Resolve("no-such-host.invalid", 9083);
+	Assert(!failed.IsOk() && failed.error.code == MetastoreErrorCode::Transient, "unknown host should fail");
+	Assert(!resolver.Resolve("no-such-host.invalid", 9083).IsOk(), "failure should be cached");
+	Assert(HmsRpcStats::Global().dns_lookups.load() == lookups_before + 2, "cached failure should not look up again");
+
+	// Event loops only take cached answers; lookups and refreshes run on the resolver's background thread,
+	// which is joined when the resolver goes out of scope
+	HmsResolver background_resolver(std::chrono::milliseconds(50), std::chrono::milliseconds(50));
+	MetastoreResult<HmsAddressList> cached;
+	Assert(!background_resolver.TryResolveCached("localhost", 9083, cached), "a cold host should need a lookup");
+	std::atomic<bool> looked_up {false};
+	background_resolver.ResolveInBackground("localhost", 9083, [&looked_up]() { looked_up = true; });
+	for (int i = 0; i < 200 && !looked_up; i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	Assert(looked_up && background_resolver.TryResolveCached("localhost", 9083, cached) && cached.IsOk(),
+	       "a background lookup should fill the cache");
+	auto stale = cached.value;
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	Assert(background_resolver.TryResolveCached("localhost", 9083, cached) && cached.value == stale,
+	       "expired addresses should be served while they are refreshed");
+	for (int i = 0; i < 200 && cached.value == stale; i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		background_resolver.TryResolveCached("localhost", 9083, cached);
+	}
+	Assert(cached.value != stale, "the background refresh should replace expired addresses");
+
+	auto address = [](int family) {
+		HmsSocketAddress result {};
+		result.family = family;
+		return result;
+	};
+	auto interleaved = HmsResolver::InterleaveFamilies(
+	    {address(AF_INET6), address(AF_INET6), address(AF_INET6), address(AF_INET)});
+	Assert(interleaved.size() == 4, "interleaving should keep every address");
+	Assert(interleaved[0].family == AF_INET6 && interleaved[1].family == AF_INET &&
+	           interleaved[2].family == AF_INET6 && interleaved[3].family == AF_INET6,
+	       "families should alternate, starting with the preferred one");
 }
 
 void TestConnectorStubContract() {
@@ -119,6 +1510,29 @@ int main() {
 	TestEndpointParsing();
 	TestMapperBehavior();
 	TestRetryPolicy();
+	TestPartitionNameParsing();
+	TestConnectionPool();
+	TestEndpointSet();
+	TestThriftMessageScanner();
+	TestListReplyStream();
+	TestReplyDecoding();
+	TestPartitionSpecDecoding();
+	TestTableListing();
+	TestSingleFlight();
+	TestMetadataCache();
+	TestCompactTableCache();
+	TestCacheBudget();
+	TestSharedCache();
+	TestSharedCacheAbandonedSlots();
+	TestPartitionCaching();
+	TestPartitionBatches();
+	TestBulkGetTable();
+	TestProjectedBulkLookup();
+	TestCircuitBreaker();
+	TestStalePooledConnections();
+	TestCallCancellation();
+	TestRpcTimeout();
+	TestResolver();
 	TestConnectorStubContract();
 	std::cout << "[PASS] HMS integration harness checks completed" << std::endl;
 	return 0;